@@ -0,0 +1,144 @@
+#ifndef EGL_DESKTOPEXT_H_
+#define EGL_DESKTOPEXT_H_
+
+/*
+** Extensions of the EGL desktop implementation, which are not part of the Khronos registry.
+** The entry points are returned by eglGetProcAddress. Prototypes are declared, if EGL_EGLEXT_PROTOTYPES is defined.
+**
+** Enumerants are taken from 0x7F00 upwards, which is not used by the registry.
+*/
+
+#include <EGL/egl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef EGL_DESKTOP_readback_async
+#define EGL_DESKTOP_readback_async 1
+typedef void *EGLReadbackDESKTOP;
+#define EGL_NO_READBACK_DESKTOP           ((EGLReadbackDESKTOP)0)
+/* Called with the mapped pixels, after the fence of the readback did signal. The readback is released afterwards. */
+typedef void (EGLAPIENTRYP EGLReadbackCallbackDESKTOP) (EGLReadbackDESKTOP readback, const void *pixels, EGLint width, EGLint height, void *user_data);
+#define EGL_READBACK_RING_SIZE_DESKTOP    0x7F00
+typedef EGLReadbackDESKTOP (EGLAPIENTRYP PFNEGLREADPIXELSASYNCDESKTOPPROC) (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLReadbackCallbackDESKTOP callback, void *user_data);
+typedef EGLint (EGLAPIENTRYP PFNEGLCLIENTWAITREADBACKDESKTOPPROC) (EGLDisplay dpy, EGLReadbackDESKTOP readback, EGLTime timeout);
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLMAPREADBACKDESKTOPPROC) (EGLDisplay dpy, EGLReadbackDESKTOP readback, const void **pixels, EGLint *width, EGLint *height);
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLRELEASEREADBACKDESKTOPPROC) (EGLDisplay dpy, EGLReadbackDESKTOP readback);
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLReadbackDESKTOP EGLAPIENTRY eglReadPixelsAsyncDESKTOP (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLReadbackCallbackDESKTOP callback, void *user_data);
+EGLAPI EGLint EGLAPIENTRY eglClientWaitReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback, EGLTime timeout);
+EGLAPI EGLBoolean EGLAPIENTRY eglMapReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback, const void **pixels, EGLint *width, EGLint *height);
+EGLAPI EGLBoolean EGLAPIENTRY eglReleaseReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback);
+#endif
+#endif /* EGL_DESKTOP_readback_async */
+
+#ifndef EGL_DESKTOP_readback_yuv
+#define EGL_DESKTOP_readback_yuv 1
+/* Pbuffer surface attribute. The readback converts the pixels on the GPU, planes are top down in BT.601 limited range. */
+#define EGL_READBACK_FORMAT_DESKTOP       0x7F01
+#define EGL_READBACK_FORMAT_RGBA_DESKTOP  0x7F02
+#define EGL_READBACK_FORMAT_NV12_DESKTOP  0x7F03
+#define EGL_READBACK_FORMAT_I420_DESKTOP  0x7F04
+#endif /* EGL_DESKTOP_readback_yuv */
+
+#ifndef EGL_DESKTOP_client_memory
+#define EGL_DESKTOP_client_memory 1
+/* Client buffer type of eglCreatePbufferFromClientBuffer. The buffer points to RGBA8 memory, which must stay valid until the
+** surface is destroyed. eglSwapBuffers writes the color buffer into it, rows bottom up as with glReadPixels.
+** EGL_WIDTH and EGL_HEIGHT are required. The pointer and the stride must be multiples of 4. */
+#define EGL_CLIENT_MEMORY_DESKTOP         0x7F05
+#define EGL_CLIENT_MEMORY_STRIDE_DESKTOP  0x7F06
+#endif /* EGL_DESKTOP_client_memory */
+
+#ifndef EGL_DESKTOP_shm_pixmap
+#define EGL_DESKTOP_shm_pixmap 1
+/* Creates a native pixmap on memory shared with the X server, which is compatible with the config. The pixels are 32 bit,
+** rows top down with the returned stride. After eglCopyBuffers into the pixmap returned, they can be read without a transfer. */
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLCREATESHMPIXMAPDESKTOPPROC) (EGLDisplay dpy, EGLConfig config, EGLint width, EGLint height, EGLNativePixmapType *pixmap, void **pixels, EGLint *stride);
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLDESTROYSHMPIXMAPDESKTOPPROC) (EGLDisplay dpy, EGLNativePixmapType pixmap);
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLBoolean EGLAPIENTRY eglCreateShmPixmapDESKTOP (EGLDisplay dpy, EGLConfig config, EGLint width, EGLint height, EGLNativePixmapType *pixmap, void **pixels, EGLint *stride);
+EGLAPI EGLBoolean EGLAPIENTRY eglDestroyShmPixmapDESKTOP (EGLDisplay dpy, EGLNativePixmapType pixmap);
+#endif
+#endif /* EGL_DESKTOP_shm_pixmap */
+
+#ifndef EGL_DESKTOP_frame_timestamps
+#define EGL_DESKTOP_frame_timestamps 1
+/* Additional timestamps of eglGetFrameTimestampsANDROID. The submit time is taken, when eglSwapBuffers is called.
+** The present MSC is the media stream counter of the vertical blank, the frame was presented at. */
+#define EGL_SUBMIT_TIME_DESKTOP           0x7F07
+#define EGL_DISPLAY_PRESENT_MSC_DESKTOP   0x7F08
+#endif /* EGL_DESKTOP_frame_timestamps */
+
+#ifndef EGL_DESKTOP_frame_throttle
+#define EGL_DESKTOP_frame_throttle 1
+/* Window surface attributes of eglSurfaceAttrib. A swap of the current window waits, until less than the maximum of frames
+** are in flight on the GPU. Zero, the default, disables the limit. If the throttle does not block, the swap fails with
+** EGL_BAD_ACCESS instead of waiting. The depth of the queue is only observed, while a limit is set. */
+#define EGL_MAX_FRAMES_IN_FLIGHT_DESKTOP  0x7F09
+#define EGL_FRAME_THROTTLE_BLOCKING_DESKTOP 0x7F0A
+/* Read only. Frames in flight at the last swap and the most ever observed. */
+#define EGL_FRAMES_IN_FLIGHT_DESKTOP      0x7F0B
+#define EGL_PEAK_FRAMES_IN_FLIGHT_DESKTOP 0x7F0C
+#endif /* EGL_DESKTOP_frame_throttle */
+
+#ifndef EGL_DESKTOP_swap_control_tear
+#define EGL_DESKTOP_swap_control_tear 1
+/* EGL_MIN_SWAP_INTERVAL of the configs is negative. A negative interval of eglSwapInterval waits for the vertical blank
+** as its absolute value does, but a frame, which missed it, is presented immediately and may tear. */
+#endif /* EGL_DESKTOP_swap_control_tear */
+
+#ifndef EGL_DESKTOP_async_present
+#define EGL_DESKTOP_async_present 1
+/* Window surface attribute of eglSurfaceAttrib. The window is rendered into one of two offscreen buffers, which a present
+** thread copies into the window and swaps. eglSwapBuffers returns, as soon as the other buffer can be rendered into, and
+** does not block other calls on the display meanwhile. Takes effect with the next swap, which has to be called from the
+** current context. Not compatible with EGL_BUFFER_PRESERVED and EGL_SINGLE_BUFFER. */
+#define EGL_ASYNC_PRESENT_DESKTOP         0x7F0D
+#endif /* EGL_DESKTOP_async_present */
+
+#ifndef EGL_DESKTOP_config_attribs
+#define EGL_DESKTOP_config_attribs 1
+/* Queries the attributes of eglGetConfigAttrib for many configs at once. The value of attribute j of config i is written to
+** values[i * num_attributes + j]. If an attribute or a config is invalid, the content of values is undefined. */
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLGETCONFIGATTRIBSDESKTOPPROC) (EGLDisplay dpy, const EGLConfig *configs, EGLint num_configs, const EGLint *attributes, EGLint num_attributes, EGLint *values);
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLBoolean EGLAPIENTRY eglGetConfigAttribsDESKTOP (EGLDisplay dpy, const EGLConfig *configs, EGLint num_configs, const EGLint *attributes, EGLint num_attributes, EGLint *values);
+#endif
+#endif /* EGL_DESKTOP_config_attribs */
+
+#ifndef EGL_DESKTOP_context_pool
+#define EGL_DESKTOP_context_pool 1
+/* Creates count native contexts on a background thread, for the config, the surface type and the attributes of
+** eglCreateContext with the current API. The first eglMakeCurrent of a context created with the same attributes and
+** share_context takes one of them, if the surface uses the same native config. The share group of share_context must
+** already have been made current once. */
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLPREWARMCONTEXTSDESKTOPPROC) (EGLDisplay dpy, EGLConfig config, EGLint surface_type, EGLContext share_context, const EGLint *attrib_list, EGLint count);
+/* Read only context attributes of eglQueryContext. Microseconds from eglCreateContext to the first eglSwapBuffers, while
+** the context was current, zero before. EGL_TRUE, if the first native context was taken from the pool. */
+#define EGL_TIME_TO_FIRST_FRAME_DESKTOP   0x7F0E
+#define EGL_CONTEXT_POOLED_DESKTOP        0x7F0F
+#ifdef EGL_EGLEXT_PROTOTYPES
+EGLAPI EGLBoolean EGLAPIENTRY eglPrewarmContextsDESKTOP (EGLDisplay dpy, EGLConfig config, EGLint surface_type, EGLContext share_context, const EGLint *attrib_list, EGLint count);
+#endif
+#endif /* EGL_DESKTOP_context_pool */
+
+#ifndef EGL_DESKTOP_virtual_context
+#define EGL_DESKTOP_virtual_context 1
+/* Context attribute of eglCreateContext. Virtual contexts of the same config and attributes share one native context per
+** surface and their objects, as a share group does, so they can not have a share_context. Switching between them on the
+** same surfaces does not make the native context current again. Only the state, which is set through the GL entry points
+** returned by eglGetProcAddress after eglInitialize, is saved and restored: bindings of programs, vertex arrays,
+** framebuffers, renderbuffers, buffers except the element array buffer, the first 16 indexed uniform buffers and 2D, 3D,
+** cube map and 2D array textures of the first 16 units, viewport, scissor box, clear values, blend, stencil, polygon
+** offset, depth, color mask, culling, pixel alignment and the common capabilities. Deleting a bound object clears the
+** binding, and deleting the program in use stops using it. eglQueryContext returns the attribute. */
+#define EGL_VIRTUAL_CONTEXT_DESKTOP       0x7F10
+#endif /* EGL_DESKTOP_virtual_context */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EGL_DESKTOPEXT_H_ */
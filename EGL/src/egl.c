@@ -24,7 +24,13 @@
  * THE SOFTWARE.
  */
 
+#define EGL_EGLEXT_PROTOTYPES
+
+#include <string.h>
+
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <EGL/egldesktopext.h>
 
 //
 // Native external implementations.
@@ -36,12 +42,16 @@
 
 extern EGLBoolean _eglChooseConfig (EGLDisplay dpy, const EGLint *attrib_list, EGLConfig *configs, EGLint config_size, EGLint *num_config);
 
+extern EGLBoolean _eglCopyBuffers (EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType target);
+
 extern EGLContext _eglCreateContext (EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint *attrib_list);
 
 extern EGLSurface _eglCreateWindowSurface (EGLDisplay dpy, EGLConfig config, EGLNativeWindowType win, const EGLint *attrib_list);
 
 extern EGLSurface _eglCreatePbufferSurface(EGLDisplay dpy, EGLConfig config, const EGLint* attrib_list);
 
+extern EGLSurface _eglCreatePixmapSurface (EGLDisplay dpy, EGLConfig config, EGLNativePixmapType pixmap, const EGLint *attrib_list);
+
 extern EGLBoolean _eglDestroyContext (EGLDisplay dpy, EGLContext ctx);
 
 extern EGLBoolean _eglDestroySurface (EGLDisplay dpy, EGLSurface surface);
@@ -82,6 +92,12 @@ extern EGLBoolean _eglGetPlatformDependentHandles (void* out, EGLDisplay dpy, EG
 // EGL_VERSION_1_1
 //
 
+extern EGLBoolean _eglBindTexImage (EGLDisplay dpy, EGLSurface surface, EGLint buffer);
+
+extern EGLBoolean _eglReleaseTexImage (EGLDisplay dpy, EGLSurface surface, EGLint buffer);
+
+extern EGLBoolean _eglSurfaceAttrib (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint value);
+
 extern EGLBoolean _eglSwapInterval (EGLDisplay dpy, EGLint interval);
 
 //
@@ -90,6 +106,8 @@ extern EGLBoolean _eglSwapInterval (EGLDisplay dpy, EGLint interval);
 
 extern EGLBoolean _eglBindAPI (EGLenum api);
 
+extern EGLSurface _eglCreatePbufferFromClientBuffer (EGLDisplay dpy, EGLenum buftype, EGLClientBuffer buffer, EGLConfig config, const EGLint *attrib_list);
+
 extern EGLenum _eglQueryAPI (void);
 
 extern EGLBoolean _eglWaitClient (void);
@@ -108,6 +126,150 @@ EGLContext _eglGetCurrentContext (void);
 // EGL_VERSION_1_5
 //
 
+//
+// EGL_KHR_stream
+//
+
+extern EGLStreamKHR _eglCreateStreamKHR (EGLDisplay dpy, const EGLint *attrib_list);
+
+extern EGLBoolean _eglDestroyStreamKHR (EGLDisplay dpy, EGLStreamKHR stream);
+
+extern EGLBoolean _eglStreamAttribKHR (EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLint value);
+
+extern EGLBoolean _eglQueryStreamKHR (EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLint *value);
+
+extern EGLBoolean _eglQueryStreamu64KHR (EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLuint64KHR *value);
+
+extern EGLBoolean _eglQueryStreamTimeKHR (EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLTimeKHR *value);
+
+extern EGLBoolean _eglStreamConsumerGLTextureExternalKHR (EGLDisplay dpy, EGLStreamKHR stream);
+
+extern EGLBoolean _eglStreamConsumerAcquireKHR (EGLDisplay dpy, EGLStreamKHR stream);
+
+extern EGLBoolean _eglStreamConsumerReleaseKHR (EGLDisplay dpy, EGLStreamKHR stream);
+
+extern EGLSurface _eglCreateStreamProducerSurfaceKHR (EGLDisplay dpy, EGLConfig config, EGLStreamKHR stream, const EGLint *attrib_list);
+
+//
+// EGL_KHR_stream_cross_process_fd
+//
+
+extern EGLNativeFileDescriptorKHR _eglGetStreamFileDescriptorKHR (EGLDisplay dpy, EGLStreamKHR stream);
+
+extern EGLStreamKHR _eglCreateStreamFromFileDescriptorKHR (EGLDisplay dpy, EGLNativeFileDescriptorKHR file_descriptor);
+
+//
+// EGL_KHR_lock_surface3
+//
+
+extern EGLBoolean _eglLockSurfaceKHR (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list);
+
+extern EGLBoolean _eglUnlockSurfaceKHR (EGLDisplay dpy, EGLSurface surface);
+
+extern EGLBoolean _eglQuerySurface64KHR (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR *value);
+
+//
+// EGL_KHR_partial_update
+//
+
+extern EGLBoolean _eglSetDamageRegionKHR (EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects);
+
+//
+// EGL_EXT_swap_buffers_with_damage
+//
+
+extern EGLBoolean _eglSwapBuffersWithDamageEXT (EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects);
+
+//
+// EGL_ANDROID_get_frame_timestamps
+//
+
+extern EGLBoolean _eglGetCompositorTimingSupportedANDROID (EGLDisplay dpy, EGLSurface surface, EGLint name);
+
+extern EGLBoolean _eglGetCompositorTimingANDROID (EGLDisplay dpy, EGLSurface surface, EGLint numTimestamps, const EGLint *names, EGLnsecsANDROID *values);
+
+extern EGLBoolean _eglGetNextFrameIdANDROID (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId);
+
+extern EGLBoolean _eglGetFrameTimestampSupportedANDROID (EGLDisplay dpy, EGLSurface surface, EGLint timestamp);
+
+extern EGLBoolean _eglGetFrameTimestampsANDROID (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint *timestamps, EGLnsecsANDROID *values);
+
+//
+// EGL_DESKTOP_readback_async
+//
+
+extern EGLReadbackDESKTOP _eglReadPixelsAsyncDESKTOP (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLReadbackCallbackDESKTOP callback, void *user_data);
+
+extern EGLint _eglClientWaitReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback, EGLTime timeout);
+
+extern EGLBoolean _eglMapReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback, const void **pixels, EGLint *width, EGLint *height);
+
+extern EGLBoolean _eglReleaseReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback);
+
+//
+// EGL_DESKTOP_shm_pixmap
+//
+
+extern EGLBoolean _eglCreateShmPixmapDESKTOP (EGLDisplay dpy, EGLConfig config, EGLint width, EGLint height, EGLNativePixmapType *pixmap, void **pixels, EGLint *stride);
+
+extern EGLBoolean _eglDestroyShmPixmapDESKTOP (EGLDisplay dpy, EGLNativePixmapType pixmap);
+
+//
+// EGL_DESKTOP_config_attribs
+//
+
+extern EGLBoolean _eglGetConfigAttribsDESKTOP (EGLDisplay dpy, const EGLConfig *configs, EGLint num_configs, const EGLint *attributes, EGLint num_attributes, EGLint *values);
+
+//
+// EGL_DESKTOP_context_pool
+//
+
+extern EGLBoolean _eglPrewarmContextsDESKTOP (EGLDisplay dpy, EGLConfig config, EGLint surface_type, EGLContext share_context, const EGLint *attrib_list, EGLint count);
+
+//
+// Extension functions, which are returned by eglGetProcAddress.
+//
+
+typedef struct _EGLProcAddress
+{
+	const char* name;
+	__eglMustCastToProperFunctionPointerType proc;
+} _EGLProcAddress;
+
+static const _EGLProcAddress _eglProcAddresses[] = {
+	{ "eglCreateStreamKHR", (__eglMustCastToProperFunctionPointerType)eglCreateStreamKHR },
+	{ "eglDestroyStreamKHR", (__eglMustCastToProperFunctionPointerType)eglDestroyStreamKHR },
+	{ "eglStreamAttribKHR", (__eglMustCastToProperFunctionPointerType)eglStreamAttribKHR },
+	{ "eglQueryStreamKHR", (__eglMustCastToProperFunctionPointerType)eglQueryStreamKHR },
+	{ "eglQueryStreamu64KHR", (__eglMustCastToProperFunctionPointerType)eglQueryStreamu64KHR },
+	{ "eglQueryStreamTimeKHR", (__eglMustCastToProperFunctionPointerType)eglQueryStreamTimeKHR },
+	{ "eglStreamConsumerGLTextureExternalKHR", (__eglMustCastToProperFunctionPointerType)eglStreamConsumerGLTextureExternalKHR },
+	{ "eglStreamConsumerAcquireKHR", (__eglMustCastToProperFunctionPointerType)eglStreamConsumerAcquireKHR },
+	{ "eglStreamConsumerReleaseKHR", (__eglMustCastToProperFunctionPointerType)eglStreamConsumerReleaseKHR },
+	{ "eglCreateStreamProducerSurfaceKHR", (__eglMustCastToProperFunctionPointerType)eglCreateStreamProducerSurfaceKHR },
+	{ "eglGetStreamFileDescriptorKHR", (__eglMustCastToProperFunctionPointerType)eglGetStreamFileDescriptorKHR },
+	{ "eglCreateStreamFromFileDescriptorKHR", (__eglMustCastToProperFunctionPointerType)eglCreateStreamFromFileDescriptorKHR },
+	{ "eglLockSurfaceKHR", (__eglMustCastToProperFunctionPointerType)eglLockSurfaceKHR },
+	{ "eglUnlockSurfaceKHR", (__eglMustCastToProperFunctionPointerType)eglUnlockSurfaceKHR },
+	{ "eglQuerySurface64KHR", (__eglMustCastToProperFunctionPointerType)eglQuerySurface64KHR },
+	{ "eglSetDamageRegionKHR", (__eglMustCastToProperFunctionPointerType)eglSetDamageRegionKHR },
+	{ "eglSwapBuffersWithDamageEXT", (__eglMustCastToProperFunctionPointerType)eglSwapBuffersWithDamageEXT },
+	{ "eglGetCompositorTimingSupportedANDROID", (__eglMustCastToProperFunctionPointerType)eglGetCompositorTimingSupportedANDROID },
+	{ "eglGetCompositorTimingANDROID", (__eglMustCastToProperFunctionPointerType)eglGetCompositorTimingANDROID },
+	{ "eglGetNextFrameIdANDROID", (__eglMustCastToProperFunctionPointerType)eglGetNextFrameIdANDROID },
+	{ "eglGetFrameTimestampSupportedANDROID", (__eglMustCastToProperFunctionPointerType)eglGetFrameTimestampSupportedANDROID },
+	{ "eglGetFrameTimestampsANDROID", (__eglMustCastToProperFunctionPointerType)eglGetFrameTimestampsANDROID },
+	{ "eglReadPixelsAsyncDESKTOP", (__eglMustCastToProperFunctionPointerType)eglReadPixelsAsyncDESKTOP },
+	{ "eglClientWaitReadbackDESKTOP", (__eglMustCastToProperFunctionPointerType)eglClientWaitReadbackDESKTOP },
+	{ "eglMapReadbackDESKTOP", (__eglMustCastToProperFunctionPointerType)eglMapReadbackDESKTOP },
+	{ "eglReleaseReadbackDESKTOP", (__eglMustCastToProperFunctionPointerType)eglReleaseReadbackDESKTOP },
+	{ "eglCreateShmPixmapDESKTOP", (__eglMustCastToProperFunctionPointerType)eglCreateShmPixmapDESKTOP },
+	{ "eglDestroyShmPixmapDESKTOP", (__eglMustCastToProperFunctionPointerType)eglDestroyShmPixmapDESKTOP },
+	{ "eglGetConfigAttribsDESKTOP", (__eglMustCastToProperFunctionPointerType)eglGetConfigAttribsDESKTOP },
+	{ "eglPrewarmContextsDESKTOP", (__eglMustCastToProperFunctionPointerType)eglPrewarmContextsDESKTOP },
+	{ 0, 0 }
+};
+
 //
 // Wrapper.
 //
@@ -123,9 +285,7 @@ EGLAPI EGLBoolean EGLAPIENTRY eglChooseConfig (EGLDisplay dpy, const EGLint *att
 
 EGLAPI EGLBoolean EGLAPIENTRY eglCopyBuffers (EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType target)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglCopyBuffers (dpy, surface, target);
 }
 
 EGLAPI EGLContext EGLAPIENTRY eglCreateContext (EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint *attrib_list)
@@ -140,9 +300,7 @@ EGLAPI EGLSurface EGLAPIENTRY eglCreatePbufferSurface (EGLDisplay dpy, EGLConfig
 
 EGLAPI EGLSurface EGLAPIENTRY eglCreatePixmapSurface (EGLDisplay dpy, EGLConfig config, EGLNativePixmapType pixmap, const EGLint *attrib_list)
 {
-	// TODO Implement.
-
-	return EGL_NO_SURFACE;
+	return _eglCreatePixmapSurface (dpy, config, pixmap, attrib_list);
 }
 
 EGLAPI EGLSurface EGLAPIENTRY eglCreateWindowSurface (EGLDisplay dpy, EGLConfig config, EGLNativeWindowType win, const EGLint *attrib_list)
@@ -192,6 +350,21 @@ EGLAPI EGLint EGLAPIENTRY eglGetError (void)
 
 EGLAPI __eglMustCastToProperFunctionPointerType EGLAPIENTRY eglGetProcAddress (const char *procname)
 {
+	const _EGLProcAddress* walkerProcAddress = _eglProcAddresses;
+
+	if (procname)
+	{
+		while (walkerProcAddress->name)
+		{
+			if (strcmp(walkerProcAddress->name, procname) == 0)
+			{
+				return walkerProcAddress->proc;
+			}
+
+			walkerProcAddress++;
+		}
+	}
+
 	return _eglGetProcAddress (procname);
 }
 
@@ -256,23 +429,17 @@ EGLAPI EGLBoolean EGLAPIENTRY eglWaitNative (EGLint engine)
 
 EGLAPI EGLBoolean EGLAPIENTRY eglBindTexImage (EGLDisplay dpy, EGLSurface surface, EGLint buffer)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglBindTexImage (dpy, surface, buffer);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglReleaseTexImage (EGLDisplay dpy, EGLSurface surface, EGLint buffer)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglReleaseTexImage (dpy, surface, buffer);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglSurfaceAttrib (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint value)
 {
-	// TODO Implement.
-
-	return EGL_FALSE;
+	return _eglSurfaceAttrib (dpy, surface, attribute, value);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglSwapInterval (EGLDisplay dpy, EGLint interval)
@@ -296,9 +463,7 @@ EGLAPI EGLenum EGLAPIENTRY eglQueryAPI (void)
 
 EGLAPI EGLSurface EGLAPIENTRY eglCreatePbufferFromClientBuffer (EGLDisplay dpy, EGLenum buftype, EGLClientBuffer buffer, EGLConfig config, const EGLint *attrib_list)
 {
-	// TODO Implement.
-
-	return EGL_NO_SURFACE;
+	return _eglCreatePbufferFromClientBuffer (dpy, buftype, buffer, config, attrib_list);
 }
 
 EGLAPI EGLBoolean EGLAPIENTRY eglReleaseThread (void)
@@ -400,6 +565,208 @@ EGLAPI EGLBoolean EGLAPIENTRY eglWaitSync (EGLDisplay dpy, EGLSync sync, EGLint
 	return EGL_FALSE;
 }
 
+//
+// EGL_KHR_stream
+//
+
+EGLAPI EGLStreamKHR EGLAPIENTRY eglCreateStreamKHR (EGLDisplay dpy, const EGLint *attrib_list)
+{
+	return _eglCreateStreamKHR (dpy, attrib_list);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglDestroyStreamKHR (EGLDisplay dpy, EGLStreamKHR stream)
+{
+	return _eglDestroyStreamKHR (dpy, stream);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglStreamAttribKHR (EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLint value)
+{
+	return _eglStreamAttribKHR (dpy, stream, attribute, value);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglQueryStreamKHR (EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLint *value)
+{
+	return _eglQueryStreamKHR (dpy, stream, attribute, value);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglQueryStreamu64KHR (EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLuint64KHR *value)
+{
+	return _eglQueryStreamu64KHR (dpy, stream, attribute, value);
+}
+
+//
+// EGL_KHR_stream_fifo
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglQueryStreamTimeKHR (EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLTimeKHR *value)
+{
+	return _eglQueryStreamTimeKHR (dpy, stream, attribute, value);
+}
+
+//
+// EGL_KHR_stream_consumer_gltexture
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglStreamConsumerGLTextureExternalKHR (EGLDisplay dpy, EGLStreamKHR stream)
+{
+	return _eglStreamConsumerGLTextureExternalKHR (dpy, stream);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglStreamConsumerAcquireKHR (EGLDisplay dpy, EGLStreamKHR stream)
+{
+	return _eglStreamConsumerAcquireKHR (dpy, stream);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglStreamConsumerReleaseKHR (EGLDisplay dpy, EGLStreamKHR stream)
+{
+	return _eglStreamConsumerReleaseKHR (dpy, stream);
+}
+
+//
+// EGL_KHR_stream_producer_eglsurface
+//
+
+EGLAPI EGLSurface EGLAPIENTRY eglCreateStreamProducerSurfaceKHR (EGLDisplay dpy, EGLConfig config, EGLStreamKHR stream, const EGLint *attrib_list)
+{
+	return _eglCreateStreamProducerSurfaceKHR (dpy, config, stream, attrib_list);
+}
+
+//
+// EGL_KHR_stream_cross_process_fd
+//
+
+EGLAPI EGLNativeFileDescriptorKHR EGLAPIENTRY eglGetStreamFileDescriptorKHR (EGLDisplay dpy, EGLStreamKHR stream)
+{
+	return _eglGetStreamFileDescriptorKHR (dpy, stream);
+}
+
+EGLAPI EGLStreamKHR EGLAPIENTRY eglCreateStreamFromFileDescriptorKHR (EGLDisplay dpy, EGLNativeFileDescriptorKHR file_descriptor)
+{
+	return _eglCreateStreamFromFileDescriptorKHR (dpy, file_descriptor);
+}
+
+//
+// EGL_KHR_lock_surface3
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglLockSurfaceKHR (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list)
+{
+	return _eglLockSurfaceKHR (dpy, surface, attrib_list);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglUnlockSurfaceKHR (EGLDisplay dpy, EGLSurface surface)
+{
+	return _eglUnlockSurfaceKHR (dpy, surface);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglQuerySurface64KHR (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR *value)
+{
+	return _eglQuerySurface64KHR (dpy, surface, attribute, value);
+}
+
+//
+// EGL_KHR_partial_update
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglSetDamageRegionKHR (EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+	return _eglSetDamageRegionKHR (dpy, surface, rects, n_rects);
+}
+
+//
+// EGL_EXT_swap_buffers_with_damage
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglSwapBuffersWithDamageEXT (EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+	return _eglSwapBuffersWithDamageEXT (dpy, surface, rects, n_rects);
+}
+
+//
+// EGL_ANDROID_get_frame_timestamps
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetCompositorTimingSupportedANDROID (EGLDisplay dpy, EGLSurface surface, EGLint name)
+{
+	return _eglGetCompositorTimingSupportedANDROID (dpy, surface, name);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetCompositorTimingANDROID (EGLDisplay dpy, EGLSurface surface, EGLint numTimestamps, const EGLint *names, EGLnsecsANDROID *values)
+{
+	return _eglGetCompositorTimingANDROID (dpy, surface, numTimestamps, names, values);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetNextFrameIdANDROID (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId)
+{
+	return _eglGetNextFrameIdANDROID (dpy, surface, frameId);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetFrameTimestampSupportedANDROID (EGLDisplay dpy, EGLSurface surface, EGLint timestamp)
+{
+	return _eglGetFrameTimestampSupportedANDROID (dpy, surface, timestamp);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetFrameTimestampsANDROID (EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint *timestamps, EGLnsecsANDROID *values)
+{
+	return _eglGetFrameTimestampsANDROID (dpy, surface, frameId, numTimestamps, timestamps, values);
+}
+
+//
+// EGL_DESKTOP_readback_async
+//
+
+EGLAPI EGLReadbackDESKTOP EGLAPIENTRY eglReadPixelsAsyncDESKTOP (EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLReadbackCallbackDESKTOP callback, void *user_data)
+{
+	return _eglReadPixelsAsyncDESKTOP (dpy, surface, attrib_list, callback, user_data);
+}
+
+EGLAPI EGLint EGLAPIENTRY eglClientWaitReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback, EGLTime timeout)
+{
+	return _eglClientWaitReadbackDESKTOP (dpy, readback, timeout);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglMapReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback, const void **pixels, EGLint *width, EGLint *height)
+{
+	return _eglMapReadbackDESKTOP (dpy, readback, pixels, width, height);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglReleaseReadbackDESKTOP (EGLDisplay dpy, EGLReadbackDESKTOP readback)
+{
+	return _eglReleaseReadbackDESKTOP (dpy, readback);
+}
+
+//
+// EGL_DESKTOP_shm_pixmap
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglCreateShmPixmapDESKTOP (EGLDisplay dpy, EGLConfig config, EGLint width, EGLint height, EGLNativePixmapType *pixmap, void **pixels, EGLint *stride)
+{
+	return _eglCreateShmPixmapDESKTOP (dpy, config, width, height, pixmap, pixels, stride);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglDestroyShmPixmapDESKTOP (EGLDisplay dpy, EGLNativePixmapType pixmap)
+{
+	return _eglDestroyShmPixmapDESKTOP (dpy, pixmap);
+}
+
+//
+// EGL_DESKTOP_config_attribs
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglGetConfigAttribsDESKTOP (EGLDisplay dpy, const EGLConfig *configs, EGLint num_configs, const EGLint *attributes, EGLint num_attributes, EGLint *values)
+{
+	return _eglGetConfigAttribsDESKTOP (dpy, configs, num_configs, attributes, num_attributes, values);
+}
+
+//
+// EGL_DESKTOP_context_pool
+//
+
+EGLAPI EGLBoolean EGLAPIENTRY eglPrewarmContextsDESKTOP (EGLDisplay dpy, EGLConfig config, EGLint surface_type, EGLContext share_context, const EGLint *attrib_list, EGLint count)
+{
+	return _eglPrewarmContextsDESKTOP (dpy, config, surface_type, share_context, attrib_list, count);
+}
+
 /*
 EGLAPI EGLBoolean EGLAPIENTRY eglGetPlatformDependentHandles (EGLContextInternals* out, EGLDisplay dpy, EGLSurface surface, EGLContext ctx)
 {
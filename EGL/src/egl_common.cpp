@@ -25,6 +25,7 @@
  */
 
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include "egl_internal.h"
 
@@ -136,10 +137,39 @@ private:
 	constexpr inline static uint32_t LOCK_WRITE_VALUE = 0xdeadbeefu;
 };
 
-typedef std::lock_guard<std::mutex> guard_t;
+typedef std::lock_guard<std::shared_mutex> guard_t;
+typedef std::unique_lock<std::shared_mutex> unique_guard_t;
+typedef std::shared_lock<std::shared_mutex> shared_guard_t;
+
+typedef std::lock_guard<std::mutex> object_guard_t;
+typedef std::unique_lock<std::mutex> unique_object_guard_t;
+
+// Display lock held shared and the lock of one surface. Unlocked and locked again in the order display, surface.
+struct SurfaceLock
+{
+	SurfaceLock(shared_guard_t& display, EGLSurfaceImpl* surface) :
+		display(display), surface(*surface->mutex)
+	{
+	}
+
+	void unlock()
+	{
+		surface.unlock();
+		display.unlock();
+	}
+
+	void lock()
+	{
+		display.lock();
+		surface.lock();
+	}
+
+	shared_guard_t& display;
+	unique_object_guard_t surface;
+};
 
 static thread_local LocalStorage g_localStorage =
-    { EGL_SUCCESS, EGL_NONE, EGL_NO_CONTEXT_IMPL };
+    { EGL_SUCCESS, EGL_NONE, EGL_NO_CONTEXT_IMPL, 0 };
 
 static GlobalStorage g_globalStorage;
 
@@ -149,8 +179,262 @@ static EGLint g_ES_max_supported_version[2] = { 0, 0 };
 #if defined(EGL_NO_GLEW)
 extern void (*glFinish_PTR)();
 #define glFinish(...) glFinish_PTR(__VA_ARGS__)
+
+// OpenGL functions used by the common implementation. Loaded after the native layer is initialized.
+static void (*glFlush_PTR)() = NULL;
+static void (*glGetIntegerv_PTR)(GLenum, GLint*) = NULL;
+static void (*glBindTexture_PTR)(GLenum, GLuint) = NULL;
+static void (*glPixelStorei_PTR)(GLenum, GLint) = NULL;
+static void (*glReadPixels_PTR)(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*) = NULL;
+static void (*glTexImage2D_PTR)(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*) = NULL;
+static void (*glTexSubImage2D_PTR)(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const void*) = NULL;
+
+#define glFlush(...) glFlush_PTR(__VA_ARGS__)
+#define glGetIntegerv(...) glGetIntegerv_PTR(__VA_ARGS__)
+#define glBindTexture(...) glBindTexture_PTR(__VA_ARGS__)
+#define glPixelStorei(...) glPixelStorei_PTR(__VA_ARGS__)
+#define glReadPixels(...) glReadPixels_PTR(__VA_ARGS__)
+#define glTexImage2D(...) glTexImage2D_PTR(__VA_ARGS__)
+#define glTexSubImage2D(...) glTexSubImage2D_PTR(__VA_ARGS__)
+
+#if !defined(GL_VERSION_3_2)
+// Not declared by the system OpenGL header, e.g. under Windows.
+typedef struct __GLsync* GLsync;
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+typedef unsigned long long GLuint64;
+
+#define GL_STREAM_READ 0x88E1
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_PIXEL_PACK_BUFFER_BINDING 0x88ED
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#define GL_PIXEL_UNPACK_BUFFER_BINDING 0x88EF
+#define GL_MAP_READ_BIT 0x0001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_WAIT_FAILED 0x911D
+
+typedef char GLchar;
+
+#define GL_CLAMP_TO_EDGE 0x812F
+#define GL_VERTEX_ARRAY_BINDING 0x85B5
+#define GL_TEXTURE0 0x84C0
+#define GL_ACTIVE_TEXTURE 0x84E0
+#define GL_R8 0x8229
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_CURRENT_PROGRAM 0x8B8D
+#define GL_DRAW_FRAMEBUFFER_BINDING 0x8CA6
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_READ_FRAMEBUFFER_BINDING 0x8CAA
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_FRAMEBUFFER_SRGB 0x8DB9
+#endif
+
+static void (*glGenBuffers_PTR)(GLsizei, GLuint*) = NULL;
+static void (*glDeleteBuffers_PTR)(GLsizei, const GLuint*) = NULL;
+static void (*glBindBuffer_PTR)(GLenum, GLuint) = NULL;
+static void (*glBufferData_PTR)(GLenum, GLsizeiptr, const void*, GLenum) = NULL;
+static void* (*glMapBufferRange_PTR)(GLenum, GLintptr, GLsizeiptr, GLbitfield) = NULL;
+static GLboolean (*glUnmapBuffer_PTR)(GLenum) = NULL;
+static GLsync (*glFenceSync_PTR)(GLenum, GLbitfield) = NULL;
+static GLenum (*glClientWaitSync_PTR)(GLsync, GLbitfield, GLuint64) = NULL;
+static void (*glDeleteSync_PTR)(GLsync) = NULL;
+static void (*glWaitSync_PTR)(GLsync, GLbitfield, GLuint64) = NULL;
+
+#define glGenBuffers(...) glGenBuffers_PTR(__VA_ARGS__)
+#define glDeleteBuffers(...) glDeleteBuffers_PTR(__VA_ARGS__)
+#define glBindBuffer(...) glBindBuffer_PTR(__VA_ARGS__)
+#define glBufferData(...) glBufferData_PTR(__VA_ARGS__)
+#define glMapBufferRange(...) glMapBufferRange_PTR(__VA_ARGS__)
+#define glUnmapBuffer(...) glUnmapBuffer_PTR(__VA_ARGS__)
+#define glFenceSync(...) glFenceSync_PTR(__VA_ARGS__)
+#define glClientWaitSync(...) glClientWaitSync_PTR(__VA_ARGS__)
+#define glDeleteSync(...) glDeleteSync_PTR(__VA_ARGS__)
+#define glWaitSync(...) glWaitSync_PTR(__VA_ARGS__)
+
+static void (*glEnable_PTR)(GLenum) = NULL;
+static void (*glDisable_PTR)(GLenum) = NULL;
+static GLboolean (*glIsEnabled_PTR)(GLenum) = NULL;
+static void (*glGetBooleanv_PTR)(GLenum, GLboolean*) = NULL;
+static void (*glColorMask_PTR)(GLboolean, GLboolean, GLboolean, GLboolean) = NULL;
+static void (*glViewport_PTR)(GLint, GLint, GLsizei, GLsizei) = NULL;
+static void (*glDrawArrays_PTR)(GLenum, GLint, GLsizei) = NULL;
+static void (*glGenTextures_PTR)(GLsizei, GLuint*) = NULL;
+static void (*glTexParameteri_PTR)(GLenum, GLenum, GLint) = NULL;
+static void (*glCopyTexSubImage2D_PTR)(GLenum, GLint, GLint, GLint, GLint, GLint, GLsizei, GLsizei) = NULL;
+static void (*glActiveTexture_PTR)(GLenum) = NULL;
+static GLuint (*glCreateShader_PTR)(GLenum) = NULL;
+static void (*glShaderSource_PTR)(GLuint, GLsizei, const GLchar* const*, const GLint*) = NULL;
+static void (*glCompileShader_PTR)(GLuint) = NULL;
+static void (*glGetShaderiv_PTR)(GLuint, GLenum, GLint*) = NULL;
+static void (*glDeleteShader_PTR)(GLuint) = NULL;
+static GLuint (*glCreateProgram_PTR)() = NULL;
+static void (*glAttachShader_PTR)(GLuint, GLuint) = NULL;
+static void (*glLinkProgram_PTR)(GLuint) = NULL;
+static void (*glGetProgramiv_PTR)(GLuint, GLenum, GLint*) = NULL;
+static void (*glUseProgram_PTR)(GLuint) = NULL;
+static GLint (*glGetUniformLocation_PTR)(GLuint, const GLchar*) = NULL;
+static void (*glUniform1i_PTR)(GLint, GLint) = NULL;
+static void (*glUniform2i_PTR)(GLint, GLint, GLint) = NULL;
+static void (*glGenVertexArrays_PTR)(GLsizei, GLuint*) = NULL;
+static void (*glBindVertexArray_PTR)(GLuint) = NULL;
+static void (*glGenFramebuffers_PTR)(GLsizei, GLuint*) = NULL;
+static void (*glBindFramebuffer_PTR)(GLenum, GLuint) = NULL;
+static void (*glFramebufferTexture2D_PTR)(GLenum, GLenum, GLenum, GLuint, GLint) = NULL;
+static GLenum (*glCheckFramebufferStatus_PTR)(GLenum) = NULL;
+
+#define glEnable(...) glEnable_PTR(__VA_ARGS__)
+#define glDisable(...) glDisable_PTR(__VA_ARGS__)
+#define glIsEnabled(...) glIsEnabled_PTR(__VA_ARGS__)
+#define glGetBooleanv(...) glGetBooleanv_PTR(__VA_ARGS__)
+#define glColorMask(...) glColorMask_PTR(__VA_ARGS__)
+#define glViewport(...) glViewport_PTR(__VA_ARGS__)
+#define glDrawArrays(...) glDrawArrays_PTR(__VA_ARGS__)
+#define glGenTextures(...) glGenTextures_PTR(__VA_ARGS__)
+#define glTexParameteri(...) glTexParameteri_PTR(__VA_ARGS__)
+#define glCopyTexSubImage2D(...) glCopyTexSubImage2D_PTR(__VA_ARGS__)
+#define glActiveTexture(...) glActiveTexture_PTR(__VA_ARGS__)
+#define glCreateShader(...) glCreateShader_PTR(__VA_ARGS__)
+#define glShaderSource(...) glShaderSource_PTR(__VA_ARGS__)
+#define glCompileShader(...) glCompileShader_PTR(__VA_ARGS__)
+#define glGetShaderiv(...) glGetShaderiv_PTR(__VA_ARGS__)
+#define glDeleteShader(...) glDeleteShader_PTR(__VA_ARGS__)
+#define glCreateProgram(...) glCreateProgram_PTR(__VA_ARGS__)
+#define glAttachShader(...) glAttachShader_PTR(__VA_ARGS__)
+#define glLinkProgram(...) glLinkProgram_PTR(__VA_ARGS__)
+#define glGetProgramiv(...) glGetProgramiv_PTR(__VA_ARGS__)
+#define glUseProgram(...) glUseProgram_PTR(__VA_ARGS__)
+#define glGetUniformLocation(...) glGetUniformLocation_PTR(__VA_ARGS__)
+#define glUniform1i(...) glUniform1i_PTR(__VA_ARGS__)
+#define glUniform2i(...) glUniform2i_PTR(__VA_ARGS__)
+#define glGenVertexArrays(...) glGenVertexArrays_PTR(__VA_ARGS__)
+#define glBindVertexArray(...) glBindVertexArray_PTR(__VA_ARGS__)
+#define glGenFramebuffers(...) glGenFramebuffers_PTR(__VA_ARGS__)
+#define glBindFramebuffer(...) glBindFramebuffer_PTR(__VA_ARGS__)
+#define glFramebufferTexture2D(...) glFramebufferTexture2D_PTR(__VA_ARGS__)
+#define glCheckFramebufferStatus(...) glCheckFramebufferStatus_PTR(__VA_ARGS__)
+
+static GLenum (*glGetError_PTR)() = NULL;
+static const GLubyte* (*glGetStringi_PTR)(GLenum, GLuint) = NULL;
+static void (*glBufferStorage_PTR)(GLenum, GLsizeiptr, const void*, GLbitfield) = NULL;
+
+#define glGetError(...) glGetError_PTR(__VA_ARGS__)
+#define glGetStringi(...) glGetStringi_PTR(__VA_ARGS__)
+#define glBufferStorage(...) glBufferStorage_PTR(__VA_ARGS__)
+
+static void (*glDeleteTextures_PTR)(GLsizei, const GLuint*) = NULL;
+static void (*glDeleteFramebuffers_PTR)(GLsizei, const GLuint*) = NULL;
+static void (*glDeleteVertexArrays_PTR)(GLsizei, const GLuint*) = NULL;
+static void (*glDeleteProgram_PTR)(GLuint) = NULL;
+static void (*glBlitFramebuffer_PTR)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum) = NULL;
+
+#define glDeleteTextures(...) glDeleteTextures_PTR(__VA_ARGS__)
+#define glDeleteFramebuffers(...) glDeleteFramebuffers_PTR(__VA_ARGS__)
+#define glDeleteVertexArrays(...) glDeleteVertexArrays_PTR(__VA_ARGS__)
+#define glDeleteProgram(...) glDeleteProgram_PTR(__VA_ARGS__)
+#define glBlitFramebuffer(...) glBlitFramebuffer_PTR(__VA_ARGS__)
+
+static void (*glReadBuffer_PTR)(GLenum) = NULL;
+static void (*glDrawBuffer_PTR)(GLenum) = NULL;
+
+#define glReadBuffer(...) glReadBuffer_PTR(__VA_ARGS__)
+#define glDrawBuffer(...) glDrawBuffer_PTR(__VA_ARGS__)
 #endif
 
+#if !defined(GL_MAP_PERSISTENT_BIT)
+#define GL_NUM_EXTENSIONS 0x821D
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+
+#if !defined(GL_BGRA)
+#define GL_BGRA 0x80E1
+#endif
+
+#if !defined(GL_PACK_INVERT_MESA)
+#define GL_PACK_INVERT_MESA 0x8758
+#endif
+
+#if !defined(GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD)
+#define GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD 0x9160
+#endif
+
+#if !defined(GL_VERSION_3_1)
+#define GL_TEXTURE_3D 0x806F
+#define GL_MULTISAMPLE 0x809D
+#define GL_SAMPLE_ALPHA_TO_COVERAGE 0x809E
+#define GL_TEXTURE_CUBE_MAP 0x8513
+#define GL_FUNC_ADD 0x8006
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_RASTERIZER_DISCARD 0x8C89
+#define GL_TEXTURE_2D_ARRAY 0x8C1A
+#define GL_RENDERBUFFER 0x8D41
+#define GL_UNIFORM_BUFFER 0x8A11
+#define GL_COPY_READ_BUFFER 0x8F36
+#define GL_COPY_WRITE_BUFFER 0x8F37
+#endif
+
+#if !defined(APIENTRY)
+#define APIENTRY
+#endif
+
+// OpenGL functions, which the wrapped entry points of the virtual contexts call. Loaded in both builds, as the application
+// calls them through eglGetProcAddress.
+static void (APIENTRY *glUseProgram_NATIVE)(GLuint) = NULL;
+static void (APIENTRY *glBindVertexArray_NATIVE)(GLuint) = NULL;
+static void (APIENTRY *glBindFramebuffer_NATIVE)(GLenum, GLuint) = NULL;
+static void (APIENTRY *glBindRenderbuffer_NATIVE)(GLenum, GLuint) = NULL;
+static void (APIENTRY *glBindBuffer_NATIVE)(GLenum, GLuint) = NULL;
+static void (APIENTRY *glActiveTexture_NATIVE)(GLenum) = NULL;
+static void (APIENTRY *glBindTexture_NATIVE)(GLenum, GLuint) = NULL;
+static void (APIENTRY *glViewport_NATIVE)(GLint, GLint, GLsizei, GLsizei) = NULL;
+static void (APIENTRY *glScissor_NATIVE)(GLint, GLint, GLsizei, GLsizei) = NULL;
+static void (APIENTRY *glEnable_NATIVE)(GLenum) = NULL;
+static void (APIENTRY *glDisable_NATIVE)(GLenum) = NULL;
+static void (APIENTRY *glClearColor_NATIVE)(GLfloat, GLfloat, GLfloat, GLfloat) = NULL;
+static void (APIENTRY *glClearDepth_NATIVE)(double) = NULL;
+static void (APIENTRY *glClearStencil_NATIVE)(GLint) = NULL;
+static void (APIENTRY *glBlendFunc_NATIVE)(GLenum, GLenum) = NULL;
+static void (APIENTRY *glBlendFuncSeparate_NATIVE)(GLenum, GLenum, GLenum, GLenum) = NULL;
+static void (APIENTRY *glBlendEquation_NATIVE)(GLenum) = NULL;
+static void (APIENTRY *glBlendEquationSeparate_NATIVE)(GLenum, GLenum) = NULL;
+static void (APIENTRY *glDepthFunc_NATIVE)(GLenum) = NULL;
+static void (APIENTRY *glDepthMask_NATIVE)(GLboolean) = NULL;
+static void (APIENTRY *glColorMask_NATIVE)(GLboolean, GLboolean, GLboolean, GLboolean) = NULL;
+static void (APIENTRY *glCullFace_NATIVE)(GLenum) = NULL;
+static void (APIENTRY *glFrontFace_NATIVE)(GLenum) = NULL;
+static void (APIENTRY *glPixelStorei_NATIVE)(GLenum, GLint) = NULL;
+static void (APIENTRY *glGetIntegerv_NATIVE)(GLenum, GLint*) = NULL;
+static void (APIENTRY *glBindBufferBase_NATIVE)(GLenum, GLuint, GLuint) = NULL;
+static void (APIENTRY *glBindBufferRange_NATIVE)(GLenum, GLuint, GLuint, GLintptr, GLsizeiptr) = NULL;
+static void (APIENTRY *glBlendColor_NATIVE)(GLfloat, GLfloat, GLfloat, GLfloat) = NULL;
+static void (APIENTRY *glStencilFunc_NATIVE)(GLenum, GLint, GLuint) = NULL;
+static void (APIENTRY *glStencilFuncSeparate_NATIVE)(GLenum, GLenum, GLint, GLuint) = NULL;
+static void (APIENTRY *glStencilOp_NATIVE)(GLenum, GLenum, GLenum) = NULL;
+static void (APIENTRY *glStencilOpSeparate_NATIVE)(GLenum, GLenum, GLenum, GLenum) = NULL;
+static void (APIENTRY *glStencilMask_NATIVE)(GLuint) = NULL;
+static void (APIENTRY *glStencilMaskSeparate_NATIVE)(GLenum, GLuint) = NULL;
+static void (APIENTRY *glPolygonOffset_NATIVE)(GLfloat, GLfloat) = NULL;
+static void (APIENTRY *glDepthRange_NATIVE)(double, double) = NULL;
+static void (APIENTRY *glDeleteProgram_NATIVE)(GLuint) = NULL;
+static void (APIENTRY *glDeleteVertexArrays_NATIVE)(GLsizei, const GLuint*) = NULL;
+static void (APIENTRY *glDeleteFramebuffers_NATIVE)(GLsizei, const GLuint*) = NULL;
+static void (APIENTRY *glDeleteRenderbuffers_NATIVE)(GLsizei, const GLuint*) = NULL;
+static void (APIENTRY *glDeleteBuffers_NATIVE)(GLsizei, const GLuint*) = NULL;
+static void (APIENTRY *glDeleteTextures_NATIVE)(GLsizei, const GLuint*) = NULL;
+
+// Set, if all of them were loaded.
+static EGLBoolean g_virtualContextSupported = EGL_FALSE;
+
 extern "C" 
 {
 
@@ -160,1058 +444,9049 @@ static EGLBoolean _eglInternalInit()
 	EGLBoolean r = __internalInit(&dummy, g_GL_max_supported_version, g_ES_max_supported_version);
 	g_globalStorage.dummy_write(dummy);
 
+#if defined(EGL_NO_GLEW)
+	if (r)
+	{
+#define LOAD_GL_FUNC_PTR(fname) fname##_PTR = (decltype(fname##_PTR)) __getProcAddress(#fname)
+		LOAD_GL_FUNC_PTR(glFlush);
+		LOAD_GL_FUNC_PTR(glGetIntegerv);
+		LOAD_GL_FUNC_PTR(glBindTexture);
+		LOAD_GL_FUNC_PTR(glPixelStorei);
+		LOAD_GL_FUNC_PTR(glReadPixels);
+		LOAD_GL_FUNC_PTR(glTexImage2D);
+		LOAD_GL_FUNC_PTR(glTexSubImage2D);
+		LOAD_GL_FUNC_PTR(glGenBuffers);
+		LOAD_GL_FUNC_PTR(glDeleteBuffers);
+		LOAD_GL_FUNC_PTR(glBindBuffer);
+		LOAD_GL_FUNC_PTR(glBufferData);
+		LOAD_GL_FUNC_PTR(glMapBufferRange);
+		LOAD_GL_FUNC_PTR(glUnmapBuffer);
+		LOAD_GL_FUNC_PTR(glFenceSync);
+		LOAD_GL_FUNC_PTR(glClientWaitSync);
+		LOAD_GL_FUNC_PTR(glDeleteSync);
+		LOAD_GL_FUNC_PTR(glWaitSync);
+		LOAD_GL_FUNC_PTR(glEnable);
+		LOAD_GL_FUNC_PTR(glDisable);
+		LOAD_GL_FUNC_PTR(glIsEnabled);
+		LOAD_GL_FUNC_PTR(glGetBooleanv);
+		LOAD_GL_FUNC_PTR(glColorMask);
+		LOAD_GL_FUNC_PTR(glViewport);
+		LOAD_GL_FUNC_PTR(glDrawArrays);
+		LOAD_GL_FUNC_PTR(glGenTextures);
+		LOAD_GL_FUNC_PTR(glTexParameteri);
+		LOAD_GL_FUNC_PTR(glCopyTexSubImage2D);
+		LOAD_GL_FUNC_PTR(glActiveTexture);
+		LOAD_GL_FUNC_PTR(glCreateShader);
+		LOAD_GL_FUNC_PTR(glShaderSource);
+		LOAD_GL_FUNC_PTR(glCompileShader);
+		LOAD_GL_FUNC_PTR(glGetShaderiv);
+		LOAD_GL_FUNC_PTR(glDeleteShader);
+		LOAD_GL_FUNC_PTR(glCreateProgram);
+		LOAD_GL_FUNC_PTR(glAttachShader);
+		LOAD_GL_FUNC_PTR(glLinkProgram);
+		LOAD_GL_FUNC_PTR(glGetProgramiv);
+		LOAD_GL_FUNC_PTR(glUseProgram);
+		LOAD_GL_FUNC_PTR(glGetUniformLocation);
+		LOAD_GL_FUNC_PTR(glUniform1i);
+		LOAD_GL_FUNC_PTR(glUniform2i);
+		LOAD_GL_FUNC_PTR(glGenVertexArrays);
+		LOAD_GL_FUNC_PTR(glBindVertexArray);
+		LOAD_GL_FUNC_PTR(glGenFramebuffers);
+		LOAD_GL_FUNC_PTR(glBindFramebuffer);
+		LOAD_GL_FUNC_PTR(glFramebufferTexture2D);
+		LOAD_GL_FUNC_PTR(glCheckFramebufferStatus);
+		LOAD_GL_FUNC_PTR(glGetError);
+		LOAD_GL_FUNC_PTR(glGetStringi);
+		LOAD_GL_FUNC_PTR(glBufferStorage);
+		LOAD_GL_FUNC_PTR(glDeleteTextures);
+		LOAD_GL_FUNC_PTR(glDeleteFramebuffers);
+		LOAD_GL_FUNC_PTR(glDeleteVertexArrays);
+		LOAD_GL_FUNC_PTR(glDeleteProgram);
+		LOAD_GL_FUNC_PTR(glBlitFramebuffer);
+		LOAD_GL_FUNC_PTR(glReadBuffer);
+		LOAD_GL_FUNC_PTR(glDrawBuffer);
+	}
+#endif
+
+	if (r)
+	{
+#define LOAD_GL_NATIVE_PTR(fname) (fname##_NATIVE = (decltype(fname##_NATIVE)) __getProcAddress(#fname)) != NULL
+		g_virtualContextSupported = (
+			LOAD_GL_NATIVE_PTR(glUseProgram) &&
+			LOAD_GL_NATIVE_PTR(glBindVertexArray) &&
+			LOAD_GL_NATIVE_PTR(glBindFramebuffer) &&
+			LOAD_GL_NATIVE_PTR(glBindRenderbuffer) &&
+			LOAD_GL_NATIVE_PTR(glBindBuffer) &&
+			LOAD_GL_NATIVE_PTR(glActiveTexture) &&
+			LOAD_GL_NATIVE_PTR(glBindTexture) &&
+			LOAD_GL_NATIVE_PTR(glViewport) &&
+			LOAD_GL_NATIVE_PTR(glScissor) &&
+			LOAD_GL_NATIVE_PTR(glEnable) &&
+			LOAD_GL_NATIVE_PTR(glDisable) &&
+			LOAD_GL_NATIVE_PTR(glClearColor) &&
+			LOAD_GL_NATIVE_PTR(glClearDepth) &&
+			LOAD_GL_NATIVE_PTR(glClearStencil) &&
+			LOAD_GL_NATIVE_PTR(glBlendFunc) &&
+			LOAD_GL_NATIVE_PTR(glBlendFuncSeparate) &&
+			LOAD_GL_NATIVE_PTR(glBlendEquation) &&
+			LOAD_GL_NATIVE_PTR(glBlendEquationSeparate) &&
+			LOAD_GL_NATIVE_PTR(glDepthFunc) &&
+			LOAD_GL_NATIVE_PTR(glDepthMask) &&
+			LOAD_GL_NATIVE_PTR(glColorMask) &&
+			LOAD_GL_NATIVE_PTR(glCullFace) &&
+			LOAD_GL_NATIVE_PTR(glFrontFace) &&
+			LOAD_GL_NATIVE_PTR(glPixelStorei) &&
+			LOAD_GL_NATIVE_PTR(glGetIntegerv) &&
+			LOAD_GL_NATIVE_PTR(glBindBufferBase) &&
+			LOAD_GL_NATIVE_PTR(glBindBufferRange) &&
+			LOAD_GL_NATIVE_PTR(glBlendColor) &&
+			LOAD_GL_NATIVE_PTR(glStencilFunc) &&
+			LOAD_GL_NATIVE_PTR(glStencilFuncSeparate) &&
+			LOAD_GL_NATIVE_PTR(glStencilOp) &&
+			LOAD_GL_NATIVE_PTR(glStencilOpSeparate) &&
+			LOAD_GL_NATIVE_PTR(glStencilMask) &&
+			LOAD_GL_NATIVE_PTR(glStencilMaskSeparate) &&
+			LOAD_GL_NATIVE_PTR(glPolygonOffset) &&
+			LOAD_GL_NATIVE_PTR(glDepthRange) &&
+			LOAD_GL_NATIVE_PTR(glDeleteProgram) &&
+			LOAD_GL_NATIVE_PTR(glDeleteVertexArrays) &&
+			LOAD_GL_NATIVE_PTR(glDeleteFramebuffers) &&
+			LOAD_GL_NATIVE_PTR(glDeleteRenderbuffers) &&
+			LOAD_GL_NATIVE_PTR(glDeleteBuffers) &&
+			LOAD_GL_NATIVE_PTR(glDeleteTextures)) ? EGL_TRUE : EGL_FALSE;
+	}
+
 	return r;
 }
 
-static void _eglInternalTerminate()
+static EGLTimeKHR _eglInternalGetTime()
 {
-	auto dummy = g_globalStorage.dummy_read();
-	__internalTerminate(&dummy);
-	g_globalStorage.dummy_write(dummy);
+	return (EGLTimeKHR)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
-static void _eglInternalCleanup()
+static void _eglInternalAppendExtension(EGLDisplayImpl* walkerDpy, const char* extension)
 {
-	EGLDisplayImpl* tempDpy = 0;
+	size_t length = strlen(walkerDpy->extensions);
 
+	if (length + strlen(extension) + 2 > _EGL_EXTENSIONS_SIZE)
 	{
-		auto _wl = g_globalStorage.placeRootDpy_writelock();
-		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
-
-		while (walkerDpy)
-		{
-			EGLSurfaceImpl* tempSurface = 0;
-
-			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
-
-			EGLContextImpl* tempCtx = 0;
+		return;
+	}
 
-			EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+	if (length)
+	{
+		walkerDpy->extensions[length++] = ' ';
+	}
 
-			while (walkerSurface)
-			{
-				if (walkerSurface->destroy && walkerSurface != walkerDpy->currentDraw && walkerSurface != walkerDpy->currentRead)
-				{
-					EGLSurfaceImpl* deleteSurface = walkerSurface;
+	strcpy(walkerDpy->extensions + length, extension);
+}
 
-					if (tempSurface == 0)
-					{
-						walkerDpy->rootSurface = deleteSurface->next;
+static void _eglInternalSetExtensions(EGLDisplayImpl* walkerDpy)
+{
+	walkerDpy->extensions[0] = '\0';
+
+	_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_readback_async");
+	_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_readback_yuv");
+	_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_client_memory");
+	_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_config_attribs");
+	_eglInternalAppendExtension(walkerDpy, "EGL_EXT_swap_buffers_with_damage");
+	_eglInternalAppendExtension(walkerDpy, "EGL_KHR_mutable_render_buffer");
+	_eglInternalAppendExtension(walkerDpy, "EGL_ANDROID_get_frame_timestamps");
+	_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_frame_timestamps");
+	_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_frame_throttle");
+
+	if (walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL_TEAR)
+	{
+		_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_swap_control_tear");
+	}
 
-						walkerSurface = walkerDpy->rootSurface;
-					}
-					else
-					{
-						tempSurface->next = deleteSurface->next;
+	if (walkerDpy->nativeCaps & _EGL_NATIVE_BUFFER_AGE)
+	{
+		_eglInternalAppendExtension(walkerDpy, "EGL_EXT_buffer_age");
+		_eglInternalAppendExtension(walkerDpy, "EGL_KHR_partial_update");
+	}
 
-						walkerSurface = tempSurface;
-					}
+	if (walkerDpy->nativeCaps & _EGL_NATIVE_SHM)
+	{
+		_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_shm_pixmap");
+	}
 
-					free(deleteSurface);
-				}
+	if (walkerDpy->nativeCaps & _EGL_NATIVE_LOCK_SURFACE)
+	{
+		_eglInternalAppendExtension(walkerDpy, "EGL_KHR_lock_surface3");
+	}
 
-				tempSurface = walkerSurface;
+	if (walkerDpy->nativeCaps & _EGL_NATIVE_CONTEXT_POOL)
+	{
+		_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_context_pool");
+	}
 
-				if (walkerSurface)
-					walkerSurface = walkerSurface->next;
-			}
+	if (g_virtualContextSupported)
+	{
+		_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_virtual_context");
+	}
 
-			while (walkerCtx)
-			{
-				// Avoid deleting of a shared context.
-				/*EGLContextImpl* innerWalkerCtx = walkerDpy->rootCtx;
-				while (innerWalkerCtx)
-				{
-					if (innerWalkerCtx->sharedCtx == walkerCtx)
-					{
-						continue;
-					}
+	if ((walkerDpy->nativeCaps & (_EGL_NATIVE_TEXTURE_FROM_PIXMAP | _EGL_NATIVE_THREADS)) == (_EGL_NATIVE_TEXTURE_FROM_PIXMAP | _EGL_NATIVE_THREADS))
+	{
+		_eglInternalAppendExtension(walkerDpy, "EGL_DESKTOP_async_present");
+	}
 
-					innerWalkerCtx = innerWalkerCtx->next;
-				}*/
+	if (walkerDpy->nativeCaps & _EGL_NATIVE_TEXTURE_FROM_PIXMAP)
+	{
+		_eglInternalAppendExtension(walkerDpy, "EGL_KHR_stream");
+		_eglInternalAppendExtension(walkerDpy, "EGL_KHR_stream_consumer_gltexture");
+		_eglInternalAppendExtension(walkerDpy, "EGL_KHR_stream_fifo");
+		_eglInternalAppendExtension(walkerDpy, "EGL_KHR_stream_producer_eglsurface");
 
-				if (walkerCtx->destroy && walkerCtx != walkerDpy->currentCtx && walkerCtx != g_localStorage.currentCtx)
-				{
-					EGLContextImpl* deleteCtx = walkerCtx;
+		if (walkerDpy->nativeCaps & _EGL_NATIVE_STREAM_CROSS_PROCESS)
+		{
+			_eglInternalAppendExtension(walkerDpy, "EGL_KHR_stream_cross_process_fd");
+		}
+	}
+}
 
-					if (tempCtx == 0)
-					{
-						walkerDpy->rootCtx = deleteCtx->next;
+static EGLContextListImpl* _eglInternalFindContextList(EGLContextImpl* ctx, EGLSurfaceImpl* surface)
+{
+	EGLContextListImpl* ctxList = ctx ? ctx->rootCtxList : 0;
 
-						walkerCtx = walkerDpy->rootCtx;
-					}
-					else
-					{
-						tempCtx->next = deleteCtx->next;
+	while (ctxList)
+	{
+		if (ctxList->surface == surface)
+		{
+			break;
+		}
 
-						walkerCtx = tempCtx;
-					}
+		ctxList = ctxList->next;
+	}
 
-					// Freeing the context.
-					while (deleteCtx->rootCtxList)
-					{
-						EGLContextListImpl* deleteCtxList = deleteCtx->rootCtxList;
+	return ctxList;
+}
 
-						deleteCtx->rootCtxList = deleteCtx->rootCtxList->next;
+static void _eglInternalDestroyStreamFrames(EGLDisplayImpl* walkerDpy, EGLStreamImpl* stream)
+{
+	if (stream->frames)
+	{
+		for (EGLint i = 0; i < stream->numberFrames; i++)
+		{
+			__destroyTexturePixmap(walkerDpy, &stream->frames[i].nativeSurfaceContainer);
+		}
 
-						__deleteContext(walkerDpy, &deleteCtxList->nativeContextContainer);
+		delete[] stream->frames;
+		stream->frames = 0;
+	}
 
-						free(deleteCtxList);
-					}
+	if (stream->queue)
+	{
+		delete[] stream->queue;
+		stream->queue = 0;
+	}
 
-					free(deleteCtx);
-				}
+	stream->numberFrames = 0;
+	stream->producerFrame = -1;
+	stream->consumerFrame = -1;
+}
 
-				tempCtx = walkerCtx;
+//
+// Context pool. Native contexts are created in advance, so the first eglMakeCurrent of a context does not create one.
+//
 
-				if (walkerCtx)
-				{
-					walkerCtx = walkerCtx->next;
-				}
-			}
+static void _eglInternalContextPoolThread(EGLDisplayImpl* walkerDpy, EGLContextPoolImpl* pool)
+{
+	unique_object_guard_t poolLock{ pool->mutex };
 
-			if (walkerDpy->destroy)
-			{
-				if (walkerDpy->rootSurface == 0 && walkerDpy->rootCtx == 0 && walkerDpy->currentDraw == EGL_NO_SURFACE && walkerDpy->currentRead == EGL_NO_SURFACE && walkerDpy->currentCtx == EGL_NO_CONTEXT)
-				{
-					EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+	while (true)
+	{
+		pool->condition.wait(poolLock, [pool] { return pool->quit || pool->rootRequest; });
 
-					EGLConfigImpl* deleteConfig;
+		if (pool->quit)
+		{
+			break;
+		}
 
-					while (walkerConfig)
-					{
-						deleteConfig = walkerConfig;
+		EGLPooledContextImpl* request = pool->rootRequest;
 
-						walkerConfig = walkerConfig->next;
+		pool->rootRequest = request->next;
+		pool->creating = request;
 
-						free(deleteConfig);
-					}
-					walkerDpy->rootConfig = 0;
+		poolLock.unlock();
 
-					//
+		const EGLBoolean created = __createPooledContext(&request->nativeContextContainer, walkerDpy, request->config, request->surfaceType, request->sharedCtxList ? &request->sharedCtxList->nativeContextContainer : 0, request->attribList);
 
-					EGLDisplayImpl* deleteDpy = walkerDpy;
+		poolLock.lock();
 
-					if (tempDpy == 0)
-					{
-						g_globalStorage.rootDpy = deleteDpy->next;
+		pool->creating = 0;
 
-						walkerDpy = g_globalStorage.rootDpy;
-					}
-					else
-					{
-						tempDpy->next = deleteDpy->next;
+		if (created)
+		{
+			request->next = pool->rootPooledCtx;
+			pool->rootPooledCtx = request;
+		}
+		else
+		{
+			free(request);
+		}
 
-						walkerDpy = tempDpy;
-					}
+		pool->condition.notify_all();
+	}
+}
 
-					delete deleteDpy;
-				}
-			}
+static EGLContextPoolImpl* _eglInternalStartContextPool(EGLDisplayImpl* walkerDpy)
+{
+	if (!walkerDpy->contextPool)
+	{
+		EGLContextPoolImpl* pool = new EGLContextPoolImpl();
 
-			tempDpy = walkerDpy;
+		pool->quit = EGL_FALSE;
+		pool->rootRequest = 0;
+		pool->creating = 0;
+		pool->rootPooledCtx = 0;
+		pool->thread = std::thread(_eglInternalContextPoolThread, walkerDpy, pool);
 
-			if (walkerDpy)
-			{
-				walkerDpy = walkerDpy->next;
-			}
-		}
+		walkerDpy->contextPool = pool;
 	}
 
-	if (!g_globalStorage.rootDpy)
-	{
-		_eglInternalTerminate();
-	}
+	return walkerDpy->contextPool;
 }
 
-void _eglInternalSetDefaultConfig(EGLConfigImpl* config)
+// Removes the requests and native contexts, which are shared with the native context, before it is deleted. All, if it is zero.
+static void _eglInternalPurgeContextPool(EGLDisplayImpl* walkerDpy, const EGLContextListImpl* sharedCtxList)
 {
-	if (!config)
+	EGLContextPoolImpl* pool = walkerDpy->contextPool;
+
+	if (!pool)
 	{
 		return;
 	}
 
-	config->alphaSize = 0;
-	config->alphaMaskSize = 0;
-
-	config->bindToTextureRGB = EGL_DONT_CARE;
-	config->bindToTextureRGBA = EGL_DONT_CARE;
-	config->blueSize = 0;
-	config->bufferSize = 0;
-
-	config->colorBufferType = EGL_DONT_CARE;
-	config->configCaveat = EGL_DONT_CARE;
-	config->configId = EGL_DONT_CARE;
-	config->conformant = 0;
-
-	config->depthSize = 0;
-
-	config->greenSize = 0;
+	unique_object_guard_t poolLock{ pool->mutex };
 
-	config->level = 0;
-	config->luminanceSize = 0;
+	pool->condition.wait(poolLock, [pool, sharedCtxList] { return !pool->creating || (sharedCtxList && pool->creating->sharedCtxList != sharedCtxList); });
 
-	config->matchNativePixmap = EGL_NONE;
-	config->maxPBufferHeight = EGL_DONT_CARE;
-	config->maxPBufferPixels = EGL_DONT_CARE;
-	config->maxPBufferWidth = EGL_DONT_CARE;
-	config->maxSwapInterval = EGL_DONT_CARE;
-	config->minSwapInterval = EGL_DONT_CARE;
+	// Only the pooled contexts have a native context.
+	EGLPooledContextImpl** rootList[] = { &pool->rootRequest, &pool->rootPooledCtx };
 
-	config->nativeRenderable = EGL_DONT_CARE;
-	config->nativeVisualId = 0;
-	config->nativeVisualType = EGL_NONE;
+	for (EGLint listIndex = 0; listIndex < 2; listIndex++)
+	{
+		EGLPooledContextImpl** walkerPooledCtx = rootList[listIndex];
 
-	config->redSize = 0;
-	config->renderableType = EGL_OPENGL_ES_BIT;
+		while (*walkerPooledCtx)
+		{
+			EGLPooledContextImpl* deletePooledCtx = *walkerPooledCtx;
 
-	config->sampleBuffers = 0;
-	config->samples = 0;
-	config->stencilSize = 0;
-	config->surfaceType = EGL_WINDOW_BIT;
+			if (sharedCtxList && deletePooledCtx->sharedCtxList != sharedCtxList)
+			{
+				walkerPooledCtx = &deletePooledCtx->next;
 
-	config->transparentBlueValue = EGL_DONT_CARE;
-	config->transparentGreenValue = EGL_DONT_CARE;
-	config->transparentRedValue = EGL_DONT_CARE;
-	config->transparentType = EGL_NONE;
+				continue;
+			}
 
-	//
+			*walkerPooledCtx = deletePooledCtx->next;
 
-	config->drawToWindow = EGL_TRUE;
-	config->drawToPixmap = EGL_FALSE;
-	config->drawToPBuffer = EGL_FALSE;
-	config->doubleBuffer = EGL_TRUE;
+			if (listIndex == 1)
+			{
+				__deleteContext(walkerDpy, &deletePooledCtx->nativeContextContainer);
+			}
 
-	config->next = 0;
+			free(deletePooledCtx);
+		}
+	}
 }
 
-static void _eglInternalSetDontCareConfig(EGLConfigImpl* config)
+static void _eglInternalStopContextPool(EGLDisplayImpl* walkerDpy)
 {
-	if (!config)
+	EGLContextPoolImpl* pool = walkerDpy->contextPool;
+
+	if (!pool)
 	{
 		return;
 	}
 
-	// Set default values
+	{
+		object_guard_t _{ pool->mutex };
 
-	config->alphaSize = EGL_DONT_CARE;
-	config->alphaMaskSize = EGL_DONT_CARE;
+		pool->quit = EGL_TRUE;
 
-	config->bindToTextureRGB = EGL_DONT_CARE;
-	config->bindToTextureRGBA = EGL_DONT_CARE;
-	config->blueSize = EGL_DONT_CARE;
-	config->bufferSize = EGL_DONT_CARE;
+		pool->condition.notify_all();
+	}
 
-	config->colorBufferType = EGL_RGB_BUFFER;
-	config->configCaveat = EGL_DONT_CARE;
-	config->configId = EGL_DONT_CARE;
-	config->conformant = EGL_DONT_CARE;
+	pool->thread.join();
 
-	config->depthSize = EGL_DONT_CARE;
+	_eglInternalPurgeContextPool(walkerDpy, 0);
 
-	config->greenSize = EGL_DONT_CARE;
+	delete pool;
 
-	config->level = EGL_DONT_CARE;
-	config->luminanceSize = EGL_DONT_CARE;
+	walkerDpy->contextPool = 0;
+}
 
-	config->matchNativePixmap = EGL_DONT_CARE;
-	config->maxPBufferHeight = EGL_DONT_CARE;
-	config->maxPBufferPixels = EGL_DONT_CARE;
-	config->maxPBufferWidth = EGL_DONT_CARE;
-	config->maxSwapInterval = EGL_DONT_CARE;
-	config->minSwapInterval = EGL_DONT_CARE;
+// Takes a native context of the pool, which was created for the FBConfig of the surface, the attributes and the share group.
+static EGLBoolean _eglInternalTakePooledContext(EGLDisplayImpl* walkerDpy, const EGLint* attribList, const EGLContextListImpl* sharedCtxList, const NativeSurfaceContainer* nativeSurfaceContainer, NativeContextContainer* nativeContextContainer)
+{
+	EGLContextPoolImpl* pool = walkerDpy->contextPool;
 
-	config->nativeRenderable = EGL_DONT_CARE;
-	config->nativeVisualId = EGL_DONT_CARE;
-	config->nativeVisualType = EGL_DONT_CARE;
+	if (!pool)
+	{
+		return EGL_FALSE;
+	}
 
-	config->redSize = EGL_DONT_CARE;
-	config->renderableType = EGL_DONT_CARE;
+	object_guard_t _{ pool->mutex };
 
-	config->sampleBuffers = EGL_DONT_CARE;
-	config->samples = EGL_DONT_CARE;
-	config->stencilSize = EGL_DONT_CARE;
-	config->surfaceType = EGL_WINDOW_BIT;
+	EGLPooledContextImpl** walkerPooledCtx = &pool->rootPooledCtx;
 
-	config->transparentBlueValue = EGL_DONT_CARE;
-	config->transparentGreenValue = EGL_DONT_CARE;
-	config->transparentRedValue = EGL_DONT_CARE;
-	config->transparentType = EGL_DONT_CARE;
+	while (*walkerPooledCtx)
+	{
+		EGLPooledContextImpl* pooledCtx = *walkerPooledCtx;
 
-	// Following parameters always do care.
+		if (pooledCtx->sharedCtxList == sharedCtxList && memcmp(pooledCtx->attribList, attribList, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint)) == 0 && __pooledContextMatches(&pooledCtx->nativeContextContainer, nativeSurfaceContainer))
+		{
+			*walkerPooledCtx = pooledCtx->next;
 
-	config->drawToWindow = EGL_TRUE;
-	config->drawToPixmap = EGL_FALSE;
-	config->drawToPBuffer = EGL_FALSE;
+			*nativeContextContainer = pooledCtx->nativeContextContainer;
 
-	config->doubleBuffer = EGL_TRUE;
+			free(pooledCtx);
 
-	config->next = 0;
+			return EGL_TRUE;
+		}
+
+		walkerPooledCtx = &pooledCtx->next;
+	}
+
+	return EGL_FALSE;
 }
 
 //
-// EGL_VERSION_1_0
+// Virtual contexts. Contexts of a config and the same attributes use the native contexts of one host. The state, which
+// the wrapped entry points track, is saved and restored, when another virtual context uses a native context.
 //
 
-static int _ChooseConfig_sort_predicate(const void* _lhs, const void* _rhs)
-{
-	const EGLConfigImpl* lhs = *(const EGLConfigImpl**)_lhs;
-	const EGLConfigImpl* rhs = *(const EGLConfigImpl**)_rhs;
+static const GLenum g_virtualBufferTargets[_EGL_VIRTUAL_BUFFER_TARGETS] = { GL_ARRAY_BUFFER, GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_UNIFORM_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER };
 
-	if (lhs->configCaveat == rhs->configCaveat)
+static const GLenum g_virtualTextureTargets[_EGL_VIRTUAL_TEXTURE_TARGETS] = { GL_TEXTURE_2D, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY };
+
+// Dithering and multisampling are enabled by default.
+static const GLenum g_virtualCapabilities[] = { GL_DITHER, GL_MULTISAMPLE, GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_STENCIL_TEST, GL_POLYGON_OFFSET_FILL, GL_SAMPLE_ALPHA_TO_COVERAGE, GL_RASTERIZER_DISCARD };
+static const GLuint g_virtualDefaultCapabilities = 0x3;
+
+static EGLint _eglInternalFindVirtualIndex(const GLenum* targets, EGLint numberTargets, GLenum target)
+{
+	for (EGLint i = 0; i < numberTargets; i++)
 	{
-		if (lhs->colorBufferType == rhs->colorBufferType)
+		if (targets[i] == target)
 		{
-			EGLint color_bits[2] = { 0, 0 };
-			switch (lhs->colorBufferType)
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void _eglInternalSetDefaultVirtualState(EGLVirtualStateImpl* state)
+{
+	memset(state, 0, sizeof(EGLVirtualStateImpl));
+
+	state->activeTexture = GL_TEXTURE0;
+
+	state->capabilities = g_virtualDefaultCapabilities;
+
+	state->clearDepth = 1.0;
+
+	state->blendSrcRGB = GL_ONE;
+	state->blendDstRGB = GL_ZERO;
+	state->blendSrcAlpha = GL_ONE;
+	state->blendDstAlpha = GL_ZERO;
+	state->blendEquationRGB = GL_FUNC_ADD;
+	state->blendEquationAlpha = GL_FUNC_ADD;
+
+	for (EGLint i = 0; i < 2; i++)
+	{
+		state->stencilFunc[i] = GL_ALWAYS;
+		state->stencilValueMask[i] = ~0u;
+		state->stencilFail[i] = GL_KEEP;
+		state->stencilDepthFail[i] = GL_KEEP;
+		state->stencilDepthPass[i] = GL_KEEP;
+		state->stencilWriteMask[i] = ~0u;
+	}
+
+	state->depthFunc = GL_LESS;
+	state->depthMask = GL_TRUE;
+	state->depthRange[1] = 1.0;
+	for (EGLint i = 0; i < 4; i++)
+	{
+		state->colorMask[i] = GL_TRUE;
+	}
+	state->cullFace = GL_BACK;
+	state->frontFace = GL_CCW;
+
+	state->packAlignment = 4;
+	state->unpackAlignment = 4;
+}
+
+// Sets the values of state, which differ from the applied ones, in the current native context.
+static void _eglInternalApplyVirtualState(EGLVirtualStateImpl* applied, const EGLVirtualStateImpl* state)
+{
+	if (applied->program != state->program)
+	{
+		glUseProgram_NATIVE(state->program);
+	}
+	if (applied->vertexArray != state->vertexArray)
+	{
+		glBindVertexArray_NATIVE(state->vertexArray);
+	}
+	if (applied->drawFramebuffer != state->drawFramebuffer)
+	{
+		glBindFramebuffer_NATIVE(GL_DRAW_FRAMEBUFFER, state->drawFramebuffer);
+	}
+	if (applied->readFramebuffer != state->readFramebuffer)
+	{
+		glBindFramebuffer_NATIVE(GL_READ_FRAMEBUFFER, state->readFramebuffer);
+	}
+	if (applied->renderbuffer != state->renderbuffer)
+	{
+		glBindRenderbuffer_NATIVE(GL_RENDERBUFFER, state->renderbuffer);
+	}
+	// An indexed binding also changes the generic binding of the target.
+	EGLBoolean uniformBufferBound = EGL_FALSE;
+	for (EGLint i = 0; i < _EGL_VIRTUAL_UNIFORM_BUFFERS; i++)
+	{
+		if (applied->uniformBuffers[i] == state->uniformBuffers[i] && applied->uniformBufferOffsets[i] == state->uniformBufferOffsets[i] && applied->uniformBufferSizes[i] == state->uniformBufferSizes[i])
+		{
+			continue;
+		}
+
+		if (state->uniformBufferSizes[i])
+		{
+			glBindBufferRange_NATIVE(GL_UNIFORM_BUFFER, (GLuint)i, state->uniformBuffers[i], state->uniformBufferOffsets[i], state->uniformBufferSizes[i]);
+		}
+		else
+		{
+			glBindBufferBase_NATIVE(GL_UNIFORM_BUFFER, (GLuint)i, state->uniformBuffers[i]);
+		}
+
+		uniformBufferBound = EGL_TRUE;
+	}
+	for (EGLint i = 0; i < _EGL_VIRTUAL_BUFFER_TARGETS; i++)
+	{
+		if (applied->buffers[i] != state->buffers[i] || (uniformBufferBound && g_virtualBufferTargets[i] == GL_UNIFORM_BUFFER))
+		{
+			glBindBuffer_NATIVE(g_virtualBufferTargets[i], state->buffers[i]);
+		}
+	}
+
+	GLenum activeTexture = applied->activeTexture;
+	for (EGLint unit = 0; unit < _EGL_VIRTUAL_TEXTURE_UNITS; unit++)
+	{
+		for (EGLint i = 0; i < _EGL_VIRTUAL_TEXTURE_TARGETS; i++)
+		{
+			if (applied->textures[unit][i] == state->textures[unit][i])
 			{
-			case EGL_RGB_BUFFER:
-				color_bits[0] = lhs->redSize + lhs->greenSize + lhs->blueSize + lhs->alphaSize;
-				color_bits[1] = rhs->redSize + rhs->greenSize + rhs->blueSize + rhs->alphaSize;
-				break;
-			case EGL_LUMINANCE_BUFFER:
-				color_bits[0] = lhs->luminanceSize + lhs->alphaSize;
-				color_bits[1] = rhs->luminanceSize + rhs->alphaSize;
-				break;
-			default:
-				break;
+				continue;
 			}
 
-			if (color_bits[0] == color_bits[1])
+			if (activeTexture != (GLenum)(GL_TEXTURE0 + unit))
 			{
-				if (lhs->bufferSize == rhs->bufferSize)
-				{
-					if (lhs->sampleBuffers == rhs->sampleBuffers)
-					{
-						if (lhs->samples == rhs->samples)
-						{
-							if (lhs->depthSize == rhs->depthSize)
-							{
-								if (lhs->stencilSize == rhs->stencilSize)
-								{
-									if (lhs->alphaMaskSize == rhs->alphaMaskSize)
-									{
-										// skip rule 10 since it's impl-defined
-										// 10. Special: EGL_NATIVE_VISUAL_TYPE (the actual sort order is implementation-defined, depending on the meaning of native visual types).
+				activeTexture = (GLenum)(GL_TEXTURE0 + unit);
 
-										// 11. Smaller EGL_CONFIG_ID (guarantees a unique ordering)
-										return (lhs->configId - rhs->configId);
-									}
-									else return (lhs->alphaMaskSize - rhs->alphaMaskSize); // 9. Smaller EGL_ALPHA_MASK_SIZE
-								}
-								else return (lhs->stencilSize - rhs->stencilSize); // 8. Smaller EGL_STENCIL_SIZE
-							}
-							else return (lhs->depthSize - rhs->depthSize); // 7. Smaller EGL_DEPTH_SIZE
-						}
-						else return (lhs->samples - rhs->samples); // 6. Smaller EGL_SAMPLES
-					}
-					else return (lhs->sampleBuffers - rhs->sampleBuffers); // 5. Smaller EGL_SAMPLE_BUFFERS
-				}
-				else return (lhs->bufferSize - rhs->bufferSize); // 4. Smaller EGL_BUFFER_SIZE
+				glActiveTexture_NATIVE(activeTexture);
 			}
-			else return color_bits[1] - color_bits[0]; // 3. by larger total number of color bits
+
+			glBindTexture_NATIVE(g_virtualTextureTargets[i], state->textures[unit][i]);
 		}
-		else return (lhs->colorBufferType - rhs->colorBufferType); // 2. by EGL_COLOR_BUFFER_TYPE
 	}
-	else return (lhs->configCaveat - rhs->configCaveat); // 1. by EGL_CONFIG_CAVEAT
-}
+	if (activeTexture != state->activeTexture)
+	{
+		glActiveTexture_NATIVE(state->activeTexture);
+	}
 
-EGLBoolean _eglChooseConfig(EGLDisplay dpy, const EGLint *attrib_list, EGLConfig *configs, EGLint config_size, EGLint *num_config)
-{
-	if (!attrib_list)
+	if (memcmp(applied->viewport, state->viewport, sizeof(state->viewport)) != 0)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		glViewport_NATIVE(state->viewport[0], state->viewport[1], state->viewport[2], state->viewport[3]);
+	}
+	if (memcmp(applied->scissor, state->scissor, sizeof(state->scissor)) != 0)
+	{
+		glScissor_NATIVE(state->scissor[0], state->scissor[1], state->scissor[2], state->scissor[3]);
+	}
 
-		return EGL_FALSE;
+	const GLuint changedCapabilities = applied->capabilities ^ state->capabilities;
+	for (EGLint i = 0; i < (EGLint)(sizeof(g_virtualCapabilities) / sizeof(g_virtualCapabilities[0])); i++)
+	{
+		if (changedCapabilities & (1u << i))
+		{
+			if (state->capabilities & (1u << i))
+			{
+				glEnable_NATIVE(g_virtualCapabilities[i]);
+			}
+			else
+			{
+				glDisable_NATIVE(g_virtualCapabilities[i]);
+			}
+		}
 	}
 
-	if (!configs)
+	if (memcmp(applied->clearColor, state->clearColor, sizeof(state->clearColor)) != 0)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		glClearColor_NATIVE(state->clearColor[0], state->clearColor[1], state->clearColor[2], state->clearColor[3]);
+	}
+	if (applied->clearDepth != state->clearDepth)
+	{
+		glClearDepth_NATIVE(state->clearDepth);
+	}
+	if (applied->clearStencil != state->clearStencil)
+	{
+		glClearStencil_NATIVE(state->clearStencil);
+	}
 
-		return EGL_FALSE;
+	if (applied->blendSrcRGB != state->blendSrcRGB || applied->blendDstRGB != state->blendDstRGB || applied->blendSrcAlpha != state->blendSrcAlpha || applied->blendDstAlpha != state->blendDstAlpha)
+	{
+		glBlendFuncSeparate_NATIVE(state->blendSrcRGB, state->blendDstRGB, state->blendSrcAlpha, state->blendDstAlpha);
+	}
+	if (applied->blendEquationRGB != state->blendEquationRGB || applied->blendEquationAlpha != state->blendEquationAlpha)
+	{
+		glBlendEquationSeparate_NATIVE(state->blendEquationRGB, state->blendEquationAlpha);
+	}
+	if (memcmp(applied->blendColor, state->blendColor, sizeof(state->blendColor)) != 0)
+	{
+		glBlendColor_NATIVE(state->blendColor[0], state->blendColor[1], state->blendColor[2], state->blendColor[3]);
 	}
 
-	if (config_size == 0)
+	for (EGLint i = 0; i < 2; i++)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		const GLenum face = i ? GL_BACK : GL_FRONT;
 
-		return EGL_FALSE;
+		if (applied->stencilFunc[i] != state->stencilFunc[i] || applied->stencilRef[i] != state->stencilRef[i] || applied->stencilValueMask[i] != state->stencilValueMask[i])
+		{
+			glStencilFuncSeparate_NATIVE(face, state->stencilFunc[i], state->stencilRef[i], state->stencilValueMask[i]);
+		}
+		if (applied->stencilFail[i] != state->stencilFail[i] || applied->stencilDepthFail[i] != state->stencilDepthFail[i] || applied->stencilDepthPass[i] != state->stencilDepthPass[i])
+		{
+			glStencilOpSeparate_NATIVE(face, state->stencilFail[i], state->stencilDepthFail[i], state->stencilDepthPass[i]);
+		}
+		if (applied->stencilWriteMask[i] != state->stencilWriteMask[i])
+		{
+			glStencilMaskSeparate_NATIVE(face, state->stencilWriteMask[i]);
+		}
 	}
 
-	if (!num_config)
+	if (applied->polygonOffsetFactor != state->polygonOffsetFactor || applied->polygonOffsetUnits != state->polygonOffsetUnits)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		glPolygonOffset_NATIVE(state->polygonOffsetFactor, state->polygonOffsetUnits);
+	}
 
-		return EGL_FALSE;
+	if (applied->depthFunc != state->depthFunc)
+	{
+		glDepthFunc_NATIVE(state->depthFunc);
+	}
+	if (applied->depthMask != state->depthMask)
+	{
+		glDepthMask_NATIVE(state->depthMask);
+	}
+	if (applied->depthRange[0] != state->depthRange[0] || applied->depthRange[1] != state->depthRange[1])
+	{
+		glDepthRange_NATIVE(state->depthRange[0], state->depthRange[1]);
+	}
+	if (memcmp(applied->colorMask, state->colorMask, sizeof(state->colorMask)) != 0)
+	{
+		glColorMask_NATIVE(state->colorMask[0], state->colorMask[1], state->colorMask[2], state->colorMask[3]);
+	}
+	if (applied->cullFace != state->cullFace)
+	{
+		glCullFace_NATIVE(state->cullFace);
+	}
+	if (applied->frontFace != state->frontFace)
+	{
+		glFrontFace_NATIVE(state->frontFace);
 	}
 
-	auto _rl = g_globalStorage.placeRootDpy_readlock();
-	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+	if (applied->packAlignment != state->packAlignment)
+	{
+		glPixelStorei_NATIVE(GL_PACK_ALIGNMENT, state->packAlignment);
+	}
+	if (applied->unpackAlignment != state->unpackAlignment)
+	{
+		glPixelStorei_NATIVE(GL_UNPACK_ALIGNMENT, state->unpackAlignment);
+	}
 
-	while (walkerDpy)
+	memcpy(applied, state, sizeof(EGLVirtualStateImpl));
+}
+
+// The native contexts of the context, which this thread did make current, are not current in any thread anymore.
+static void _eglInternalReleaseContextLists(const EGLContextImpl* walkerCtx)
+{
+	EGLContextListImpl* ctxList = walkerCtx ? walkerCtx->rootCtxList : 0;
+
+	while (ctxList)
 	{
-		if ((EGLDisplay)walkerDpy == dpy)
+		if (ctxList->currentThread == &g_localStorage)
 		{
-			guard_t _{ walkerDpy->mutex };
+			ctxList->currentThread = 0;
+		}
 
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				g_localStorage.error = EGL_NOT_INITIALIZED;
+		ctxList = ctxList->next;
+	}
+}
 
-				return EGL_FALSE;
-			}
+// A virtual context is only current, while it is the tenant of the native context.
+static EGLBoolean _eglInternalIsContextCurrent(const EGLContextImpl* walkerCtx)
+{
+	if (walkerCtx->virtualHost)
+	{
+		return walkerCtx->virtualCtxList && walkerCtx->virtualCtxList->currentThread;
+	}
 
-			EGLint attribListIndex = 0;
+	EGLContextListImpl* ctxList = walkerCtx->rootCtxList;
 
-			EGLConfigImpl config;
+	while (ctxList)
+	{
+		if (ctxList->currentThread)
+		{
+			return EGL_TRUE;
+		}
 
-			_eglInternalSetDefaultConfig(&config);
-			config.configCaveat = EGL_DONT_CARE; // dont care for this attribute since it cant be queried on both WGL and GLX
+		ctxList = ctxList->next;
+	}
 
-			while (attrib_list[attribListIndex] != EGL_NONE)
-			{
-				EGLint value = attrib_list[attribListIndex + 1];
+	return EGL_FALSE;
+}
 
-				switch (attrib_list[attribListIndex])
-				{
-					case EGL_ALPHA_MASK_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+// Moves the state of the virtual context into the native context of ctxList, which has to be current.
+static void _eglInternalActivateVirtualContext(EGLContextImpl* walkerCtx, EGLContextListImpl* ctxList, const EGLSurfaceImpl* walkerSurface)
+{
+	EGLVirtualStateImpl* applied = ctxList->virtualState;
 
-							return EGL_FALSE;
-						}
+	// A new native context got the viewport and the scissor box of the surface, it was first made current with.
+	if (!applied->sized)
+	{
+		glGetIntegerv_NATIVE(GL_VIEWPORT, applied->viewport);
+		glGetIntegerv_NATIVE(GL_SCISSOR_BOX, applied->scissor);
 
-						config.alphaMaskSize = value;
-					}
-					break;
-					case EGL_ALPHA_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		applied->sized = EGL_TRUE;
+	}
 
-							return EGL_FALSE;
-						}
+	if (walkerCtx->virtualCtxList != ctxList)
+	{
+		// Save the state of the virtual context and of the previous tenant, where they are live.
+		if (walkerCtx->virtualCtxList)
+		{
+			memcpy(walkerCtx->virtualState, walkerCtx->virtualCtxList->virtualState, sizeof(EGLVirtualStateImpl));
 
-						config.alphaSize = value;
-					}
-					break;
-					case EGL_BIND_TO_TEXTURE_RGB:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+			walkerCtx->virtualCtxList->virtualTenant = 0;
+		}
 
-							return EGL_FALSE;
-						}
+		if (ctxList->virtualTenant)
+		{
+			memcpy(ctxList->virtualTenant->virtualState, applied, sizeof(EGLVirtualStateImpl));
 
-						config.bindToTextureRGB = value;
-					}
-					break;
-					case EGL_BIND_TO_TEXTURE_RGBA:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+			ctxList->virtualTenant->virtualCtxList = 0;
+		}
 
-							return EGL_FALSE;
-						}
+		if (!walkerCtx->virtualState->sized)
+		{
+			walkerCtx->virtualState->viewport[2] = walkerSurface->width;
+			walkerCtx->virtualState->viewport[3] = walkerSurface->height;
+			memcpy(walkerCtx->virtualState->scissor, walkerCtx->virtualState->viewport, sizeof(walkerCtx->virtualState->scissor));
 
-						config.bindToTextureRGBA = value;
-					}
-					break;
-					case EGL_BLUE_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+			walkerCtx->virtualState->sized = EGL_TRUE;
+		}
 
-							return EGL_FALSE;
-						}
+		_eglInternalApplyVirtualState(applied, walkerCtx->virtualState);
 
-						config.blueSize = value;
-					}
-					break;
-					case EGL_BUFFER_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		ctxList->virtualTenant = walkerCtx;
+		walkerCtx->virtualCtxList = ctxList;
+	}
 
-							return EGL_FALSE;
-						}
+	g_localStorage.virtualState = applied;
+}
 
-						config.bufferSize = value;
-					}
-					break;
-					case EGL_COLOR_BUFFER_TYPE:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_RGB_BUFFER && value != EGL_LUMINANCE_BUFFER)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+// Returns a copy of the attribute list without the attribute, which has to be freed.
+static EGLint* _eglInternalRemoveAttrib(const EGLint* attrib_list, EGLint attribute)
+{
+	EGLint numberAttribs = 0;
 
-							return EGL_FALSE;
-						}
+	while (attrib_list[numberAttribs] != EGL_NONE)
+	{
+		numberAttribs += 2;
+	}
 
-						config.colorBufferType = value;
-					}
-					break;
-					case EGL_CONFIG_CAVEAT:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_NONE && value != EGL_SLOW_CONFIG && value != EGL_NON_CONFORMANT_CONFIG)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	EGLint* target_attrib_list = (EGLint*)malloc((numberAttribs + 1) * sizeof(EGLint));
 
-							return EGL_FALSE;
-						}
+	if (!target_attrib_list)
+	{
+		return 0;
+	}
 
-						config.configCaveat = value;
-					}
-					break;
-					case EGL_CONFIG_ID:
-					{
-						config.configId = value;
-					}
-					break;
-					case EGL_CONFORMANT:
-					{
-						if (value != EGL_DONT_CARE && value & ~(EGL_OPENGL_BIT | EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT | EGL_OPENVG_BIT))
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	EGLint targetIndex = 0;
 
-							return EGL_FALSE;
-						}
+	for (EGLint i = 0; i < numberAttribs; i += 2)
+	{
+		if (attrib_list[i] != attribute)
+		{
+			target_attrib_list[targetIndex++] = attrib_list[i];
+			target_attrib_list[targetIndex++] = attrib_list[i + 1];
+		}
+	}
 
-						config.conformant = value;
-					}
-					break;
-					case EGL_DEPTH_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	target_attrib_list[targetIndex] = EGL_NONE;
 
-							return EGL_FALSE;
-						}
+	return target_attrib_list;
+}
 
-						config.depthSize = value;
-					}
-					break;
-					case EGL_GREEN_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+// Returns the host of the config and the attributes, which is created, if it does not exist.
+static EGLVirtualHostImpl* _eglInternalAcquireVirtualHost(EGLDisplayImpl* walkerDpy, EGLint configId, const EGLint* attribList)
+{
+	EGLVirtualHostImpl* walkerHost = walkerDpy->rootVirtualHost;
 
-							return EGL_FALSE;
-						}
+	while (walkerHost)
+	{
+		if (walkerHost->configId == configId && memcmp(walkerHost->attribList, attribList, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint)) == 0)
+		{
+			walkerHost->tenants++;
 
-						config.greenSize = value;
-					}
-					break;
-					case EGL_LEVEL:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+			return walkerHost;
+		}
 
-							return EGL_FALSE;
-						}
+		walkerHost = walkerHost->next;
+	}
 
-						config.level = value;
-					}
-					break;
-					case EGL_LUMINANCE_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	walkerHost = new EGLVirtualHostImpl();
 
-							return EGL_FALSE;
-						}
+	if (!walkerHost)
+	{
+		return 0;
+	}
 
-						config.luminanceSize = value;
-					}
-					break;
-					case EGL_MATCH_NATIVE_PIXMAP:
-					{
-						config.matchNativePixmap = value;
-					}
-					break;
-					case EGL_NATIVE_RENDERABLE:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_TRUE && value != EGL_FALSE)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	walkerHost->configId = configId;
+	memcpy(walkerHost->attribList, attribList, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
+	walkerHost->tenants = 1;
+	walkerHost->rootCtxList = 0;
+	walkerHost->display = walkerDpy;
 
-							return EGL_FALSE;
-						}
+	walkerHost->next = walkerDpy->rootVirtualHost;
+	walkerDpy->rootVirtualHost = walkerHost;
 
-						config.nativeRenderable = value;
-					}
-					break;
-					case EGL_MAX_SWAP_INTERVAL:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	return walkerHost;
+}
 
-							return EGL_FALSE;
-						}
+// Called, before the virtual context is freed. The host and its native contexts are deleted with the last one.
+static void _eglInternalReleaseVirtualContext(EGLDisplayImpl* walkerDpy, EGLContextImpl* deleteCtx)
+{
+	EGLVirtualHostImpl* host = deleteCtx->virtualHost;
 
-						config.maxSwapInterval = value;
-					}
-					break;
-					case EGL_MIN_SWAP_INTERVAL:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	if (deleteCtx->virtualCtxList)
+	{
+		deleteCtx->virtualCtxList->virtualTenant = 0;
+	}
 
-							return EGL_FALSE;
-						}
+	free(deleteCtx->virtualState);
 
-						config.minSwapInterval = value;
-					}
-					break;
-					case EGL_RED_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	host->tenants--;
 
-							return EGL_FALSE;
-						}
+	if (host->tenants > 0)
+	{
+		return;
+	}
 
-						config.redSize = value;
-					}
-					break;
-					case EGL_SAMPLE_BUFFERS:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	EGLVirtualHostImpl** walkerHost = &walkerDpy->rootVirtualHost;
 
-							return EGL_FALSE;
-						}
+	while (*walkerHost != host)
+	{
+		walkerHost = &(*walkerHost)->next;
+	}
 
-						config.sampleBuffers = value;
-					}
-					break;
-					case EGL_SAMPLES:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	*walkerHost = host->next;
 
-							return EGL_FALSE;
-						}
+	while (host->rootCtxList)
+	{
+		EGLContextListImpl* deleteCtxList = host->rootCtxList;
 
-						config.samples = value;
-					}
-					break;
-					case EGL_STENCIL_SIZE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		host->rootCtxList = host->rootCtxList->next;
 
-							return EGL_FALSE;
-						}
+		_eglInternalPurgeContextPool(walkerDpy, deleteCtxList);
 
-						config.stencilSize = value;
-					}
-					break;
-					case EGL_RENDERABLE_TYPE:
-					{
-						if (value != EGL_DONT_CARE && value & ~(EGL_OPENGL_BIT | EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT | EGL_OPENVG_BIT))
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		__deleteContext(walkerDpy, &deleteCtxList->nativeContextContainer);
 
-							return EGL_FALSE;
-						}
+		free(deleteCtxList->virtualState);
 
-						config.renderableType = value;
-					}
-					break;
-					case EGL_SURFACE_TYPE:
-					{
-						if (value != EGL_DONT_CARE && value & ~(EGL_MULTISAMPLE_RESOLVE_BOX_BIT | EGL_PBUFFER_BIT | EGL_PIXMAP_BIT | EGL_SWAP_BEHAVIOR_PRESERVED_BIT | EGL_VG_ALPHA_FORMAT_PRE_BIT | EGL_VG_COLORSPACE_LINEAR_BIT | EGL_WINDOW_BIT))
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		free(deleteCtxList);
+	}
 
-							return EGL_FALSE;
-						}
+	delete host;
+}
 
-						config.surfaceType = value;
-					}
-					break;
-					case EGL_TRANSPARENT_TYPE:
-					{
-						if (value != EGL_DONT_CARE && value != EGL_NONE && value != EGL_TRANSPARENT_TYPE)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+// Entry points returned by eglGetProcAddress. They record the state into the current virtual context, if there is one.
 
-							return EGL_FALSE;
-						}
+static void APIENTRY _eglVirtualUseProgram(GLuint program)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->program = program;
+	}
 
-						config.transparentType = value;
-					}
-					break;
-					case EGL_TRANSPARENT_RED_VALUE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	glUseProgram_NATIVE(program);
+}
 
-							return EGL_FALSE;
-						}
+static void APIENTRY _eglVirtualBindVertexArray(GLuint array)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->vertexArray = array;
+	}
 
-						config.transparentRedValue = value;
-					}
-					break;
-					case EGL_TRANSPARENT_GREEN_VALUE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	glBindVertexArray_NATIVE(array);
+}
 
-							return EGL_FALSE;
-						}
+static void APIENTRY _eglVirtualBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
 
-						config.transparentGreenValue = value;
-					}
-					break;
-					case EGL_TRANSPARENT_BLUE_VALUE:
-					{
-						if (value != EGL_DONT_CARE && value < 0)
-						{
-							g_localStorage.error = EGL_BAD_ATTRIBUTE;
+	if (state)
+	{
+		if (target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER)
+		{
+			state->drawFramebuffer = framebuffer;
+		}
+		if (target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER)
+		{
+			state->readFramebuffer = framebuffer;
+		}
+	}
 
-							return EGL_FALSE;
-						}
+	glBindFramebuffer_NATIVE(target, framebuffer);
+}
 
-						config.transparentBlueValue = value;
-					}
-					break;
-					default:
-					{
-						g_localStorage.error = EGL_BAD_ATTRIBUTE;
+static void APIENTRY _eglVirtualBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+	if (g_localStorage.virtualState && target == GL_RENDERBUFFER)
+	{
+		g_localStorage.virtualState->renderbuffer = renderbuffer;
+	}
 
-						return EGL_FALSE;
-					}
-					break;
-				}
+	glBindRenderbuffer_NATIVE(target, renderbuffer);
+}
 
-				attribListIndex += 2;
+static void APIENTRY _eglVirtualBindBuffer(GLenum target, GLuint buffer)
+{
+	if (g_localStorage.virtualState)
+	{
+		const EGLint i = _eglInternalFindVirtualIndex(g_virtualBufferTargets, _EGL_VIRTUAL_BUFFER_TARGETS, target);
 
-				// More than 28 entries can not exist.
-				if (attribListIndex >= 28 * 2)
-				{
-					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+		if (i >= 0)
+		{
+			g_localStorage.virtualState->buffers[i] = buffer;
+		}
+	}
 
-					return EGL_FALSE;
-				}
-			}
-			config.drawToWindow = (config.surfaceType & EGL_WINDOW_BIT) ? EGL_TRUE : EGL_FALSE;
-			config.drawToPixmap = (config.surfaceType & EGL_PIXMAP_BIT) ? EGL_TRUE : EGL_FALSE;
-			config.drawToPBuffer = (config.surfaceType & EGL_PBUFFER_BIT) ? EGL_TRUE : EGL_FALSE;
+	glBindBuffer_NATIVE(target, buffer);
+}
 
-			// Check, if this configuration exists.
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+static void APIENTRY _eglVirtualBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
 
-			#define stack_mem_sz (1ull << 13) // 8k
-			char stack_mem[stack_mem_sz];
-			const EGLint max_configs = stack_mem_sz / sizeof(EGLConfig);
-			EGLConfig* configsOnStack = (EGLConfig*)stack_mem;
+	if (state)
+	{
+		const EGLint i = _eglInternalFindVirtualIndex(g_virtualBufferTargets, _EGL_VIRTUAL_BUFFER_TARGETS, target);
 
-			EGLint configIndex = 0;
+		if (i >= 0)
+		{
+			state->buffers[i] = buffer;
+		}
 
-			int itercount = 0;
-			while (walkerConfig && configIndex < max_configs)
-			{
-				++itercount;
-				if (config.alphaMaskSize > walkerConfig->alphaMaskSize)
-				{
-					walkerConfig = walkerConfig->next;
+		if (target == GL_UNIFORM_BUFFER && index < _EGL_VIRTUAL_UNIFORM_BUFFERS)
+		{
+			state->uniformBuffers[index] = buffer;
+			state->uniformBufferOffsets[index] = offset;
+			state->uniformBufferSizes[index] = size;
+		}
+	}
 
-					continue;
-				}
-				if (config.alphaSize > walkerConfig->alphaSize)
-				{
-					walkerConfig = walkerConfig->next;
+	glBindBufferRange_NATIVE(target, index, buffer, offset, size);
+}
 
-					continue;
-				}
-				if (config.bindToTextureRGB != EGL_DONT_CARE && config.bindToTextureRGB != walkerConfig->bindToTextureRGB)
-				{
-					walkerConfig = walkerConfig->next;
+static void APIENTRY _eglVirtualBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
 
-					continue;
-				}
-				if (config.bindToTextureRGBA != EGL_DONT_CARE && config.bindToTextureRGBA != walkerConfig->bindToTextureRGBA)
-				{
-					walkerConfig = walkerConfig->next;
+	if (state)
+	{
+		const EGLint i = _eglInternalFindVirtualIndex(g_virtualBufferTargets, _EGL_VIRTUAL_BUFFER_TARGETS, target);
 
-					continue;
-				}
-				if (config.blueSize > walkerConfig->blueSize)
-				{
-					walkerConfig = walkerConfig->next;
+		if (i >= 0)
+		{
+			state->buffers[i] = buffer;
+		}
 
-					continue;
-				}
-				if (config.bufferSize > walkerConfig->bufferSize)
-				{
-					walkerConfig = walkerConfig->next;
+		if (target == GL_UNIFORM_BUFFER && index < _EGL_VIRTUAL_UNIFORM_BUFFERS)
+		{
+			state->uniformBuffers[index] = buffer;
+			state->uniformBufferOffsets[index] = 0;
+			state->uniformBufferSizes[index] = 0;
+		}
+	}
 
-					continue;
-				}
-				if (config.colorBufferType != EGL_DONT_CARE && config.colorBufferType != walkerConfig->colorBufferType)
-				{
-					walkerConfig = walkerConfig->next;
+	glBindBufferBase_NATIVE(target, index, buffer);
+}
 
-					continue;
-				}
-				if (config.configCaveat != EGL_DONT_CARE && config.configCaveat != walkerConfig->configCaveat)
-				{
-					walkerConfig = walkerConfig->next;
+static void APIENTRY _eglVirtualActiveTexture(GLenum texture)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->activeTexture = texture;
+	}
 
-					continue;
-				}
-				if (config.configId != EGL_DONT_CARE && config.configId != walkerConfig->configId)
-				{
-					walkerConfig = walkerConfig->next;
+	glActiveTexture_NATIVE(texture);
+}
 
-					continue;
-				}
-				if ((config.conformant & walkerConfig->conformant) != config.conformant)
-				{
-					walkerConfig = walkerConfig->next;
+static void APIENTRY _eglVirtualBindTexture(GLenum target, GLuint texture)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
 
-					continue;
-				}
-				if (config.depthSize > walkerConfig->depthSize)
-				{
-					walkerConfig = walkerConfig->next;
+	if (state)
+	{
+		const EGLint unit = (EGLint)(state->activeTexture - GL_TEXTURE0);
+		const EGLint i = _eglInternalFindVirtualIndex(g_virtualTextureTargets, _EGL_VIRTUAL_TEXTURE_TARGETS, target);
 
-					continue;
-				}
-				if (config.greenSize > walkerConfig->greenSize)
-				{
-					walkerConfig = walkerConfig->next;
+		if (unit >= 0 && unit < _EGL_VIRTUAL_TEXTURE_UNITS && i >= 0)
+		{
+			state->textures[unit][i] = texture;
+		}
+	}
 
-					continue;
-				}
-				if (config.level != walkerConfig->level)
-				{
-					walkerConfig = walkerConfig->next;
+	glBindTexture_NATIVE(target, texture);
+}
 
-					continue;
-				}
-				if (config.luminanceSize > walkerConfig->luminanceSize)
-				{
-					walkerConfig = walkerConfig->next;
+static void APIENTRY _eglVirtualViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
 
-					continue;
-				}
-				if (config.matchNativePixmap != EGL_NONE && config.matchNativePixmap != walkerConfig->matchNativePixmap)
-				{
-					walkerConfig = walkerConfig->next;
+	if (state)
+	{
+		state->viewport[0] = x;
+		state->viewport[1] = y;
+		state->viewport[2] = width;
+		state->viewport[3] = height;
+	}
 
-					continue;
+	glViewport_NATIVE(x, y, width, height);
+}
+
+static void APIENTRY _eglVirtualScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->scissor[0] = x;
+		state->scissor[1] = y;
+		state->scissor[2] = width;
+		state->scissor[3] = height;
+	}
+
+	glScissor_NATIVE(x, y, width, height);
+}
+
+static void APIENTRY _eglVirtualEnable(GLenum cap)
+{
+	if (g_localStorage.virtualState)
+	{
+		const EGLint i = _eglInternalFindVirtualIndex(g_virtualCapabilities, (EGLint)(sizeof(g_virtualCapabilities) / sizeof(g_virtualCapabilities[0])), cap);
+
+		if (i >= 0)
+		{
+			g_localStorage.virtualState->capabilities |= (1u << i);
+		}
+	}
+
+	glEnable_NATIVE(cap);
+}
+
+static void APIENTRY _eglVirtualDisable(GLenum cap)
+{
+	if (g_localStorage.virtualState)
+	{
+		const EGLint i = _eglInternalFindVirtualIndex(g_virtualCapabilities, (EGLint)(sizeof(g_virtualCapabilities) / sizeof(g_virtualCapabilities[0])), cap);
+
+		if (i >= 0)
+		{
+			g_localStorage.virtualState->capabilities &= ~(1u << i);
+		}
+	}
+
+	glDisable_NATIVE(cap);
+}
+
+static void APIENTRY _eglVirtualClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->clearColor[0] = red;
+		state->clearColor[1] = green;
+		state->clearColor[2] = blue;
+		state->clearColor[3] = alpha;
+	}
+
+	glClearColor_NATIVE(red, green, blue, alpha);
+}
+
+static void APIENTRY _eglVirtualClearDepth(double depth)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->clearDepth = depth;
+	}
+
+	glClearDepth_NATIVE(depth);
+}
+
+static void APIENTRY _eglVirtualClearStencil(GLint s)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->clearStencil = s;
+	}
+
+	glClearStencil_NATIVE(s);
+}
+
+static void APIENTRY _eglVirtualBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->blendSrcRGB = srcRGB;
+		state->blendDstRGB = dstRGB;
+		state->blendSrcAlpha = srcAlpha;
+		state->blendDstAlpha = dstAlpha;
+	}
+
+	glBlendFuncSeparate_NATIVE(srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+static void APIENTRY _eglVirtualBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->blendSrcRGB = sfactor;
+		state->blendDstRGB = dfactor;
+		state->blendSrcAlpha = sfactor;
+		state->blendDstAlpha = dfactor;
+	}
+
+	glBlendFunc_NATIVE(sfactor, dfactor);
+}
+
+static void APIENTRY _eglVirtualBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->blendEquationRGB = modeRGB;
+		state->blendEquationAlpha = modeAlpha;
+	}
+
+	glBlendEquationSeparate_NATIVE(modeRGB, modeAlpha);
+}
+
+static void APIENTRY _eglVirtualBlendEquation(GLenum mode)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->blendEquationRGB = mode;
+		state->blendEquationAlpha = mode;
+	}
+
+	glBlendEquation_NATIVE(mode);
+}
+
+static void APIENTRY _eglVirtualBlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->blendColor[0] = red;
+		state->blendColor[1] = green;
+		state->blendColor[2] = blue;
+		state->blendColor[3] = alpha;
+	}
+
+	glBlendColor_NATIVE(red, green, blue, alpha);
+}
+
+// Index 0 is the front face, index 1 the back face.
+static EGLBoolean _eglInternalVirtualFace(GLenum face, EGLint i)
+{
+	return (i == 0 && face != GL_BACK) || (i == 1 && face != GL_FRONT);
+}
+
+static void APIENTRY _eglVirtualStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	for (EGLint i = 0; state && i < 2; i++)
+	{
+		if (_eglInternalVirtualFace(face, i))
+		{
+			state->stencilFunc[i] = func;
+			state->stencilRef[i] = ref;
+			state->stencilValueMask[i] = mask;
+		}
+	}
+
+	glStencilFuncSeparate_NATIVE(face, func, ref, mask);
+}
+
+static void APIENTRY _eglVirtualStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	for (EGLint i = 0; state && i < 2; i++)
+	{
+		state->stencilFunc[i] = func;
+		state->stencilRef[i] = ref;
+		state->stencilValueMask[i] = mask;
+	}
+
+	glStencilFunc_NATIVE(func, ref, mask);
+}
+
+static void APIENTRY _eglVirtualStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	for (EGLint i = 0; state && i < 2; i++)
+	{
+		if (_eglInternalVirtualFace(face, i))
+		{
+			state->stencilFail[i] = sfail;
+			state->stencilDepthFail[i] = dpfail;
+			state->stencilDepthPass[i] = dppass;
+		}
+	}
+
+	glStencilOpSeparate_NATIVE(face, sfail, dpfail, dppass);
+}
+
+static void APIENTRY _eglVirtualStencilOp(GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	for (EGLint i = 0; state && i < 2; i++)
+	{
+		state->stencilFail[i] = sfail;
+		state->stencilDepthFail[i] = dpfail;
+		state->stencilDepthPass[i] = dppass;
+	}
+
+	glStencilOp_NATIVE(sfail, dpfail, dppass);
+}
+
+static void APIENTRY _eglVirtualStencilMaskSeparate(GLenum face, GLuint mask)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	for (EGLint i = 0; state && i < 2; i++)
+	{
+		if (_eglInternalVirtualFace(face, i))
+		{
+			state->stencilWriteMask[i] = mask;
+		}
+	}
+
+	glStencilMaskSeparate_NATIVE(face, mask);
+}
+
+static void APIENTRY _eglVirtualStencilMask(GLuint mask)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	for (EGLint i = 0; state && i < 2; i++)
+	{
+		state->stencilWriteMask[i] = mask;
+	}
+
+	glStencilMask_NATIVE(mask);
+}
+
+static void APIENTRY _eglVirtualPolygonOffset(GLfloat factor, GLfloat units)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->polygonOffsetFactor = factor;
+		state->polygonOffsetUnits = units;
+	}
+
+	glPolygonOffset_NATIVE(factor, units);
+}
+
+static void APIENTRY _eglVirtualDepthRange(double nearVal, double farVal)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->depthRange[0] = nearVal;
+		state->depthRange[1] = farVal;
+	}
+
+	glDepthRange_NATIVE(nearVal, farVal);
+}
+
+static void APIENTRY _eglVirtualDepthFunc(GLenum func)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->depthFunc = func;
+	}
+
+	glDepthFunc_NATIVE(func);
+}
+
+static void APIENTRY _eglVirtualDepthMask(GLboolean flag)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->depthMask = flag;
+	}
+
+	glDepthMask_NATIVE(flag);
+}
+
+static void APIENTRY _eglVirtualColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		state->colorMask[0] = red;
+		state->colorMask[1] = green;
+		state->colorMask[2] = blue;
+		state->colorMask[3] = alpha;
+	}
+
+	glColorMask_NATIVE(red, green, blue, alpha);
+}
+
+static void APIENTRY _eglVirtualCullFace(GLenum mode)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->cullFace = mode;
+	}
+
+	glCullFace_NATIVE(mode);
+}
+
+static void APIENTRY _eglVirtualFrontFace(GLenum mode)
+{
+	if (g_localStorage.virtualState)
+	{
+		g_localStorage.virtualState->frontFace = mode;
+	}
+
+	glFrontFace_NATIVE(mode);
+}
+
+static void APIENTRY _eglVirtualPixelStorei(GLenum pname, GLint param)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state)
+	{
+		if (pname == GL_PACK_ALIGNMENT)
+		{
+			state->packAlignment = param;
+		}
+		else if (pname == GL_UNPACK_ALIGNMENT)
+		{
+			state->unpackAlignment = param;
+		}
+	}
+
+	glPixelStorei_NATIVE(pname, param);
+}
+
+// Replace the bindings of the deleted objects in a state by the given name.
+
+static void _eglInternalForgetPrograms(EGLVirtualStateImpl* state, GLsizei n, const GLuint* programs, GLuint unbound)
+{
+	for (GLsizei k = 0; k < n; k++)
+	{
+		if (programs[k] && state->program == programs[k])
+		{
+			state->program = unbound;
+		}
+	}
+}
+
+static void _eglInternalForgetRenderbuffers(EGLVirtualStateImpl* state, GLsizei n, const GLuint* renderbuffers, GLuint unbound)
+{
+	for (GLsizei k = 0; k < n; k++)
+	{
+		if (renderbuffers[k] && state->renderbuffer == renderbuffers[k])
+		{
+			state->renderbuffer = unbound;
+		}
+	}
+}
+
+static void _eglInternalForgetBuffers(EGLVirtualStateImpl* state, GLsizei n, const GLuint* buffers, GLuint unbound)
+{
+	for (GLsizei k = 0; k < n; k++)
+	{
+		if (!buffers[k])
+		{
+			continue;
+		}
+
+		for (EGLint i = 0; i < _EGL_VIRTUAL_BUFFER_TARGETS; i++)
+		{
+			if (state->buffers[i] == buffers[k])
+			{
+				state->buffers[i] = unbound;
+			}
+		}
+
+		for (EGLint i = 0; i < _EGL_VIRTUAL_UNIFORM_BUFFERS; i++)
+		{
+			if (state->uniformBuffers[i] == buffers[k])
+			{
+				state->uniformBuffers[i] = unbound;
+				state->uniformBufferOffsets[i] = 0;
+				state->uniformBufferSizes[i] = 0;
+			}
+		}
+	}
+}
+
+static void _eglInternalForgetTextures(EGLVirtualStateImpl* state, GLsizei n, const GLuint* textures, GLuint unbound)
+{
+	for (GLsizei k = 0; k < n; k++)
+	{
+		for (EGLint unit = 0; textures[k] && unit < _EGL_VIRTUAL_TEXTURE_UNITS; unit++)
+		{
+			for (EGLint i = 0; i < _EGL_VIRTUAL_TEXTURE_TARGETS; i++)
+			{
+				if (state->textures[unit][i] == textures[k])
+				{
+					state->textures[unit][i] = unbound;
+				}
+			}
+		}
+	}
+}
+
+// Deleting a shared object frees its name, so the other tenants of the host must not bind the name again. The saved states
+// are cleared and the bindings of the idle native contexts are marked unknown, so they are made again with the next tenant.
+// A tenant, which is current in another thread, keeps the deleted object bound like a native context does.
+static void _eglInternalForgetVirtualObjects(GLsizei n, const GLuint* names, void (*forget)(EGLVirtualStateImpl*, GLsizei, const GLuint*, GLuint))
+{
+	const EGLContextImpl* currentCtx = g_localStorage.currentCtx;
+
+	if (!currentCtx || !currentCtx->virtualHost)
+	{
+		return;
+	}
+
+	EGLVirtualHostImpl* host = currentCtx->virtualHost;
+	EGLDisplayImpl* walkerDpy = host->display;
+
+	shared_guard_t _{ walkerDpy->mutex };
+	object_guard_t hostLock{ host->mutex };
+
+	EGLContextListImpl* ctxList = host->rootCtxList;
+
+	while (ctxList)
+	{
+		if (!ctxList->currentThread)
+		{
+			// The state of the previous tenant is saved, so it is applied again without the deleted objects.
+			if (ctxList->virtualTenant)
+			{
+				memcpy(ctxList->virtualTenant->virtualState, ctxList->virtualState, sizeof(EGLVirtualStateImpl));
+
+				ctxList->virtualTenant->virtualCtxList = 0;
+				ctxList->virtualTenant = 0;
+			}
+
+			forget(ctxList->virtualState, n, names, _EGL_VIRTUAL_UNKNOWN_NAME);
+		}
+
+		ctxList = ctxList->next;
+	}
+
+	EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+
+	while (walkerCtx)
+	{
+		if (walkerCtx->virtualHost == host && !walkerCtx->virtualCtxList)
+		{
+			forget(walkerCtx->virtualState, n, names, 0);
+		}
+
+		walkerCtx = walkerCtx->next;
+	}
+}
+
+// Deleting an object unbinds it in the native context, so the bindings of the virtual context are cleared as well.
+
+static void APIENTRY _eglVirtualDeleteProgram(GLuint program)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state && program)
+	{
+		// The program would stay in use by the next virtual context, which uses the native context.
+		if (state->program == program)
+		{
+			state->program = 0;
+
+			glUseProgram_NATIVE(0);
+		}
+
+		_eglInternalForgetVirtualObjects(1, &program, _eglInternalForgetPrograms);
+	}
+
+	glDeleteProgram_NATIVE(program);
+}
+
+static void APIENTRY _eglVirtualDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	for (GLsizei k = 0; state && arrays && k < n; k++)
+	{
+		if (arrays[k] && state->vertexArray == arrays[k])
+		{
+			state->vertexArray = 0;
+		}
+	}
+
+	glDeleteVertexArrays_NATIVE(n, arrays);
+}
+
+static void APIENTRY _eglVirtualDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	for (GLsizei k = 0; state && framebuffers && k < n; k++)
+	{
+		if (framebuffers[k] && state->drawFramebuffer == framebuffers[k])
+		{
+			state->drawFramebuffer = 0;
+		}
+		if (framebuffers[k] && state->readFramebuffer == framebuffers[k])
+		{
+			state->readFramebuffer = 0;
+		}
+	}
+
+	glDeleteFramebuffers_NATIVE(n, framebuffers);
+}
+
+static void APIENTRY _eglVirtualDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state && renderbuffers)
+	{
+		_eglInternalForgetRenderbuffers(state, n, renderbuffers, 0);
+
+		_eglInternalForgetVirtualObjects(n, renderbuffers, _eglInternalForgetRenderbuffers);
+	}
+
+	glDeleteRenderbuffers_NATIVE(n, renderbuffers);
+}
+
+static void APIENTRY _eglVirtualDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state && buffers)
+	{
+		_eglInternalForgetBuffers(state, n, buffers, 0);
+
+		_eglInternalForgetVirtualObjects(n, buffers, _eglInternalForgetBuffers);
+	}
+
+	glDeleteBuffers_NATIVE(n, buffers);
+}
+
+static void APIENTRY _eglVirtualDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	EGLVirtualStateImpl* state = g_localStorage.virtualState;
+
+	if (state && textures)
+	{
+		_eglInternalForgetTextures(state, n, textures, 0);
+
+		_eglInternalForgetVirtualObjects(n, textures, _eglInternalForgetTextures);
+	}
+
+	glDeleteTextures_NATIVE(n, textures);
+}
+
+typedef struct _EGLVirtualProcImpl
+{
+	const char* procname;
+	__eglMustCastToProperFunctionPointerType proc;
+} EGLVirtualProcImpl;
+
+#define _EGL_VIRTUAL_PROC(fname) { "gl" #fname, (__eglMustCastToProperFunctionPointerType)_eglVirtual##fname }
+
+static const EGLVirtualProcImpl g_virtualProcs[] = {
+	_EGL_VIRTUAL_PROC(UseProgram),
+	_EGL_VIRTUAL_PROC(BindVertexArray),
+	_EGL_VIRTUAL_PROC(BindFramebuffer),
+	_EGL_VIRTUAL_PROC(BindRenderbuffer),
+	_EGL_VIRTUAL_PROC(BindBuffer),
+	_EGL_VIRTUAL_PROC(BindBufferBase),
+	_EGL_VIRTUAL_PROC(BindBufferRange),
+	_EGL_VIRTUAL_PROC(ActiveTexture),
+	_EGL_VIRTUAL_PROC(BindTexture),
+	_EGL_VIRTUAL_PROC(Viewport),
+	_EGL_VIRTUAL_PROC(Scissor),
+	_EGL_VIRTUAL_PROC(Enable),
+	_EGL_VIRTUAL_PROC(Disable),
+	_EGL_VIRTUAL_PROC(ClearColor),
+	_EGL_VIRTUAL_PROC(ClearDepth),
+	_EGL_VIRTUAL_PROC(ClearStencil),
+	_EGL_VIRTUAL_PROC(BlendFunc),
+	_EGL_VIRTUAL_PROC(BlendFuncSeparate),
+	_EGL_VIRTUAL_PROC(BlendEquation),
+	_EGL_VIRTUAL_PROC(BlendEquationSeparate),
+	_EGL_VIRTUAL_PROC(BlendColor),
+	_EGL_VIRTUAL_PROC(StencilFunc),
+	_EGL_VIRTUAL_PROC(StencilFuncSeparate),
+	_EGL_VIRTUAL_PROC(StencilOp),
+	_EGL_VIRTUAL_PROC(StencilOpSeparate),
+	_EGL_VIRTUAL_PROC(StencilMask),
+	_EGL_VIRTUAL_PROC(StencilMaskSeparate),
+	_EGL_VIRTUAL_PROC(PolygonOffset),
+	_EGL_VIRTUAL_PROC(DepthFunc),
+	_EGL_VIRTUAL_PROC(DepthMask),
+	_EGL_VIRTUAL_PROC(DepthRange),
+	_EGL_VIRTUAL_PROC(ColorMask),
+	_EGL_VIRTUAL_PROC(CullFace),
+	_EGL_VIRTUAL_PROC(FrontFace),
+	_EGL_VIRTUAL_PROC(PixelStorei),
+	_EGL_VIRTUAL_PROC(DeleteProgram),
+	_EGL_VIRTUAL_PROC(DeleteVertexArrays),
+	_EGL_VIRTUAL_PROC(DeleteFramebuffers),
+	_EGL_VIRTUAL_PROC(DeleteRenderbuffers),
+	_EGL_VIRTUAL_PROC(DeleteBuffers),
+	_EGL_VIRTUAL_PROC(DeleteTextures)
+};
+
+static void _eglInternalTerminate()
+{
+	auto dummy = g_globalStorage.dummy_read();
+	__internalTerminate(&dummy);
+	g_globalStorage.dummy_write(dummy);
+}
+
+static void _eglInternalCleanup()
+{
+	EGLDisplayImpl* tempDpy = 0;
+
+	{
+		auto _wl = g_globalStorage.placeRootDpy_writelock();
+		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+		while (walkerDpy)
+		{
+			EGLSurfaceImpl* tempSurface = 0;
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			EGLContextImpl* tempCtx = 0;
+
+			EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+
+			while (walkerSurface)
+			{
+				// A producer, which waits for a frame, still uses its surface.
+				if (walkerSurface->destroy && walkerSurface != walkerDpy->currentDraw && walkerSurface != walkerDpy->currentRead && !(walkerSurface->stream && walkerSurface->stream->waiters.load()))
+				{
+					EGLSurfaceImpl* deleteSurface = walkerSurface;
+
+					if (tempSurface == 0)
+					{
+						walkerDpy->rootSurface = deleteSurface->next;
+
+						walkerSurface = walkerDpy->rootSurface;
+					}
+					else
+					{
+						tempSurface->next = deleteSurface->next;
+
+						walkerSurface = tempSurface;
+					}
+
+					if (deleteSurface->stream)
+					{
+						deleteSurface->stream->producer = 0;
+						deleteSurface->stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+					}
+
+					if (deleteSurface->readbacks)
+					{
+						free(deleteSurface->readbacks);
+					}
+
+					if (deleteSurface->convert)
+					{
+						free(deleteSurface->convert);
+					}
+
+					if (deleteSurface->clientMemory)
+					{
+						free(deleteSurface->clientMemory);
+					}
+
+					if (deleteSurface->copyImage)
+					{
+						free(deleteSurface->copyImage);
+					}
+
+					if (deleteSurface->copyRow)
+					{
+						free(deleteSurface->copyRow);
+					}
+
+					if (deleteSurface->damageRects)
+					{
+						free(deleteSurface->damageRects);
+					}
+
+					if (deleteSurface->presentRects)
+					{
+						free(deleteSurface->presentRects);
+					}
+
+					if (deleteSurface->preserve)
+					{
+						free(deleteSurface->preserve);
+					}
+
+					if (deleteSurface->frames)
+					{
+						free(deleteSurface->frames);
+					}
+
+					if (deleteSurface->lock)
+					{
+						if (deleteSurface->lock->image)
+						{
+							free(deleteSurface->lock->image);
+						}
+
+						if (deleteSurface->lock->bitmap)
+						{
+							free(deleteSurface->lock->bitmap);
+						}
+
+						free(deleteSurface->lock);
+					}
+
+					if (deleteSurface->mutex != &walkerDpy->surfaceMutex)
+					{
+						delete deleteSurface->mutex;
+					}
+
+					free(deleteSurface);
+				}
+
+				tempSurface = walkerSurface;
+
+				if (walkerSurface)
+					walkerSurface = walkerSurface->next;
+			}
+
+			while (walkerCtx)
+			{
+				// Avoid deleting of a shared context.
+				/*EGLContextImpl* innerWalkerCtx = walkerDpy->rootCtx;
+				while (innerWalkerCtx)
+				{
+					if (innerWalkerCtx->sharedCtx == walkerCtx)
+					{
+						continue;
+					}
+
+					innerWalkerCtx = innerWalkerCtx->next;
+				}*/
+
+				if (walkerCtx->destroy && walkerCtx != walkerDpy->currentCtx && walkerCtx != g_localStorage.currentCtx && !_eglInternalIsContextCurrent(walkerCtx))
+				{
+					EGLContextImpl* deleteCtx = walkerCtx;
+
+					if (tempCtx == 0)
+					{
+						walkerDpy->rootCtx = deleteCtx->next;
+
+						walkerCtx = walkerDpy->rootCtx;
+					}
+					else
+					{
+						tempCtx->next = deleteCtx->next;
+
+						walkerCtx = tempCtx;
+					}
+
+					// Freeing the context. The native contexts of a virtual context belong to its host.
+					if (deleteCtx->virtualHost)
+					{
+						_eglInternalReleaseVirtualContext(walkerDpy, deleteCtx);
+
+						deleteCtx->rootCtxList = 0;
+					}
+
+					while (deleteCtx->rootCtxList)
+					{
+						EGLContextListImpl* deleteCtxList = deleteCtx->rootCtxList;
+
+						deleteCtx->rootCtxList = deleteCtx->rootCtxList->next;
+
+						_eglInternalPurgeContextPool(walkerDpy, deleteCtxList);
+
+						__deleteContext(walkerDpy, &deleteCtxList->nativeContextContainer);
+
+						free(deleteCtxList);
+					}
+
+					free(deleteCtx);
+				}
+
+				tempCtx = walkerCtx;
+
+				if (walkerCtx)
+				{
+					walkerCtx = walkerCtx->next;
+				}
+			}
+
+			EGLStreamImpl* tempStream = 0;
+
+			EGLStreamImpl* walkerStream = walkerDpy->rootStream;
+
+			while (walkerStream)
+			{
+				// The frames are owned by the stream, so keep them as long as the producer surface exists.
+				if (walkerStream->destroy && walkerStream->producer == 0 && walkerStream->waiters.load() == 0)
+				{
+					EGLStreamImpl* deleteStream = walkerStream;
+
+					if (tempStream == 0)
+					{
+						walkerDpy->rootStream = deleteStream->next;
+
+						walkerStream = walkerDpy->rootStream;
+					}
+					else
+					{
+						tempStream->next = deleteStream->next;
+
+						walkerStream = tempStream;
+					}
+
+					_eglInternalDestroyStreamFrames(walkerDpy, deleteStream);
+
+					if (deleteStream->crossProcess)
+					{
+						__destroyStreamConnection(&deleteStream->nativeStreamContainer);
+					}
+
+					delete deleteStream;
+				}
+
+				tempStream = walkerStream;
+
+				if (walkerStream)
+				{
+					walkerStream = walkerStream->next;
+				}
+			}
+
+			if (walkerDpy->destroy)
+			{
+				if (walkerDpy->rootSurface == 0 && walkerDpy->rootCtx == 0 && walkerDpy->rootStream == 0 && walkerDpy->currentDraw == EGL_NO_SURFACE && walkerDpy->currentRead == EGL_NO_SURFACE && walkerDpy->currentCtx == EGL_NO_CONTEXT)
+				{
+					// The requests of the pool point into the config table.
+					_eglInternalStopContextPool(walkerDpy);
+
+					if (walkerDpy->configTable)
+					{
+						delete[] walkerDpy->configTable;
+						delete[] walkerDpy->surfaceTypeIndex[0];
+
+						walkerDpy->configTable = 0;
+						memset(walkerDpy->surfaceTypeIndex, 0, sizeof(walkerDpy->surfaceTypeIndex));
+					}
+					else
+					{
+						// The initialization did fail, before the configs were frozen.
+						EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+						EGLConfigImpl* deleteConfig;
+
+						while (walkerConfig)
+						{
+							deleteConfig = walkerConfig;
+
+							walkerConfig = walkerConfig->next;
+
+							free(deleteConfig);
+						}
+					}
+					walkerDpy->rootConfig = 0;
+
+					EGLShmImpl* walkerShm = walkerDpy->rootShm;
+
+					EGLShmImpl* deleteShm;
+
+					while (walkerShm)
+					{
+						deleteShm = walkerShm;
+
+						walkerShm = walkerShm->next;
+
+						__destroyShm(walkerDpy, deleteShm);
+
+						free(deleteShm);
+					}
+					walkerDpy->rootShm = 0;
+
+					__closeWindowSizeEvents(walkerDpy);
+
+					//
+
+					EGLDisplayImpl* deleteDpy = walkerDpy;
+
+					if (tempDpy == 0)
+					{
+						g_globalStorage.rootDpy = deleteDpy->next;
+
+						walkerDpy = g_globalStorage.rootDpy;
+					}
+					else
+					{
+						tempDpy->next = deleteDpy->next;
+
+						walkerDpy = tempDpy;
+					}
+
+					delete deleteDpy;
+				}
+			}
+
+			tempDpy = walkerDpy;
+
+			if (walkerDpy)
+			{
+				walkerDpy = walkerDpy->next;
+			}
+		}
+	}
+
+	if (!g_globalStorage.rootDpy)
+	{
+		_eglInternalTerminate();
+	}
+}
+
+void _eglInternalSetDefaultConfig(EGLConfigImpl* config)
+{
+	if (!config)
+	{
+		return;
+	}
+
+	for (const EGLConfigAttribSchemaImpl& schema : g_configSchema)
+	{
+		_EGL_CONFIG_VALUE(config, schema) = schema.defaultValue;
+	}
+
+	//
+
+	config->drawToWindow = EGL_TRUE;
+	config->drawToPixmap = EGL_FALSE;
+	config->drawToPBuffer = EGL_FALSE;
+	config->doubleBuffer = EGL_TRUE;
+
+	memset(&config->nativeConfigContainer, 0, sizeof(NativeConfigContainer));
+
+	config->next = 0;
+}
+
+// Configs are equivalent, if they only differ in the ID, the native visual and the surface types. The backends merge them.
+EGLBoolean _eglInternalEquivalentConfig(const EGLConfigImpl* config, const EGLConfigImpl* other)
+{
+	if (!config || !other)
+	{
+		return EGL_FALSE;
+	}
+
+	for (const EGLConfigAttribSchemaImpl& schema : g_configSchema)
+	{
+		if (!(schema.flags & _EGL_ATTRIB_QUERY) || schema.attribute == EGL_CONFIG_ID || schema.attribute == EGL_NATIVE_VISUAL_ID || schema.attribute == EGL_SURFACE_TYPE)
+		{
+			continue;
+		}
+
+		if (_EGL_CONFIG_VALUE(config, schema) != _EGL_CONFIG_VALUE(other, schema))
+		{
+			return EGL_FALSE;
+		}
+	}
+
+	return config->doubleBuffer == other->doubleBuffer;
+}
+
+// A name has to match a whole entry of the space separated list, as some names are the prefix of another one.
+EGLBoolean _eglInternalHasExtension(const char* extensions, const char* extension)
+{
+	if (!extensions || !extension)
+	{
+		return EGL_FALSE;
+	}
+
+	const size_t length = strlen(extension);
+
+	for (const char* found = strstr(extensions, extension); found; found = strstr(found + length, extension))
+	{
+		if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0'))
+		{
+			return EGL_TRUE;
+		}
+	}
+
+	return EGL_FALSE;
+}
+
+//
+// Config table. The handles of the configs point into it, until the display is deleted.
+//
+
+// Surface type bit of each index of the display.
+static const EGLint g_surfaceTypeIndexBits[_EGL_SURFACE_TYPE_INDEX_COUNT] = { EGL_WINDOW_BIT, EGL_PIXMAP_BIT, EGL_PBUFFER_BIT };
+
+static void _eglInternalFreezeConfigs(EGLDisplayImpl* walkerDpy)
+{
+	EGLint numberConfigs = 0;
+
+	EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+	while (walkerConfig)
+	{
+		numberConfigs++;
+
+		walkerConfig = walkerConfig->next;
+	}
+
+	EGLConfigSlotImpl* configTable = new EGLConfigSlotImpl[numberConfigs > 0 ? numberConfigs : 1];
+
+	walkerConfig = walkerDpy->rootConfig;
+
+	for (EGLint configIndex = 0; configIndex < numberConfigs; configIndex++)
+	{
+		EGLConfigImpl* deleteConfig = walkerConfig;
+
+		walkerConfig = walkerConfig->next;
+
+		configTable[configIndex].config = *deleteConfig;
+		configTable[configIndex].config.next = (configIndex + 1 < numberConfigs) ? &configTable[configIndex + 1].config : 0;
+
+		free(deleteConfig);
+	}
+
+	walkerDpy->rootConfig = numberConfigs > 0 ? &configTable[0].config : 0;
+	walkerDpy->configTable = configTable;
+	walkerDpy->numberConfigs = numberConfigs;
+
+	//
+
+	EGLint* surfaceTypeIndex = new EGLint[_EGL_SURFACE_TYPE_INDEX_COUNT * (numberConfigs > 0 ? numberConfigs : 1)];
+
+	for (EGLint typeIndex = 0; typeIndex < _EGL_SURFACE_TYPE_INDEX_COUNT; typeIndex++)
+	{
+		walkerDpy->surfaceTypeIndex[typeIndex] = surfaceTypeIndex + typeIndex * numberConfigs;
+		walkerDpy->surfaceTypeCount[typeIndex] = 0;
+
+		for (EGLint configIndex = 0; configIndex < numberConfigs; configIndex++)
+		{
+			if (configTable[configIndex].config.surfaceType & g_surfaceTypeIndexBits[typeIndex])
+			{
+				walkerDpy->surfaceTypeIndex[typeIndex][walkerDpy->surfaceTypeCount[typeIndex]++] = configIndex;
+			}
+		}
+	}
+}
+
+// Returns the indices of the configs, which can support the requested surface types. Null, if all configs have to be scanned.
+static const EGLint* _eglInternalFindSurfaceTypeIndex(const EGLDisplayImpl* walkerDpy, EGLint surfaceType, EGLint* numberCandidates)
+{
+	const EGLint* candidates = 0;
+
+	*numberCandidates = walkerDpy->numberConfigs;
+
+	for (EGLint typeIndex = 0; typeIndex < _EGL_SURFACE_TYPE_INDEX_COUNT; typeIndex++)
+	{
+		if ((surfaceType & g_surfaceTypeIndexBits[typeIndex]) && walkerDpy->surfaceTypeCount[typeIndex] < *numberCandidates)
+		{
+			candidates = walkerDpy->surfaceTypeIndex[typeIndex];
+			*numberCandidates = walkerDpy->surfaceTypeCount[typeIndex];
+		}
+	}
+
+	return candidates;
+}
+
+// Returns false, if the display is not initialized. The table can then not be used, even if it still exists.
+static EGLBoolean _eglInternalConfigsPublished(const EGLDisplayImpl* walkerDpy)
+{
+	return walkerDpy->configsPublished.load(std::memory_order_acquire);
+}
+
+static const EGLConfigImpl* _eglInternalFindConfig(const EGLDisplayImpl* walkerDpy, EGLConfig config)
+{
+	const uintptr_t first = (uintptr_t)walkerDpy->configTable;
+	const uintptr_t offset = (uintptr_t)config - first;
+
+	if ((uintptr_t)config < first || offset % sizeof(EGLConfigSlotImpl) != 0 || offset / sizeof(EGLConfigSlotImpl) >= (uintptr_t)walkerDpy->numberConfigs)
+	{
+		return 0;
+	}
+
+	return &walkerDpy->configTable[offset / sizeof(EGLConfigSlotImpl)].config;
+}
+
+// All attributes of the schema are in the range of EGL_BUFFER_SIZE to EGL_CONFORMANT.
+
+#define _EGL_CONFIG_ATTRIB_FIRST EGL_BUFFER_SIZE
+#define _EGL_CONFIG_ATTRIB_COUNT (EGL_CONFORMANT - EGL_BUFFER_SIZE + 1)
+
+typedef struct _EGLConfigSchemaIndexImpl
+{
+	EGLint index[_EGL_CONFIG_ATTRIB_COUNT];
+} EGLConfigSchemaIndexImpl;
+
+// Row of the schema, indexed by the attribute. Unknown attributes of the range have a negative index.
+static constexpr EGLConfigSchemaIndexImpl _eglInternalMakeConfigSchemaIndex()
+{
+	EGLConfigSchemaIndexImpl configSchemaIndex = {};
+
+	for (EGLint i = 0; i < _EGL_CONFIG_ATTRIB_COUNT; i++)
+	{
+		configSchemaIndex.index[i] = -1;
+	}
+
+	for (EGLint i = 0; i < _EGL_CONFIG_SCHEMA_SIZE; i++)
+	{
+		configSchemaIndex.index[g_configSchema[i].attribute - _EGL_CONFIG_ATTRIB_FIRST] = i;
+	}
+
+	return configSchemaIndex;
+}
+
+static constexpr EGLConfigSchemaIndexImpl g_configSchemaIndex = _eglInternalMakeConfigSchemaIndex();
+
+static const EGLConfigAttribSchemaImpl* _eglInternalFindConfigSchema(EGLint attribute)
+{
+	if (attribute < _EGL_CONFIG_ATTRIB_FIRST || attribute >= _EGL_CONFIG_ATTRIB_FIRST + _EGL_CONFIG_ATTRIB_COUNT)
+	{
+		return 0;
+	}
+
+	const EGLint index = g_configSchemaIndex.index[attribute - _EGL_CONFIG_ATTRIB_FIRST];
+
+	return index >= 0 ? &g_configSchema[index] : 0;
+}
+
+// Returns a negative value, if the attribute can not be queried.
+static EGLint _eglInternalConfigAttribOffset(EGLint attribute)
+{
+	const EGLConfigAttribSchemaImpl* schema = _eglInternalFindConfigSchema(attribute);
+
+	return (schema && (schema->flags & _EGL_ATTRIB_QUERY)) ? schema->offset : -1;
+}
+
+static EGLint _eglInternalConfigAttrib(const EGLConfigImpl* config, EGLint offset)
+{
+	return *(const EGLint*)((const char*)config + offset);
+}
+
+static EGLBoolean _eglInternalValidConfigAttrib(EGLint valid, EGLint value)
+{
+	if (value == EGL_DONT_CARE)
+	{
+		return valid != _EGL_VALID_NONE;
+	}
+
+	switch (valid)
+	{
+		case _EGL_VALID_ANY:
+			return EGL_TRUE;
+		case _EGL_VALID_SIZE:
+			return value >= 0;
+		case _EGL_VALID_BOOLEAN:
+			return value == EGL_TRUE || value == EGL_FALSE;
+		case _EGL_VALID_COLOR_BUFFER_TYPE:
+			return value == EGL_RGB_BUFFER || value == EGL_LUMINANCE_BUFFER;
+		case _EGL_VALID_CAVEAT:
+			return value == EGL_NONE || value == EGL_SLOW_CONFIG || value == EGL_NON_CONFORMANT_CONFIG;
+		case _EGL_VALID_API_MASK:
+			return !(value & ~(EGL_OPENGL_BIT | EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT | EGL_OPENVG_BIT));
+		case _EGL_VALID_SURFACE_MASK:
+			return !(value & ~(EGL_MULTISAMPLE_RESOLVE_BOX_BIT | EGL_PBUFFER_BIT | EGL_PIXMAP_BIT | EGL_SWAP_BEHAVIOR_PRESERVED_BIT | EGL_VG_ALPHA_FORMAT_PRE_BIT | EGL_VG_COLORSPACE_LINEAR_BIT | EGL_WINDOW_BIT | EGL_STREAM_BIT_KHR | EGL_MUTABLE_RENDER_BUFFER_BIT_KHR | EGL_LOCK_SURFACE_BIT_KHR));
+		case _EGL_VALID_TRANSPARENT_TYPE:
+			return value == EGL_NONE || value == EGL_TRANSPARENT_RGB;
+	}
+
+	return EGL_FALSE;
+}
+
+// Requested value of eglChooseConfig, which a config has to match.
+typedef struct _EGLConfigCriterionImpl
+{
+	EGLint offset;
+	EGLint match;
+	EGLint value;
+} EGLConfigCriterionImpl;
+
+// Collects the criteria, which do not match every config. The sizes of the configs are not negative.
+static EGLint _eglInternalConfigCriteria(const EGLConfigImpl* requested, EGLConfigCriterionImpl* criteria)
+{
+	EGLint numberCriteria = 0;
+
+	for (const EGLConfigAttribSchemaImpl& schema : g_configSchema)
+	{
+		const EGLint value = _eglInternalConfigAttrib(requested, schema.offset);
+
+		switch (schema.match)
+		{
+			case _EGL_MATCH_NONE:
+				continue;
+			case _EGL_MATCH_AT_LEAST:
+				if (value <= 0)
+				{
+					continue;
+				}
+			break;
+			case _EGL_MATCH_EXACT:
+			case _EGL_MATCH_TRANSPARENT:
+				if (value == EGL_DONT_CARE)
+				{
+					continue;
+				}
+			break;
+			case _EGL_MATCH_MASK:
+				if (value == 0)
+				{
+					continue;
+				}
+			break;
+			case _EGL_MATCH_PIXMAP:
+				if (value == EGL_NONE)
+				{
+					continue;
+				}
+			break;
+		}
+
+		criteria[numberCriteria].offset = schema.offset;
+		criteria[numberCriteria].match = schema.match;
+		criteria[numberCriteria].value = value;
+
+		numberCriteria++;
+	}
+
+	return numberCriteria;
+}
+
+static EGLBoolean _eglInternalMatchConfig(const EGLConfigImpl* walkerConfig, const EGLConfigCriterionImpl* criteria, EGLint numberCriteria)
+{
+	for (EGLint i = 0; i < numberCriteria; i++)
+	{
+		const EGLint value = _eglInternalConfigAttrib(walkerConfig, criteria[i].offset);
+
+		switch (criteria[i].match)
+		{
+			case _EGL_MATCH_AT_LEAST:
+				if (criteria[i].value > value)
+				{
+					return EGL_FALSE;
+				}
+			break;
+			case _EGL_MATCH_MASK:
+				if ((criteria[i].value & value) != criteria[i].value)
+				{
+					return EGL_FALSE;
+				}
+			break;
+			case _EGL_MATCH_TRANSPARENT:
+				// The transparent color is only compared, if the config is transparent.
+				if (walkerConfig->transparentType == EGL_TRANSPARENT_RGB && criteria[i].value != value)
+				{
+					return EGL_FALSE;
+				}
+			break;
+			default:
+				if (criteria[i].value != value)
+				{
+					return EGL_FALSE;
+				}
+			break;
+		}
+	}
+
+	return EGL_TRUE;
+}
+
+//
+// EGL_VERSION_1_0
+//
+
+static EGLenum _eglInternalStreamState(const EGLStreamImpl* stream)
+{
+	EGLenum state = stream->state;
+
+	if (state != EGL_STREAM_STATE_EMPTY_KHR)
+	{
+		return state;
+	}
+
+	// Connected, so the state follows the frames.
+
+	EGLBoolean newFrame;
+
+	if (stream->shared)
+	{
+		newFrame = stream->fifoLength ? (stream->shared->queueHead.load() != stream->shared->queueTail.load()) : (stream->shared->mailbox.load() >= 0);
+	}
+	else
+	{
+		newFrame = stream->fifoLength ? (stream->queueHead.load() != stream->queueTail.load()) : (stream->mailbox.load() >= 0);
+	}
+
+	if (newFrame)
+	{
+		return EGL_STREAM_STATE_NEW_FRAME_AVAILABLE_KHR;
+	}
+
+	if (stream->consumerFrame >= 0)
+	{
+		return EGL_STREAM_STATE_OLD_FRAME_AVAILABLE_KHR;
+	}
+
+	return EGL_STREAM_STATE_EMPTY_KHR;
+}
+
+// Releases the global lock for a wait on the stream, after the display lock was released.
+static void _eglInternalStreamBeginWait(EGLStreamImpl* stream)
+{
+	stream->waiters++;
+
+	g_globalStorage.rootDpy_readrel();
+}
+
+static void _eglInternalStreamEndWait(EGLStreamImpl* stream)
+{
+	g_globalStorage.rootDpy_readacq();
+
+	stream->waiters--;
+}
+
+// Wakes the threads, which wait for a frame or for a change of the state.
+static void _eglInternalStreamNotify(EGLStreamImpl* stream)
+{
+	{
+		object_guard_t _{ stream->waitMutex };
+	}
+
+	stream->waitCondition.notify_all();
+}
+
+static EGLint _eglInternalStreamClaimFrame(EGLStreamImpl* stream)
+{
+	for (EGLint i = 0; i < stream->numberFrames; i++)
+	{
+		EGLint expected = _EGL_STREAM_FRAME_FREE;
+
+		if (stream->frames[i].state.compare_exchange_strong(expected, _EGL_STREAM_FRAME_PRODUCING, std::memory_order_acquire))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+//
+// Cross process streams. The frames are copied into shared memory by the producer and uploaded into the consumer texture.
+//
+
+static unsigned char* _eglInternalStreamSharedPixels(EGLStreamImpl* stream, EGLint frameIndex)
+{
+	return (unsigned char*)stream->shared + _EGL_STREAM_SHARED_HEADER_SIZE + (size_t)frameIndex * (size_t)stream->width * (size_t)stream->height * 4;
+}
+
+static EGLint _eglInternalStreamClaimSharedFrame(EGLStreamImpl* stream)
+{
+	EGLStreamSharedImpl* shared = stream->shared;
+
+	for (EGLint i = 0; i < stream->numberSharedFrames; i++)
+	{
+		EGLint expected = _EGL_STREAM_FRAME_FREE;
+
+		if (shared->frameState[i].compare_exchange_strong(expected, _EGL_STREAM_FRAME_PRODUCING, std::memory_order_acquire))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// The other process can write anything into the shared memory, so an invalid index disconnects the stream.
+static EGLint _eglInternalStreamTakeSharedFrame(EGLStreamImpl* stream)
+{
+	EGLStreamSharedImpl* shared = stream->shared;
+
+	const EGLint numberFrames = stream->numberSharedFrames;
+
+	EGLint frameIndex;
+
+	if (!stream->fifoLength)
+	{
+		frameIndex = shared->mailbox.exchange(-1, std::memory_order_acq_rel);
+	}
+	else
+	{
+		EGLint head = shared->queueHead.load(std::memory_order_relaxed);
+		EGLint tail = shared->queueTail.load(std::memory_order_acquire);
+
+		if (head < 0 || head >= 2 * numberFrames || tail < 0 || tail >= 2 * numberFrames)
+		{
+			stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+			return -1;
+		}
+
+		if (head == tail)
+		{
+			return -1;
+		}
+
+		frameIndex = shared->queue[head % numberFrames];
+
+		shared->queueHead.store((head + 1) % (2 * numberFrames), std::memory_order_release);
+
+		if (frameIndex < 0)
+		{
+			stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+			return -1;
+		}
+	}
+
+	if (frameIndex >= numberFrames)
+	{
+		stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+		return -1;
+	}
+
+	return frameIndex;
+}
+
+// Called by the consumer, until the producer process did connect and did send the shared memory.
+static EGLBoolean _eglInternalStreamReceiveShared(EGLStreamImpl* stream, EGLTimeKHR timeout)
+{
+	if (stream->shared)
+	{
+		return EGL_TRUE;
+	}
+
+	EGLStreamMessageImpl message;
+	void* memory = 0;
+	size_t size = 0;
+
+	EGLint result = __receiveStreamMessage(&stream->nativeStreamContainer, &message, &memory, &size, timeout);
+
+	if (result == _EGL_STREAM_WAIT_DISCONNECTED)
+	{
+		stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+		return EGL_FALSE;
+	}
+
+	if (result == _EGL_STREAM_WAIT_TIMEOUT || !memory)
+	{
+		return EGL_FALSE;
+	}
+
+	// The memory comes from another process, so do not trust the header. It is read once, as it can change afterwards.
+	EGLStreamSharedImpl* shared = (EGLStreamSharedImpl*)memory;
+
+	const EGLint width = shared->width;
+	const EGLint height = shared->height;
+	const EGLint numberFrames = shared->numberFrames;
+
+	if (width <= 0 || height <= 0 || numberFrames <= 0 || numberFrames > _EGL_STREAM_SHARED_MAX_FRAMES || (size - _EGL_STREAM_SHARED_HEADER_SIZE) / ((size_t)width * (size_t)height * 4) < (size_t)numberFrames)
+	{
+		stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+		return EGL_FALSE;
+	}
+
+	stream->shared = shared;
+	stream->width = width;
+	stream->height = height;
+	stream->numberSharedFrames = numberFrames;
+	stream->state = EGL_STREAM_STATE_EMPTY_KHR;
+
+	return EGL_TRUE;
+}
+
+// Called by the producer. Copies the rendered frame into shared memory and signals the consumer process.
+static EGLBoolean _eglInternalStreamSendFrame(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, SurfaceLock& lock)
+{
+	EGLStreamImpl* stream = walkerSurface->stream;
+	EGLStreamSharedImpl* shared = stream->shared;
+
+	if (walkerDpy->currentDraw != walkerSurface)
+	{
+		g_localStorage.error = EGL_BAD_SURFACE;
+
+		return EGL_FALSE;
+	}
+
+	// A frame of the stream size is read, which must not reach past the surface. A producer surface is no window, so its
+	// size is the one queried at creation.
+	if (walkerSurface->width < stream->width || walkerSurface->height < stream->height)
+	{
+		g_localStorage.error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	EGLint frameIndex = _eglInternalStreamClaimSharedFrame(stream);
+
+	if (frameIndex < 0)
+	{
+		// The FIFO is full. Block until the consumer process releases a frame.
+		lock.unlock();
+
+		_eglInternalStreamBeginWait(stream);
+
+		while ((frameIndex = _eglInternalStreamClaimSharedFrame(stream)) < 0)
+		{
+			// Wake up regularly, as a release can happen between the claim and the wait.
+			if (__waitStream(&stream->nativeStreamContainer, EGL_FALSE, 10000000) == _EGL_STREAM_WAIT_DISCONNECTED)
+			{
+				break;
+			}
+		}
+
+		_eglInternalStreamEndWait(stream);
+
+		lock.lock();
+
+		if (frameIndex < 0)
+		{
+			stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+			g_localStorage.error = EGL_BAD_STATE_KHR;
+
+			return EGL_FALSE;
+		}
+	}
+
+	GLint packAlignment = 4;
+
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, stream->width, stream->height, GL_RGBA, GL_UNSIGNED_BYTE, _eglInternalStreamSharedPixels(stream, frameIndex));
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+
+	EGLTimeKHR timestamp = _eglInternalGetTime();
+	EGLuint64KHR frameNumber = shared->producerFrameNumber.load() + 1;
+
+	shared->timestamp[frameIndex] = timestamp;
+	shared->frameNumber[frameIndex] = frameNumber;
+	shared->frameState[frameIndex].store(_EGL_STREAM_FRAME_QUEUED, std::memory_order_release);
+
+	if (stream->fifoLength)
+	{
+		EGLint tail = shared->queueTail.load(std::memory_order_relaxed);
+
+		if (tail < 0 || tail >= 2 * stream->numberSharedFrames)
+		{
+			stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+			g_localStorage.error = EGL_BAD_STATE_KHR;
+
+			return EGL_FALSE;
+		}
+
+		shared->queue[tail % stream->numberSharedFrames] = frameIndex;
+
+		shared->queueTail.store((tail + 1) % (2 * stream->numberSharedFrames), std::memory_order_release);
+	}
+	else
+	{
+		EGLint replacedFrameIndex = shared->mailbox.exchange(frameIndex, std::memory_order_acq_rel);
+
+		if (replacedFrameIndex >= stream->numberSharedFrames)
+		{
+			stream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+			g_localStorage.error = EGL_BAD_STATE_KHR;
+
+			return EGL_FALSE;
+		}
+
+		if (replacedFrameIndex >= 0)
+		{
+			shared->frameState[replacedFrameIndex].store(_EGL_STREAM_FRAME_FREE, std::memory_order_release);
+		}
+	}
+
+	shared->producerFrameNumber.store(frameNumber);
+	shared->producerTime.store(timestamp);
+
+	__signalStream(&stream->nativeStreamContainer, EGL_TRUE);
+
+	return EGL_TRUE;
+}
+
+// Called by the consumer. Uploads the given shared frame into the consumer texture and hands the frame back.
+static void _eglInternalStreamUploadFrame(EGLStreamImpl* stream, EGLint frameIndex)
+{
+	EGLStreamSharedImpl* shared = stream->shared;
+
+	GLint boundTexture = 0;
+	GLint unpackAlignment = 4;
+
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+
+	glBindTexture(GL_TEXTURE_2D, stream->consumerTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	if (stream->consumerFrameNumber.load() == 0)
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, stream->width, stream->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, _eglInternalStreamSharedPixels(stream, frameIndex));
+	}
+	else
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, stream->width, stream->height, GL_RGBA, GL_UNSIGNED_BYTE, _eglInternalStreamSharedPixels(stream, frameIndex));
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+
+	stream->consumerFrame = frameIndex;
+	stream->consumerFrameNumber.store(shared->frameNumber[frameIndex]);
+	stream->consumerTime.store(shared->timestamp[frameIndex]);
+
+	shared->consumerFrameNumber.store(shared->frameNumber[frameIndex]);
+	shared->consumerTime.store(shared->timestamp[frameIndex]);
+
+	// The pixels are in the texture now, so the producer can reuse the frame.
+	shared->frameState[frameIndex].store(_EGL_STREAM_FRAME_FREE, std::memory_order_release);
+
+	__signalStream(&stream->nativeStreamContainer, EGL_FALSE);
+}
+
+// Called by the producer. Hands the rendered frame over to the consumer and continues rendering into a free frame.
+static EGLBoolean _eglInternalStreamInsertFrame(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, SurfaceLock& lock)
+{
+	EGLStreamImpl* stream = walkerSurface->stream;
+
+	if (stream->state != EGL_STREAM_STATE_EMPTY_KHR)
+	{
+		g_localStorage.error = EGL_BAD_STATE_KHR;
+
+		return EGL_FALSE;
+	}
+
+	if (stream->crossProcess)
+	{
+		return _eglInternalStreamSendFrame(walkerDpy, walkerSurface, lock);
+	}
+
+	// The consumer uses another context, so the rendering commands have to be submitted.
+	if (walkerDpy->currentDraw == walkerSurface)
+	{
+		glFlush();
+	}
+
+	EGLint frameIndex = stream->producerFrame;
+	EGLStreamFrameImpl* frame = &stream->frames[frameIndex];
+
+	frame->timestamp = _eglInternalGetTime();
+	frame->frameNumber = stream->producerFrameNumber.load() + 1;
+	frame->state.store(_EGL_STREAM_FRAME_QUEUED, std::memory_order_release);
+
+	if (stream->fifoLength)
+	{
+		EGLint tail = stream->queueTail.load(std::memory_order_relaxed);
+
+		stream->queue[tail % stream->numberFrames] = frameIndex;
+
+		stream->queueTail.store((tail + 1) % (2 * stream->numberFrames), std::memory_order_release);
+	}
+	else
+	{
+		EGLint replacedFrameIndex = stream->mailbox.exchange(frameIndex, std::memory_order_acq_rel);
+
+		// Not acquired by the consumer in time, so the frame is dropped.
+		if (replacedFrameIndex >= 0)
+		{
+			stream->frames[replacedFrameIndex].state.store(_EGL_STREAM_FRAME_FREE, std::memory_order_release);
+		}
+	}
+
+	stream->producerFrameNumber.store(frame->frameNumber);
+	stream->producerTime.store(frame->timestamp);
+
+	_eglInternalStreamNotify(stream);
+
+	EGLint nextFrameIndex = _eglInternalStreamClaimFrame(stream);
+
+	if (nextFrameIndex < 0)
+	{
+		// The FIFO is full. Block until the consumer releases a frame, but do not block other calls meanwhile.
+		lock.unlock();
+
+		_eglInternalStreamBeginWait(stream);
+
+		{
+			unique_object_guard_t waitLock{ stream->waitMutex };
+
+			stream->waitCondition.wait(waitLock, [stream, &nextFrameIndex] { return (nextFrameIndex = _eglInternalStreamClaimFrame(stream)) >= 0 || stream->state != EGL_STREAM_STATE_EMPTY_KHR; });
+		}
+
+		_eglInternalStreamEndWait(stream);
+
+		lock.lock();
+
+		if (nextFrameIndex < 0)
+		{
+			stream->producerFrame = -1;
+
+			g_localStorage.error = EGL_BAD_STATE_KHR;
+
+			return EGL_FALSE;
+		}
+	}
+
+	stream->producerFrame = nextFrameIndex;
+
+	walkerSurface->nativeSurfaceContainer = stream->frames[nextFrameIndex].nativeSurfaceContainer;
+
+	if (walkerDpy->currentDraw == walkerSurface)
+	{
+		EGLContextListImpl* ctxList = _eglInternalFindContextList(walkerDpy->currentCtx, walkerSurface);
+
+		if (ctxList && !__makeCurrent(walkerDpy, &walkerSurface->nativeSurfaceContainer, &ctxList->nativeContextContainer))
+		{
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+	}
+
+	return EGL_TRUE;
+}
+
+// Called by the consumer. Latches the given frame into the consumer texture and returns the previous frame.
+static void _eglInternalStreamLatchFrame(EGLDisplayImpl* walkerDpy, EGLStreamImpl* stream, EGLint frameIndex)
+{
+	GLint boundTexture = 0;
+
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	glBindTexture(GL_TEXTURE_2D, stream->consumerTexture);
+
+	if (stream->consumerFrame >= 0)
+	{
+		__releaseTexImage(walkerDpy, &stream->frames[stream->consumerFrame].nativeSurfaceContainer);
+
+		stream->frames[stream->consumerFrame].state.store(_EGL_STREAM_FRAME_FREE, std::memory_order_release);
+
+		_eglInternalStreamNotify(stream);
+	}
+
+	stream->consumerFrame = frameIndex;
+
+	if (frameIndex >= 0)
+	{
+		EGLStreamFrameImpl* frame = &stream->frames[frameIndex];
+
+		frame->state.store(_EGL_STREAM_FRAME_ACQUIRED, std::memory_order_relaxed);
+
+		__bindTexImage(walkerDpy, &frame->nativeSurfaceContainer);
+
+		stream->consumerFrameNumber.store(frame->frameNumber);
+		stream->consumerTime.store(frame->timestamp);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+}
+
+static EGLint _eglInternalStreamTakeFrame(EGLStreamImpl* stream)
+{
+	if (!stream->fifoLength)
+	{
+		return stream->mailbox.exchange(-1, std::memory_order_acq_rel);
+	}
+
+	EGLint head = stream->queueHead.load(std::memory_order_relaxed);
+
+	if (head == stream->queueTail.load(std::memory_order_acquire))
+	{
+		return -1;
+	}
+
+	EGLint frameIndex = stream->queue[head % stream->numberFrames];
+
+	stream->queueHead.store((head + 1) % (2 * stream->numberFrames), std::memory_order_release);
+
+	return frameIndex;
+}
+
+static EGLStreamImpl* _eglInternalFindStream(EGLDisplayImpl* walkerDpy, EGLStreamKHR stream)
+{
+	EGLStreamImpl* walkerStream = walkerDpy->rootStream;
+
+	while (walkerStream)
+	{
+		if ((EGLStreamKHR)walkerStream == stream)
+		{
+			if (!walkerStream->initialized || walkerStream->destroy)
+			{
+				break;
+			}
+
+			return walkerStream;
+		}
+
+		walkerStream = walkerStream->next;
+	}
+
+	g_localStorage.error = EGL_BAD_STREAM_KHR;
+
+	return 0;
+}
+
+//
+// Cached surface state. eglQuerySurface returns it without a round trip to the native window system.
+//
+
+// Applies the structure events of the windows, which did arrive since the last call.
+static void _eglInternalUpdateWindowSizes(EGLDisplayImpl* walkerDpy)
+{
+	EGLNativeWindowType win;
+	EGLint width;
+	EGLint height;
+
+	while (__pollWindowSize(walkerDpy, &win, &width, &height))
+	{
+		EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+		while (walkerSurface)
+		{
+			if (walkerSurface->drawToWindow && walkerSurface->sizeTracked && walkerSurface->win == win)
+			{
+				walkerSurface->width = width;
+				walkerSurface->height = height;
+			}
+
+			walkerSurface = walkerSurface->next;
+		}
+	}
+}
+
+// The size of pbuffers and pixmaps does not change. The size of a window is only queried, if its events can not be received.
+static EGLBoolean _eglInternalSurfaceSize(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLint* width, EGLint* height)
+{
+	if (walkerSurface->drawToWindow && walkerSurface->sizeTracked)
+	{
+		// The events can resize windows, which are locked by other calls.
+		object_guard_t _{ walkerDpy->eventMutex };
+
+		_eglInternalUpdateWindowSizes(walkerDpy);
+
+		*width = walkerSurface->width;
+		*height = walkerSurface->height;
+
+		return EGL_TRUE;
+	}
+
+	if (walkerSurface->drawToWindow && !__querySurfaceSize(walkerDpy, walkerSurface, &walkerSurface->width, &walkerSurface->height))
+	{
+		return EGL_FALSE;
+	}
+
+	*width = walkerSurface->width;
+	*height = walkerSurface->height;
+
+	return EGL_TRUE;
+}
+
+static EGLBoolean _eglInternalIsCurrentDraw(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	return walkerDpy->currentDraw == walkerSurface && walkerDpy->currentCtx == g_localStorage.currentCtx && g_localStorage.currentCtx != EGL_NO_CONTEXT_IMPL;
+}
+
+// Presents only the damaged rectangles of a window. Returns false, if a full swap has to be done instead.
+static EGLBoolean _eglInternalPresentDamage(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects)
+{
+	if (n_rects <= 0 || !walkerSurface->drawToWindow || !walkerSurface->doubleBuffer || !(walkerDpy->nativeCaps & _EGL_NATIVE_COPY_SUB_BUFFER))
+	{
+		return EGL_FALSE;
+	}
+
+	// The copy is done by the current context.
+	if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+	{
+		return EGL_FALSE;
+	}
+
+	EGLint width;
+	EGLint height;
+
+	if (!_eglInternalSurfaceSize(walkerDpy, walkerSurface, &width, &height) || width <= 0 || height <= 0)
+	{
+		return EGL_FALSE;
+	}
+
+	if (walkerSurface->sizePresentRects < n_rects)
+	{
+		EGLint* presentRects = (EGLint*)realloc(walkerSurface->presentRects, (size_t)n_rects * 4 * sizeof(EGLint));
+
+		if (!presentRects)
+		{
+			return EGL_FALSE;
+		}
+
+		walkerSurface->presentRects = presentRects;
+		walkerSurface->sizePresentRects = n_rects;
+	}
+
+	// Rectangles are clipped to the window, so the parts outside neither count as damage nor reach the native copy.
+	EGLint* presentRects = walkerSurface->presentRects;
+	EGLint numberRects = 0;
+
+	// Copying most of the window is not cheaper than swapping it.
+	EGLuint64KHR damagedArea = 0;
+
+	for (EGLint i = 0; i < n_rects; i++)
+	{
+		const EGLint* rect = &rects[i * 4];
+
+		if (rect[2] < 0 || rect[3] < 0)
+		{
+			return EGL_FALSE;
+		}
+
+		// The far edges are computed in 64 bit, as they can overflow an EGLint.
+		const EGLint left = rect[0] > 0 ? rect[0] : 0;
+		const EGLint bottom = rect[1] > 0 ? rect[1] : 0;
+		const EGLint right = (EGLint)((int64_t)rect[0] + rect[2] < (int64_t)width ? (int64_t)rect[0] + rect[2] : (int64_t)width);
+		const EGLint top = (EGLint)((int64_t)rect[1] + rect[3] < (int64_t)height ? (int64_t)rect[1] + rect[3] : (int64_t)height);
+
+		if (right <= left || top <= bottom)
+		{
+			continue;
+		}
+
+		presentRects[numberRects * 4 + 0] = left;
+		presentRects[numberRects * 4 + 1] = bottom;
+		presentRects[numberRects * 4 + 2] = right - left;
+		presentRects[numberRects * 4 + 3] = top - bottom;
+		numberRects++;
+
+		damagedArea += (EGLuint64KHR)(right - left) * (EGLuint64KHR)(top - bottom);
+	}
+
+	if (damagedArea * 4 > (EGLuint64KHR)width * (EGLuint64KHR)height * 3)
+	{
+		return EGL_FALSE;
+	}
+
+	// Nothing of the window is damaged, so the front buffer stays as it is.
+	if (numberRects == 0)
+	{
+		return EGL_TRUE;
+	}
+
+	return __swapBuffersRegion(walkerDpy, walkerSurface, presentRects, numberRects);
+}
+
+// Called after the native surface is created. The attributes are already validated by the native layer.
+static void _eglInternalInitSurfaceState(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* newSurface, const EGLint* attrib_list)
+{
+	newSurface->largestPbuffer = EGL_FALSE;
+	newSurface->colorspace = EGL_GL_COLORSPACE_LINEAR;
+	newSurface->swapBehavior = EGL_BUFFER_DESTROYED;
+	newSurface->multisampleResolve = EGL_MULTISAMPLE_RESOLVE_DEFAULT;
+	newSurface->mipmapLevel = 0;
+	newSurface->renderBuffer = (newSurface->drawToPixmap || (newSurface->drawToWindow && !newSurface->doubleBuffer)) ? EGL_SINGLE_BUFFER : EGL_BACK_BUFFER;
+	newSurface->frontBuffer = EGL_FALSE;
+	newSurface->timestamps = EGL_FALSE;
+	newSurface->nextFrameId = 1;
+	newSurface->maxFramesInFlight = 0;
+	newSurface->throttleBlocking = EGL_TRUE;
+	newSurface->firstFlightFence = 0;
+	newSurface->numberFlightFences = 0;
+	newSurface->flightCtx = 0;
+	newSurface->framesInFlight = 0;
+	newSurface->peakFramesInFlight = 0;
+	newSurface->swapInterval = 1;
+	newSurface->nativeSwapInterval = 1;
+	newSurface->asyncPresent = EGL_FALSE;
+	newSurface->present = 0;
+	newSurface->mutex = (walkerDpy->nativeCaps & _EGL_NATIVE_THREADS) ? new std::mutex() : &walkerDpy->surfaceMutex;
+
+	EGLint attribListIndex = 0;
+
+	while (attrib_list && attrib_list[attribListIndex] != EGL_NONE)
+	{
+		EGLint value = attrib_list[attribListIndex + 1];
+
+		switch (attrib_list[attribListIndex])
+		{
+			case EGL_GL_COLORSPACE:
+				newSurface->colorspace = (EGLenum)value;
+			break;
+			case EGL_LARGEST_PBUFFER:
+				newSurface->largestPbuffer = value ? EGL_TRUE : EGL_FALSE;
+			break;
+		}
+
+		attribListIndex += 2;
+	}
+
+	// The events are selected first, so no resize is lost after the size is queried.
+	if (newSurface->drawToWindow)
+	{
+		newSurface->sizeTracked = __watchWindowSize(walkerDpy, newSurface->win);
+	}
+
+	if (!__querySurfaceSize(walkerDpy, newSurface, &newSurface->width, &newSurface->height))
+	{
+		newSurface->width = 0;
+		newSurface->height = 0;
+	}
+}
+
+//
+// Preserved swaps. The native swap leaves the back buffer undefined, so the color buffer is copied into a texture before the
+// swap and blitted back after it. A partial present keeps the back buffer without a copy.
+//
+
+static void _eglInternalReleasePreserve(EGLSurfaceImpl* walkerSurface)
+{
+	EGLPreserveImpl* preserve = walkerSurface->preserve;
+
+	if (!preserve)
+	{
+		return;
+	}
+
+	// The objects of another context can not be deleted here.
+	if (preserve->ctx == g_localStorage.currentCtx)
+	{
+		glDeleteFramebuffers(1, &preserve->framebuffer);
+		glDeleteTextures(1, &preserve->texture);
+	}
+
+	free(preserve);
+
+	walkerSurface->preserve = 0;
+}
+
+// Copies the back buffer into the texture or, if restore is set, the texture into the back buffer.
+static EGLBoolean _eglInternalBlitPreserve(EGLPreserveImpl* preserve, EGLBoolean restore)
+{
+	static const GLenum capabilities[] = { GL_SCISSOR_TEST, GL_FRAMEBUFFER_SRGB };
+	const EGLint numberCapabilities = (EGLint)(sizeof(capabilities) / sizeof(capabilities[0]));
+
+	GLboolean enabled[sizeof(capabilities) / sizeof(capabilities[0])];
+	GLint drawFramebuffer = 0;
+	GLint readFramebuffer = 0;
+	GLint readBuffer = GL_BACK;
+	GLint drawBuffer = GL_BACK;
+
+	for (EGLint i = 0; i < numberCapabilities; i++)
+	{
+		enabled[i] = glIsEnabled(capabilities[i]);
+	}
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glGetIntegerv(GL_READ_BUFFER, &readBuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glGetIntegerv(GL_DRAW_BUFFER, &drawBuffer);
+
+	if (restore)
+	{
+		glDrawBuffer(GL_BACK);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, preserve->framebuffer);
+	}
+	else
+	{
+		glReadBuffer(GL_BACK);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, preserve->framebuffer);
+	}
+
+	EGLBoolean result = EGL_TRUE;
+
+	if (glCheckFramebufferStatus(restore ? GL_READ_FRAMEBUFFER : GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+	{
+		for (EGLint i = 0; i < numberCapabilities; i++)
+		{
+			glDisable(capabilities[i]);
+		}
+
+		glBlitFramebuffer(0, 0, preserve->width, preserve->height, 0, 0, preserve->width, preserve->height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+	else
+	{
+		result = EGL_FALSE;
+	}
+
+	for (EGLint i = 0; i < numberCapabilities; i++)
+	{
+		if (enabled[i])
+		{
+			glEnable(capabilities[i]);
+		}
+		else
+		{
+			glDisable(capabilities[i]);
+		}
+	}
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glReadBuffer((GLenum)readBuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glDrawBuffer((GLenum)drawBuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+
+	return result;
+}
+
+// Called before the native swap. Returns true, if the back buffer was copied and has to be restored after the swap.
+static EGLBoolean _eglInternalSavePreserve(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	// Only the back buffer of a window is undefined after a swap.
+	if (walkerSurface->swapBehavior != EGL_BUFFER_PRESERVED || !walkerSurface->drawToWindow || !walkerSurface->doubleBuffer)
+	{
+		return EGL_FALSE;
+	}
+
+	// The copy is done by the current context.
+	if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+	{
+		return EGL_FALSE;
+	}
+
+	EGLint width;
+	EGLint height;
+
+	if (!_eglInternalSurfaceSize(walkerDpy, walkerSurface, &width, &height) || width <= 0 || height <= 0)
+	{
+		return EGL_FALSE;
+	}
+
+	if (walkerSurface->preserve && walkerSurface->preserve->ctx != g_localStorage.currentCtx)
+	{
+		_eglInternalReleasePreserve(walkerSurface);
+	}
+
+	EGLPreserveImpl* preserve = walkerSurface->preserve;
+
+	if (!preserve)
+	{
+		preserve = (EGLPreserveImpl*)calloc(1, sizeof(EGLPreserveImpl));
+
+		if (!preserve)
+		{
+			return EGL_FALSE;
+		}
+
+		preserve->ctx = g_localStorage.currentCtx;
+
+		walkerSurface->preserve = preserve;
+	}
+
+	// The texture is only specified again, if the window was resized.
+	if (!preserve->texture || preserve->width != width || preserve->height != height)
+	{
+		GLint boundBuffer = 0;
+		GLint activeTexture = 0;
+		GLint boundTexture = 0;
+		GLint drawFramebuffer = 0;
+
+		glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &boundBuffer);
+		glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+		glActiveTexture(GL_TEXTURE0);
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if (!preserve->texture)
+		{
+			glGenTextures(1, &preserve->texture);
+			glGenFramebuffers(1, &preserve->framebuffer);
+		}
+
+		glBindTexture(GL_TEXTURE_2D, preserve->texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, preserve->framebuffer);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, preserve->texture, 0);
+
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFramebuffer);
+		glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+		glActiveTexture((GLenum)activeTexture);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)boundBuffer);
+
+		preserve->width = width;
+		preserve->height = height;
+	}
+
+	return _eglInternalBlitPreserve(preserve, EGL_FALSE);
+}
+
+//
+// Frame timestamps. Every swap of a window with timestamps records a frame. A native swap is counted with
+// GLX_OML_sync_control, so its completion can be matched to the frame. Completions are observed, when the frames are
+// updated. A frame, which completed together with a later one, is not observed and gets invalid times.
+//
+
+static EGLFrameImpl* _eglInternalFindFrame(EGLSurfaceImpl* walkerSurface, EGLuint64KHR frameId)
+{
+	if (!walkerSurface->frames || frameId == 0 || frameId >= walkerSurface->nextFrameId)
+	{
+		return 0;
+	}
+
+	EGLFrameImpl* frame = &walkerSurface->frames[frameId % _EGL_FRAME_HISTORY];
+
+	return frame->id == frameId ? frame : 0;
+}
+
+static void _eglInternalUpdateFrames(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerSurface->frames)
+	{
+		return;
+	}
+
+	EGLBoolean pending = EGL_FALSE;
+
+	for (EGLint i = 0; i < _EGL_FRAME_HISTORY; i++)
+	{
+		if (walkerSurface->frames[i].id && walkerSurface->frames[i].presentTime == EGL_TIMESTAMP_PENDING_ANDROID)
+		{
+			pending = EGL_TRUE;
+		}
+	}
+
+	EGLnsecsANDROID ust;
+	EGLuint64KHR msc;
+	EGLuint64KHR sbc;
+
+	if (!pending || !__querySwapCompletion(walkerDpy, walkerSurface, &ust, &msc, &sbc))
+	{
+		return;
+	}
+
+	for (EGLint i = 0; i < _EGL_FRAME_HISTORY; i++)
+	{
+		EGLFrameImpl* frame = &walkerSurface->frames[i];
+
+		if (!frame->id || frame->presentTime != EGL_TIMESTAMP_PENDING_ANDROID || frame->sbc > sbc)
+		{
+			continue;
+		}
+
+		if (frame->sbc == sbc)
+		{
+			frame->presentTime = ust;
+			frame->presentMsc = (EGLnsecsANDROID)msc;
+		}
+		else
+		{
+			frame->presentTime = EGL_TIMESTAMP_INVALID_ANDROID;
+			frame->presentMsc = EGL_TIMESTAMP_INVALID_ANDROID;
+		}
+	}
+}
+
+// Records the frame of a swap, before anything is presented.
+static void _eglInternalBeginFrame(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerSurface->timestamps || !walkerSurface->frames)
+	{
+		return;
+	}
+
+	_eglInternalUpdateFrames(walkerDpy, walkerSurface);
+
+	EGLFrameImpl* frame = &walkerSurface->frames[walkerSurface->nextFrameId % _EGL_FRAME_HISTORY];
+
+	frame->id = walkerSurface->nextFrameId;
+	frame->sbc = 0;
+	frame->submitTime = (EGLnsecsANDROID)_eglInternalGetTime();
+	frame->presentTime = EGL_TIMESTAMP_INVALID_ANDROID;
+	frame->presentMsc = EGL_TIMESTAMP_INVALID_ANDROID;
+
+	walkerSurface->nextFrameId++;
+}
+
+// Native swap of a window. The swap of a recorded frame is counted, if possible.
+static EGLBoolean _eglInternalSwapNative(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLFrameImpl* frame = walkerSurface->timestamps ? _eglInternalFindFrame(walkerSurface, walkerSurface->nextFrameId - 1) : 0;
+
+	if (!frame || !(walkerDpy->nativeCaps & _EGL_NATIVE_SYNC_CONTROL))
+	{
+		return __swapBuffers(walkerDpy, walkerSurface);
+	}
+
+	EGLuint64KHR sbc = 0;
+
+	if (!__swapBuffersCounted(walkerDpy, walkerSurface, &sbc))
+	{
+		return EGL_FALSE;
+	}
+
+	frame->sbc = sbc;
+	frame->presentTime = EGL_TIMESTAMP_PENDING_ANDROID;
+	frame->presentMsc = EGL_TIMESTAMP_PENDING_ANDROID;
+
+	return EGL_TRUE;
+}
+
+static EGLBoolean _eglInternalIsFrameTimestampSupported(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLint timestamp)
+{
+	switch (timestamp)
+	{
+		case EGL_SUBMIT_TIME_DESKTOP:
+			return walkerSurface->drawToWindow;
+		case EGL_DISPLAY_PRESENT_TIME_ANDROID:
+		case EGL_DISPLAY_PRESENT_MSC_DESKTOP:
+			return walkerSurface->drawToWindow && (walkerDpy->nativeCaps & _EGL_NATIVE_SYNC_CONTROL) ? EGL_TRUE : EGL_FALSE;
+	}
+
+	return EGL_FALSE;
+}
+
+static EGLBoolean _eglInternalIsCompositorTimingSupported(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLint name)
+{
+	// There is no compositor, so the timing is the one of the vertical blank.
+	switch (name)
+	{
+		case EGL_COMPOSITE_DEADLINE_ANDROID:
+		case EGL_COMPOSITE_INTERVAL_ANDROID:
+			return walkerSurface->drawToWindow && (walkerDpy->nativeCaps & _EGL_NATIVE_SYNC_CONTROL) ? EGL_TRUE : EGL_FALSE;
+	}
+
+	return EGL_FALSE;
+}
+
+//
+// Frame throttle. Each swap of a window with a limit inserts a fence into the current context. At the limit, the swap waits
+// for the oldest fence. Fences signal in order, so the frames are retired from the front of the queue.
+//
+
+static void _eglInternalReleaseFlightFences(EGLSurfaceImpl* walkerSurface)
+{
+	// The fences of another context can not be deleted here.
+	if (walkerSurface->flightCtx == g_localStorage.currentCtx)
+	{
+		for (EGLint i = 0; i < walkerSurface->numberFlightFences; i++)
+		{
+			glDeleteSync((GLsync)walkerSurface->flightFences[(walkerSurface->firstFlightFence + i) % _EGL_FRAMES_IN_FLIGHT_MAX]);
+		}
+	}
+
+	walkerSurface->firstFlightFence = 0;
+	walkerSurface->numberFlightFences = 0;
+	walkerSurface->flightCtx = 0;
+}
+
+static void _eglInternalRetireFlightFence(EGLSurfaceImpl* walkerSurface)
+{
+	glDeleteSync((GLsync)walkerSurface->flightFences[walkerSurface->firstFlightFence]);
+
+	walkerSurface->firstFlightFence = (walkerSurface->firstFlightFence + 1) % _EGL_FRAMES_IN_FLIGHT_MAX;
+	walkerSurface->numberFlightFences--;
+}
+
+// Called before the swap of the current window. Returns false, if the limit is reached and the throttle does not block.
+static EGLBoolean _eglInternalThrottleFrames(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, SurfaceLock& lock)
+{
+	if (walkerSurface->maxFramesInFlight <= 0 || !_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+	{
+		return EGL_TRUE;
+	}
+
+	if (walkerSurface->flightCtx != g_localStorage.currentCtx)
+	{
+		_eglInternalReleaseFlightFences(walkerSurface);
+
+		walkerSurface->flightCtx = g_localStorage.currentCtx;
+	}
+
+	while (walkerSurface->numberFlightFences > 0)
+	{
+		if (glClientWaitSync((GLsync)walkerSurface->flightFences[walkerSurface->firstFlightFence], 0, 0) == GL_TIMEOUT_EXPIRED)
+		{
+			break;
+		}
+
+		_eglInternalRetireFlightFence(walkerSurface);
+	}
+
+	walkerSurface->framesInFlight = walkerSurface->numberFlightFences;
+
+	if (walkerSurface->framesInFlight > walkerSurface->peakFramesInFlight)
+	{
+		walkerSurface->peakFramesInFlight = walkerSurface->framesInFlight;
+	}
+
+	if (walkerSurface->numberFlightFences >= walkerSurface->maxFramesInFlight && !walkerSurface->throttleBlocking)
+	{
+		g_localStorage.error = EGL_BAD_ACCESS;
+
+		return EGL_FALSE;
+	}
+
+	while (walkerSurface->numberFlightFences >= walkerSurface->maxFramesInFlight)
+	{
+		void* fence = walkerSurface->flightFences[walkerSurface->firstFlightFence];
+
+		// Other calls can use the display, while the swap waits for the GPU.
+		lock.unlock();
+
+		glClientWaitSync((GLsync)fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+		lock.lock();
+
+		// The surface was destroyed, made current to another context or its fences were released meanwhile.
+		if (walkerSurface->destroy || !_eglInternalIsCurrentDraw(walkerDpy, walkerSurface) || walkerSurface->flightCtx != g_localStorage.currentCtx)
+		{
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		if (walkerSurface->numberFlightFences > 0 && walkerSurface->flightFences[walkerSurface->firstFlightFence] == fence)
+		{
+			_eglInternalRetireFlightFence(walkerSurface);
+		}
+	}
+
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	if (fence)
+	{
+		walkerSurface->flightFences[(walkerSurface->firstFlightFence + walkerSurface->numberFlightFences) % _EGL_FRAMES_IN_FLIGHT_MAX] = (void*)fence;
+		walkerSurface->numberFlightFences++;
+	}
+
+	return EGL_TRUE;
+}
+
+//
+// Mutable render buffer. A double buffered window renders into its front buffer by switching the draw and read buffer
+// of the default framebuffer. Each native context keeps the buffer it was switched to.
+//
+
+static void _eglInternalApplyRenderBuffer(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLContextListImpl* ctxList = walkerDpy->currentCtx ? walkerDpy->currentCtx->rootCtxList : 0;
+
+	while (ctxList && ctxList->surface != walkerSurface)
+	{
+		ctxList = ctxList->next;
+	}
+
+	// The pixmaps of an asynchronously presented window are single buffered.
+	const EGLBoolean frontBuffer = (walkerSurface->frontBuffer || (walkerSurface->present && walkerSurface->present->current >= 0)) ? EGL_TRUE : EGL_FALSE;
+
+	if (!ctxList || ctxList->frontBuffer == frontBuffer)
+	{
+		return;
+	}
+
+	const GLenum buffer = frontBuffer ? GL_FRONT : GL_BACK;
+
+	GLint drawFramebuffer = 0;
+	GLint readFramebuffer = 0;
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glDrawBuffer(buffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glReadBuffer(buffer);
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+
+	ctxList->frontBuffer = frontBuffer;
+}
+
+// Swap of a double buffered window, which renders into its front buffer or is switched from or to it.
+static EGLBoolean _eglInternalSwapRenderBuffer(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	// The buffer can only be switched in the current context, so the switch waits for a swap from it.
+	if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+	{
+		return walkerSurface->frontBuffer ? EGL_TRUE : _eglInternalSwapNative(walkerDpy, walkerSurface);
+	}
+
+	walkerSurface->backBufferKept = EGL_FALSE;
+
+	// Rendering into the front buffer is presented by flushing it.
+	if (walkerSurface->frontBuffer)
+	{
+		glFlush();
+	}
+	else if (!_eglInternalSwapNative(walkerDpy, walkerSurface))
+	{
+		return EGL_FALSE;
+	}
+
+	walkerSurface->frontBuffer = (walkerSurface->renderBuffer == EGL_SINGLE_BUFFER) ? EGL_TRUE : EGL_FALSE;
+
+	_eglInternalApplyRenderBuffer(walkerDpy, walkerSurface);
+
+	return EGL_TRUE;
+}
+
+//
+// Swap interval. The interval is kept by the surface and only passed to the native layer, if it differs from the one,
+// which was last set for the drawable. A new drawable starts with the default of one.
+//
+
+static void _eglInternalApplySwapInterval(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLContextListImpl* ctxList = _eglInternalFindContextList(walkerDpy->currentCtx, walkerSurface);
+
+	if (!walkerSurface->drawToWindow || !ctxList || walkerSurface->nativeSwapInterval == walkerSurface->swapInterval)
+	{
+		return;
+	}
+
+	// Not retried on failure, as the native interval would not change on the next call either.
+	__swapInterval(walkerDpy, walkerSurface, walkerSurface->swapInterval);
+
+	walkerSurface->nativeSwapInterval = walkerSurface->swapInterval;
+}
+
+//
+// Asynchronous present. The current context renders into one of two pixmaps instead of the window. The swap fences the
+// frame and queues its pixmap. The present thread waits for the fence in its own native context, copies the pixmap into
+// the back buffer of the window and swaps it, without locking the display. The swap only waits, while the pixmap rendered
+// into next is still queued.
+//
+
+static void _eglInternalPresentThread(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLPresentImpl* present)
+{
+	EGLBoolean current = EGL_FALSE;
+
+	while (true)
+	{
+		EGLPresentBufferImpl* buffer = 0;
+
+		{
+			unique_object_guard_t presentLock{ present->mutex };
+
+			present->condition.wait(presentLock, [present] { return present->quit || present->numberQueued > 0; });
+
+			// The queue is drained, before the thread quits.
+			if (!present->numberQueued)
+			{
+				break;
+			}
+
+			buffer = &present->buffers[present->queue[present->queueHead]];
+		}
+
+		// The window is drawn and the pixmap is read through the default framebuffer.
+		current = __makeCurrentRead(walkerDpy, &walkerSurface->nativeSurfaceContainer, &buffer->nativeSurfaceContainer, &present->nativeContextContainer);
+
+		if (current)
+		{
+			glWaitSync((GLsync)buffer->fence, 0, GL_TIMEOUT_IGNORED);
+			glDeleteSync((GLsync)buffer->fence);
+
+			glReadBuffer(GL_FRONT);
+			glBlitFramebuffer(0, 0, buffer->width, buffer->height, 0, 0, buffer->width, buffer->height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+			// The pixmap is rendered into again, as soon as it is handed back.
+			glFinish();
+		}
+
+		{
+			object_guard_t _{ present->mutex };
+
+			buffer->fence = 0;
+			buffer->queued = EGL_FALSE;
+
+			present->queueHead = (present->queueHead + 1) % _EGL_PRESENT_BUFFERS;
+			present->numberQueued--;
+
+			present->condition.notify_all();
+		}
+
+		// Blocks for the vertical blank, while the next frame is already rendered.
+		if (current)
+		{
+			__swapBuffers(walkerDpy, walkerSurface);
+		}
+	}
+
+	if (current)
+	{
+		__makeCurrent(walkerDpy, 0, 0);
+	}
+}
+
+// The native context of the present thread is created for the window and shares with the one of the current context.
+static EGLBoolean _eglInternalStartPresent(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLContextListImpl* ctxList)
+{
+	EGLPresentImpl* present = walkerSurface->present;
+
+	if (!__createContext(&present->nativeContextContainer, walkerDpy, &walkerSurface->nativeSurfaceContainer, &ctxList->nativeContextContainer, walkerDpy->currentCtx->attribList))
+	{
+		return EGL_FALSE;
+	}
+
+	present->ctx = walkerDpy->currentCtx;
+	present->quit = EGL_FALSE;
+	present->thread = std::thread(_eglInternalPresentThread, walkerDpy, walkerSurface, present);
+
+	return EGL_TRUE;
+}
+
+// Returns, after all queued pixmaps are presented.
+static void _eglInternalStopPresent(EGLDisplayImpl* walkerDpy, EGLPresentImpl* present)
+{
+	if (!present->ctx)
+	{
+		return;
+	}
+
+	{
+		object_guard_t _{ present->mutex };
+
+		present->quit = EGL_TRUE;
+
+		present->condition.notify_all();
+	}
+
+	present->thread.join();
+
+	__deleteContext(walkerDpy, &present->nativeContextContainer);
+
+	present->ctx = 0;
+}
+
+// A swap, which waits for a pixmap, deletes the present itself.
+static void _eglInternalReleasePresent(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLPresentImpl* present = walkerSurface->present;
+
+	if (!present)
+	{
+		return;
+	}
+
+	_eglInternalStopPresent(walkerDpy, present);
+
+	for (EGLint i = 0; i < _EGL_PRESENT_BUFFERS; i++)
+	{
+		if (present->buffers[i].width)
+		{
+			__destroyTexturePixmap(walkerDpy, &present->buffers[i].nativeSurfaceContainer);
+		}
+	}
+
+	walkerSurface->present = 0;
+
+	{
+		object_guard_t _{ present->mutex };
+
+		if (present->waiting)
+		{
+			present->orphaned = EGL_TRUE;
+
+			present->condition.notify_all();
+
+			return;
+		}
+	}
+
+	delete present;
+}
+
+// Renders into the window again. The frames queued before are presented.
+static void _eglInternalEndPresent(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLContextListImpl* ctxList)
+{
+	_eglInternalReleasePresent(walkerDpy, walkerSurface);
+
+	__makeCurrent(walkerDpy, &walkerSurface->nativeSurfaceContainer, &ctxList->nativeContextContainer);
+
+	_eglInternalApplyRenderBuffer(walkerDpy, walkerSurface);
+}
+
+// The pixmap is recreated, if the size of the window did change. The content of a new pixmap is undefined.
+static EGLBoolean _eglInternalResizePresentBuffer(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLPresentBufferImpl* buffer)
+{
+	EGLint width = 0;
+	EGLint height = 0;
+
+	if (!_eglInternalSurfaceSize(walkerDpy, walkerSurface, &width, &height))
+	{
+		return EGL_FALSE;
+	}
+
+	// A minimized window keeps the previous pixmap.
+	if (width <= 0 || height <= 0)
+	{
+		return buffer->width > 0;
+	}
+
+	if (buffer->width == width && buffer->height == height)
+	{
+		return EGL_TRUE;
+	}
+
+	EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+	while (walkerConfig && walkerConfig->configId != walkerSurface->configId)
+	{
+		walkerConfig = walkerConfig->next;
+	}
+
+	NativeSurfaceContainer nativeSurfaceContainer;
+	EGLint error = EGL_SUCCESS;
+
+	// The window has no texture format, so the pixmap keeps the alpha of the config.
+	if (!walkerConfig || !__createTexturePixmap(&nativeSurfaceContainer, walkerDpy, walkerConfig, walkerConfig->alphaSize ? EGL_TEXTURE_RGBA : EGL_TEXTURE_RGB, width, height, &error))
+	{
+		return EGL_FALSE;
+	}
+
+	if (buffer->width)
+	{
+		__destroyTexturePixmap(walkerDpy, &buffer->nativeSurfaceContainer);
+	}
+
+	buffer->nativeSurfaceContainer = nativeSurfaceContainer;
+	buffer->width = width;
+	buffer->height = height;
+	buffer->frame = 0;
+
+	return EGL_TRUE;
+}
+
+// Swap of the current window, while asynchronous present is set or until the first swap after it was cleared.
+static EGLBoolean _eglInternalSwapAsync(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, SurfaceLock& lock)
+{
+	EGLContextListImpl* ctxList = _eglInternalFindContextList(walkerDpy->currentCtx, walkerSurface);
+
+	// The frame can only be fenced in the current context.
+	if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface) || !ctxList)
+	{
+		g_localStorage.error = EGL_BAD_SURFACE;
+
+		return EGL_FALSE;
+	}
+
+	EGLPresentImpl* present = walkerSurface->present;
+
+	if (!present)
+	{
+		present = new EGLPresentImpl();
+		present->current = -1;
+
+		walkerSurface->present = present;
+	}
+
+	// The fences can only be waited for in a native context, which shares with the current one.
+	if (present->ctx != walkerDpy->currentCtx)
+	{
+		_eglInternalStopPresent(walkerDpy, present);
+	}
+
+	if (!present->ctx && !_eglInternalStartPresent(walkerDpy, walkerSurface, ctxList))
+	{
+		const EGLBoolean lost = present->current >= 0;
+
+		walkerSurface->asyncPresent = EGL_FALSE;
+
+		_eglInternalEndPresent(walkerDpy, walkerSurface, ctxList);
+
+		if (lost)
+		{
+			g_localStorage.error = EGL_BAD_ALLOC;
+
+			return EGL_FALSE;
+		}
+
+		return _eglInternalSwapNative(walkerDpy, walkerSurface);
+	}
+
+	if (present->current < 0)
+	{
+		// The frame was rendered into the window.
+		if (!_eglInternalSwapNative(walkerDpy, walkerSurface))
+		{
+			return EGL_FALSE;
+		}
+	}
+	else
+	{
+		EGLPresentBufferImpl* buffer = &present->buffers[present->current];
+
+		buffer->fence = (void*)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		buffer->frame = ++present->numberFrames;
+
+		// The fence has to be submitted, before another context can wait for it.
+		glFlush();
+
+		{
+			object_guard_t _{ present->mutex };
+
+			buffer->queued = EGL_TRUE;
+
+			present->queue[(present->queueHead + present->numberQueued) % _EGL_PRESENT_BUFFERS] = present->current;
+			present->numberQueued++;
+
+			present->condition.notify_all();
+		}
+	}
+
+	const EGLint next = walkerSurface->asyncPresent ? (present->current + 1) % _EGL_PRESENT_BUFFERS : -1;
+
+	// Other calls can use the display, while the swap waits for the present thread.
+	lock.unlock();
+
+	{
+		unique_object_guard_t presentLock{ present->mutex };
+
+		present->waiting = EGL_TRUE;
+
+		present->condition.wait(presentLock, [present, next] { return present->orphaned || (next >= 0 ? !present->buffers[next].queued : !present->numberQueued); });
+	}
+
+	// The present stays waiting until the locks are taken again, as it can be released before.
+	lock.lock();
+
+	EGLBoolean orphaned = EGL_FALSE;
+
+	{
+		object_guard_t _{ present->mutex };
+
+		present->waiting = EGL_FALSE;
+
+		orphaned = present->orphaned;
+	}
+
+	// The surface was destroyed meanwhile.
+	if (orphaned || walkerSurface->present != present || walkerSurface->destroy)
+	{
+		if (orphaned)
+		{
+			delete present;
+		}
+
+		g_localStorage.error = EGL_BAD_SURFACE;
+
+		return EGL_FALSE;
+	}
+
+	if (next < 0 || !_eglInternalResizePresentBuffer(walkerDpy, walkerSurface, &present->buffers[next]))
+	{
+		if (next >= 0)
+		{
+			walkerSurface->asyncPresent = EGL_FALSE;
+		}
+
+		_eglInternalEndPresent(walkerDpy, walkerSurface, ctxList);
+
+		return EGL_TRUE;
+	}
+
+	present->current = next;
+
+	if (!__makeCurrent(walkerDpy, &present->buffers[next].nativeSurfaceContainer, &ctxList->nativeContextContainer))
+	{
+		walkerSurface->asyncPresent = EGL_FALSE;
+
+		_eglInternalEndPresent(walkerDpy, walkerSurface, ctxList);
+
+		return EGL_TRUE;
+	}
+
+	_eglInternalApplyRenderBuffer(walkerDpy, walkerSurface);
+
+	return EGL_TRUE;
+}
+
+//
+// Asynchronous readback. Each readback goes into a pixel pack buffer of the ring and is guarded by a fence.
+//
+
+static EGLReadbackImpl* _eglInternalFindReadback(EGLDisplayImpl* walkerDpy, EGLReadbackDESKTOP readback, EGLSurfaceImpl** surface)
+{
+	EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+	while (walkerSurface)
+	{
+		if (walkerSurface->readbacks && (EGLReadbackImpl*)readback >= walkerSurface->readbacks && (EGLReadbackImpl*)readback < walkerSurface->readbacks + walkerSurface->numberReadbacks)
+		{
+			EGLReadbackImpl* walkerReadback = (EGLReadbackImpl*)readback;
+
+			if (walkerReadback->state == _EGL_READBACK_FREE || walkerSurface->destroy)
+			{
+				break;
+			}
+
+			*surface = walkerSurface;
+
+			return walkerReadback;
+		}
+
+		walkerSurface = walkerSurface->next;
+	}
+
+	g_localStorage.error = EGL_BAD_PARAMETER;
+
+	return 0;
+}
+
+// The buffers and fences can only be accessed in the native context, which did create them.
+static EGLBoolean _eglInternalIsReadbackCurrent(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	if (walkerDpy->currentDraw != walkerSurface || walkerDpy->currentCtx != g_localStorage.currentCtx || walkerSurface->readbackCtx != g_localStorage.currentCtx)
+	{
+		g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+		return EGL_FALSE;
+	}
+
+	return EGL_TRUE;
+}
+
+static EGLint _eglInternalWaitReadback(EGLReadbackImpl* readback, EGLTime timeout)
+{
+	if (!readback->fence)
+	{
+		return EGL_CONDITION_SATISFIED;
+	}
+
+	// EGL_FOREVER and GL_TIMEOUT_IGNORED have the same value.
+	GLenum result = glClientWaitSync((GLsync)readback->fence, GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64)timeout);
+
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		return EGL_TIMEOUT_EXPIRED;
+	}
+
+	if (result == GL_WAIT_FAILED)
+	{
+		g_localStorage.error = EGL_BAD_ACCESS;
+
+		return EGL_FALSE;
+	}
+
+	glDeleteSync((GLsync)readback->fence);
+	readback->fence = 0;
+
+	return EGL_CONDITION_SATISFIED;
+}
+
+static const void* _eglInternalMapReadback(EGLReadbackImpl* readback)
+{
+	GLint boundBuffer = 0;
+
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &boundBuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+
+	const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)readback->size, GL_MAP_READ_BIT);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)boundBuffer);
+
+	if (pixels)
+	{
+		readback->state = _EGL_READBACK_MAPPED;
+		readback->pixels = pixels;
+	}
+
+	return pixels;
+}
+
+static void _eglInternalReleaseReadback(EGLReadbackImpl* readback)
+{
+	if (readback->state == _EGL_READBACK_MAPPED)
+	{
+		GLint boundBuffer = 0;
+
+		glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &boundBuffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)boundBuffer);
+	}
+
+	if (readback->fence)
+	{
+		glDeleteSync((GLsync)readback->fence);
+		readback->fence = 0;
+	}
+
+	readback->pixels = 0;
+	readback->callback = 0;
+	readback->userData = 0;
+	readback->state = _EGL_READBACK_FREE;
+}
+
+// Hands a finished readback to its callback. The callback must not call EGL, as the display is locked.
+static void _eglInternalDeliverReadback(EGLReadbackImpl* readback)
+{
+	const void* pixels = _eglInternalMapReadback(readback);
+
+	readback->callback((EGLReadbackDESKTOP)readback, pixels, readback->width, readback->height, readback->userData);
+
+	_eglInternalReleaseReadback(readback);
+}
+
+// Delivers all readbacks with a callback, which are finished. Does not block.
+static void _eglInternalDispatchReadbacks(EGLSurfaceImpl* walkerSurface)
+{
+	for (EGLint i = 0; i < walkerSurface->numberReadbacks; i++)
+	{
+		// Oldest first, so the callbacks are in submission order.
+		EGLReadbackImpl* readback = &walkerSurface->readbacks[(walkerSurface->nextReadback + i) % walkerSurface->numberReadbacks];
+
+		if (readback->state == _EGL_READBACK_PENDING && readback->callback && _eglInternalWaitReadback(readback, 0) == EGL_CONDITION_SATISFIED)
+		{
+			_eglInternalDeliverReadback(readback);
+		}
+	}
+}
+
+//
+// Conversion of the readback from RGBA to planar YUV. All planes are rendered into one single channel texture,
+// which has the memory layout of the planes: width x height luma, followed by width x height / 2 chroma.
+//
+
+static const char* _eglConvertVertexShader =
+	"#version 150\n"
+	"void main()\n"
+	"{\n"
+	"	vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+	"	gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);\n"
+	"}\n";
+
+// BT.601 limited range. The source is bottom up, the planes are top down.
+static const char* _eglConvertFragmentShader =
+	"#version 150\n"
+	"uniform sampler2D u_source;\n"
+	"uniform ivec2 u_size;\n"
+	"uniform int u_layout;\n"
+	"out vec4 fragColor;\n"
+	"vec3 fetch(int x, int y)\n"
+	"{\n"
+	"	return texelFetch(u_source, ivec2(x, u_size.y - 1 - y), 0).rgb;\n"
+	"}\n"
+	"void main()\n"
+	"{\n"
+	"	int x = int(gl_FragCoord.x);\n"
+	"	int row = int(gl_FragCoord.y);\n"
+	"	if (row < u_size.y)\n"
+	"	{\n"
+	"		fragColor = vec4((16.0 + dot(fetch(x, row), vec3(65.481, 128.553, 24.966))) / 255.0);\n"
+	"		return;\n"
+	"	}\n"
+	"	int component;\n"
+	"	int cx;\n"
+	"	int cy;\n"
+	"	if (u_layout == 0)\n"
+	"	{\n"
+	"		component = x % 2;\n"
+	"		cx = x / 2;\n"
+	"		cy = row - u_size.y;\n"
+	"	}\n"
+	"	else\n"
+	"	{\n"
+	"		int planeSize = (u_size.x / 2) * (u_size.y / 2);\n"
+	"		int linear = (row - u_size.y) * u_size.x + x;\n"
+	"		component = linear / planeSize;\n"
+	"		cx = (linear % planeSize) % (u_size.x / 2);\n"
+	"		cy = (linear % planeSize) / (u_size.x / 2);\n"
+	"	}\n"
+	"	vec3 color = (fetch(2 * cx, 2 * cy) + fetch(2 * cx + 1, 2 * cy) + fetch(2 * cx, 2 * cy + 1) + fetch(2 * cx + 1, 2 * cy + 1)) * 0.25;\n"
+	"	vec3 weights = component == 0 ? vec3(-37.797, -74.203, 112.0) : vec3(112.0, -93.786, -18.214);\n"
+	"	fragColor = vec4((128.0 + dot(color, weights)) / 255.0);\n"
+	"}\n";
+
+static GLuint _eglInternalCompileShader(GLenum type, const char* source)
+{
+	GLuint shader = glCreateShader(type);
+
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+
+	GLint status = 0;
+
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+	if (!status)
+	{
+		glDeleteShader(shader);
+
+		return 0;
+	}
+
+	return shader;
+}
+
+static EGLBoolean _eglInternalCreateConvert(EGLSurfaceImpl* walkerSurface)
+{
+	EGLConvertImpl* convert = (EGLConvertImpl*)calloc(1, sizeof(EGLConvertImpl));
+
+	if (!convert)
+	{
+		return EGL_FALSE;
+	}
+
+	GLuint vertexShader = _eglInternalCompileShader(GL_VERTEX_SHADER, _eglConvertVertexShader);
+	GLuint fragmentShader = _eglInternalCompileShader(GL_FRAGMENT_SHADER, _eglConvertFragmentShader);
+
+	if (!vertexShader || !fragmentShader)
+	{
+		if (vertexShader)
+		{
+			glDeleteShader(vertexShader);
+		}
+
+		if (fragmentShader)
+		{
+			glDeleteShader(fragmentShader);
+		}
+
+		free(convert);
+
+		return EGL_FALSE;
+	}
+
+	convert->program = glCreateProgram();
+
+	glAttachShader(convert->program, vertexShader);
+	glAttachShader(convert->program, fragmentShader);
+	glLinkProgram(convert->program);
+
+	// Flagged for deletion, freed together with the program.
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	GLint status = 0;
+
+	glGetProgramiv(convert->program, GL_LINK_STATUS, &status);
+
+	if (!status)
+	{
+		glDeleteProgram(convert->program);
+
+		free(convert);
+
+		return EGL_FALSE;
+	}
+
+	convert->sourceLocation = glGetUniformLocation(convert->program, "u_source");
+	convert->sizeLocation = glGetUniformLocation(convert->program, "u_size");
+	convert->layoutLocation = glGetUniformLocation(convert->program, "u_layout");
+
+	// The vertices are generated from gl_VertexID, but a core profile needs a bound vertex array.
+	glGenVertexArrays(1, &convert->vertexArray);
+	glGenFramebuffers(1, &convert->framebuffer);
+	glGenTextures(1, &convert->sourceTexture);
+	glGenTextures(1, &convert->targetTexture);
+
+	walkerSurface->convert = convert;
+
+	return EGL_TRUE;
+}
+
+static void _eglInternalReleaseConvert(EGLSurfaceImpl* walkerSurface)
+{
+	EGLConvertImpl* convert = walkerSurface->convert;
+
+	if (!convert)
+	{
+		return;
+	}
+
+	// The objects of another context can not be deleted here.
+	if (walkerSurface->readbackCtx == g_localStorage.currentCtx)
+	{
+		glDeleteProgram(convert->program);
+		glDeleteVertexArrays(1, &convert->vertexArray);
+		glDeleteFramebuffers(1, &convert->framebuffer);
+		glDeleteTextures(1, &convert->sourceTexture);
+		glDeleteTextures(1, &convert->targetTexture);
+	}
+
+	free(convert);
+
+	walkerSurface->convert = 0;
+}
+
+// Unmaps and deletes the buffers and fences of the ring and the conversion objects.
+static void _eglInternalReleaseReadbacks(EGLSurfaceImpl* walkerSurface)
+{
+	if (walkerSurface->readbacks)
+	{
+		// The objects of another context can not be deleted here.
+		if (walkerSurface->readbackCtx == g_localStorage.currentCtx)
+		{
+			for (EGLint i = 0; i < walkerSurface->numberReadbacks; i++)
+			{
+				_eglInternalReleaseReadback(&walkerSurface->readbacks[i]);
+
+				if (walkerSurface->readbacks[i].buffer)
+				{
+					glDeleteBuffers(1, &walkerSurface->readbacks[i].buffer);
+				}
+			}
+		}
+
+		free(walkerSurface->readbacks);
+	}
+
+	_eglInternalReleaseConvert(walkerSurface);
+
+	walkerSurface->readbacks = 0;
+	walkerSurface->numberReadbacks = 0;
+	walkerSurface->nextReadback = 0;
+	walkerSurface->readbackCtx = 0;
+}
+
+// Converts the current read buffer and reads the planes into the bound pixel pack buffer. The GL state is restored.
+static EGLBoolean _eglInternalConvertReadback(EGLSurfaceImpl* walkerSurface, EGLint width, EGLint height)
+{
+	if (!walkerSurface->convert && !_eglInternalCreateConvert(walkerSurface))
+	{
+		return EGL_FALSE;
+	}
+
+	EGLConvertImpl* convert = walkerSurface->convert;
+
+	static const GLenum capabilities[] = { GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_STENCIL_TEST, GL_FRAMEBUFFER_SRGB };
+	const EGLint numberCapabilities = (EGLint)(sizeof(capabilities) / sizeof(capabilities[0]));
+
+	GLboolean enabled[sizeof(capabilities) / sizeof(capabilities[0])];
+	GLboolean colorMask[4];
+	GLint viewport[4];
+	GLint program = 0;
+	GLint vertexArray = 0;
+	GLint drawFramebuffer = 0;
+	GLint readFramebuffer = 0;
+	GLint activeTexture = 0;
+	GLint boundTexture = 0;
+	GLint packAlignment = 4;
+	GLint packRowLength = 0;
+	GLint packSkipRows = 0;
+	GLint packSkipPixels = 0;
+
+	for (EGLint i = 0; i < numberCapabilities; i++)
+	{
+		enabled[i] = glIsEnabled(capabilities[i]);
+	}
+	glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+	glActiveTexture(GL_TEXTURE0);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glGetIntegerv(GL_PACK_ROW_LENGTH, &packRowLength);
+	glGetIntegerv(GL_PACK_SKIP_ROWS, &packSkipRows);
+	glGetIntegerv(GL_PACK_SKIP_PIXELS, &packSkipPixels);
+
+	EGLBoolean result = EGL_TRUE;
+
+	if (convert->width != width || convert->height != height)
+	{
+		glBindTexture(GL_TEXTURE_2D, convert->targetTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height * 3 / 2, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+
+		glBindTexture(GL_TEXTURE_2D, convert->sourceTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, convert->framebuffer);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, convert->targetTexture, 0);
+
+		convert->width = width;
+		convert->height = height;
+	}
+
+	// Copy of the read buffer, so the pass can sample it.
+	glBindTexture(GL_TEXTURE_2D, convert->sourceTexture);
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, convert->framebuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+	{
+		for (EGLint i = 0; i < numberCapabilities; i++)
+		{
+			glDisable(capabilities[i]);
+		}
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glViewport(0, 0, width, height * 3 / 2);
+
+		glUseProgram(convert->program);
+		glUniform1i(convert->sourceLocation, 0);
+		glUniform2i(convert->sizeLocation, width, height);
+		glUniform1i(convert->layoutLocation, walkerSurface->readbackFormat == EGL_READBACK_FORMAT_NV12_DESKTOP ? 0 : 1);
+
+		glBindVertexArray(convert->vertexArray);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+
+		// The planes are tightly packed, whatever pack state the application did set.
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_PACK_SKIP_ROWS, 0);
+		glPixelStorei(GL_PACK_SKIP_PIXELS, 0);
+		glReadPixels(0, 0, width, height * 3 / 2, GL_RED, GL_UNSIGNED_BYTE, (void*)0);
+	}
+	else
+	{
+		result = EGL_FALSE;
+	}
+
+	for (EGLint i = 0; i < numberCapabilities; i++)
+	{
+		if (enabled[i])
+		{
+			glEnable(capabilities[i]);
+		}
+		else
+		{
+			glDisable(capabilities[i]);
+		}
+	}
+	glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glUseProgram((GLuint)program);
+	glBindVertexArray((GLuint)vertexArray);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+	glActiveTexture((GLenum)activeTexture);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	glPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+	glPixelStorei(GL_PACK_SKIP_ROWS, packSkipRows);
+	glPixelStorei(GL_PACK_SKIP_PIXELS, packSkipPixels);
+
+	return result;
+}
+
+//
+// Client memory pbuffers.
+//
+
+static EGLBoolean _eglInternalHasGLExtension(const char* extension)
+{
+	GLint numberExtensions = 0;
+
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numberExtensions);
+
+	for (GLint i = 0; i < numberExtensions; i++)
+	{
+		const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+
+		if (name && strcmp(name, extension) == 0)
+		{
+			return EGL_TRUE;
+		}
+	}
+
+	return EGL_FALSE;
+}
+
+// Pixel pack state and read framebuffer of the application, which are replaced, while the color buffer of a surface is read.
+typedef struct _EGLReadStateImpl
+{
+	GLint packBuffer;
+	GLint readFramebuffer;
+	GLint readBuffer;
+	GLint packAlignment;
+	GLint packRowLength;
+	GLint packSkipRows;
+	GLint packSkipPixels;
+} EGLReadStateImpl;
+
+// The buffer of the surface, which the default framebuffer renders into.
+static GLenum _eglInternalSurfaceBuffer(const EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerSurface->doubleBuffer || walkerSurface->frontBuffer || (walkerSurface->present && walkerSurface->present->current >= 0))
+	{
+		return GL_FRONT;
+	}
+
+	return GL_BACK;
+}
+
+// Selects the surface for reading instead of a framebuffer object of the application. The rows start at the pixel pack
+// buffer or client memory without any skipped pixels. The surface has to be the current read surface.
+static void _eglInternalBeginSurfaceRead(EGLReadStateImpl* state, const EGLSurfaceImpl* walkerSurface, GLuint packBuffer, GLint packAlignment, GLint packRowLength)
+{
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &state->packBuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &state->readFramebuffer);
+	glGetIntegerv(GL_PACK_ALIGNMENT, &state->packAlignment);
+	glGetIntegerv(GL_PACK_ROW_LENGTH, &state->packRowLength);
+	glGetIntegerv(GL_PACK_SKIP_ROWS, &state->packSkipRows);
+	glGetIntegerv(GL_PACK_SKIP_PIXELS, &state->packSkipPixels);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glGetIntegerv(GL_READ_BUFFER, &state->readBuffer);
+	glReadBuffer(_eglInternalSurfaceBuffer(walkerSurface));
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	glPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+	glPixelStorei(GL_PACK_SKIP_ROWS, 0);
+	glPixelStorei(GL_PACK_SKIP_PIXELS, 0);
+}
+
+static void _eglInternalEndSurfaceRead(const EGLReadStateImpl* state)
+{
+	glPixelStorei(GL_PACK_SKIP_PIXELS, state->packSkipPixels);
+	glPixelStorei(GL_PACK_SKIP_ROWS, state->packSkipRows);
+	glPixelStorei(GL_PACK_ROW_LENGTH, state->packRowLength);
+	glPixelStorei(GL_PACK_ALIGNMENT, state->packAlignment);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)state->packBuffer);
+
+	glReadBuffer((GLenum)state->readBuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)state->readFramebuffer);
+}
+
+static void _eglInternalReleaseClientMemoryBuffer(EGLClientMemoryImpl* clientMemory)
+{
+	// The buffer of another context can not be deleted here.
+	if (clientMemory->buffer && clientMemory->ctx == g_localStorage.currentCtx)
+	{
+		if (clientMemory->mapped)
+		{
+			GLint boundBuffer = 0;
+
+			glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &boundBuffer);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, clientMemory->buffer);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)boundBuffer);
+		}
+
+		glDeleteBuffers(1, &clientMemory->buffer);
+	}
+
+	clientMemory->path = _EGL_CLIENT_MEMORY_NONE;
+	clientMemory->buffer = 0;
+	clientMemory->mapped = 0;
+	clientMemory->ctx = 0;
+}
+
+// Selects the path with the fewest copies, which the current context does support. The pixel pack buffer binding is changed.
+static void _eglInternalCreateClientMemoryBuffer(EGLClientMemoryImpl* clientMemory)
+{
+	_eglInternalReleaseClientMemoryBuffer(clientMemory);
+
+	clientMemory->path = _EGL_CLIENT_MEMORY_DIRECT;
+	clientMemory->buffer = 0;
+	clientMemory->mapped = 0;
+	clientMemory->ctx = g_localStorage.currentCtx;
+
+	// The driver writes into the client memory. No copy at all.
+	if (((uintptr_t)clientMemory->memory % _EGL_CLIENT_MEMORY_PAGE_SIZE) == 0 && _eglInternalHasGLExtension("GL_AMD_pinned_memory"))
+	{
+		glGetError();
+
+		glGenBuffers(1, &clientMemory->buffer);
+		glBindBuffer(GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD, clientMemory->buffer);
+		glBufferData(GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD, (GLsizeiptr)clientMemory->size, clientMemory->memory, GL_STREAM_READ);
+		glBindBuffer(GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD, 0);
+
+		if (glGetError() == GL_NO_ERROR)
+		{
+			clientMemory->path = _EGL_CLIENT_MEMORY_PINNED;
+
+			return;
+		}
+
+		glDeleteBuffers(1, &clientMemory->buffer);
+		clientMemory->buffer = 0;
+	}
+
+	// The readback is asynchronous into a mapping, which stays valid. One copy into the client memory.
+	if (_eglInternalHasGLExtension("GL_ARB_buffer_storage"))
+	{
+		const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &clientMemory->buffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, clientMemory->buffer);
+		glBufferStorage(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)clientMemory->size, NULL, flags | GL_CLIENT_STORAGE_BIT);
+
+		clientMemory->mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)clientMemory->size, flags);
+
+		if (clientMemory->mapped)
+		{
+			clientMemory->path = _EGL_CLIENT_MEMORY_PERSISTENT;
+
+			return;
+		}
+
+		glDeleteBuffers(1, &clientMemory->buffer);
+		clientMemory->buffer = 0;
+	}
+}
+
+// Writes the color buffer of the current pbuffer into its client memory. Returns, when the memory is written.
+static EGLBoolean _eglInternalWriteClientMemory(EGLSurfaceImpl* walkerSurface)
+{
+	EGLClientMemoryImpl* clientMemory = walkerSurface->clientMemory;
+
+	EGLReadStateImpl readState;
+
+	_eglInternalBeginSurfaceRead(&readState, walkerSurface, 0, 4, clientMemory->stride / 4);
+
+	// A buffer of another context can not be used, so the path is selected again.
+	if (clientMemory->path == _EGL_CLIENT_MEMORY_NONE || clientMemory->ctx != g_localStorage.currentCtx)
+	{
+		_eglInternalCreateClientMemoryBuffer(clientMemory);
+	}
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, clientMemory->path == _EGL_CLIENT_MEMORY_DIRECT ? 0 : clientMemory->buffer);
+
+	glReadPixels(0, 0, clientMemory->width, clientMemory->height, GL_RGBA, GL_UNSIGNED_BYTE, clientMemory->path == _EGL_CLIENT_MEMORY_DIRECT ? clientMemory->memory : (void*)0);
+
+	_eglInternalEndSurfaceRead(&readState);
+
+	if (clientMemory->path == _EGL_CLIENT_MEMORY_DIRECT)
+	{
+		return EGL_TRUE;
+	}
+
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+	glDeleteSync(fence);
+
+	if (result == GL_WAIT_FAILED)
+	{
+		g_localStorage.error = EGL_BAD_ACCESS;
+
+		return EGL_FALSE;
+	}
+
+	if (clientMemory->path == _EGL_CLIENT_MEMORY_PERSISTENT)
+	{
+		memcpy(clientMemory->memory, clientMemory->mapped, clientMemory->size);
+	}
+
+	return EGL_TRUE;
+}
+
+// Reads the color buffer of the current pbuffer into its shared image, top down as the X server expects it.
+static EGLBoolean _eglInternalReadCopyImage(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLNativePixmapType target)
+{
+	EGLint width = 0;
+	EGLint height = 0;
+
+	if (!_eglInternalSurfaceSize(walkerDpy, walkerSurface, &width, &height) || width <= 0 || height <= 0)
+	{
+		g_localStorage.error = EGL_BAD_SURFACE;
+
+		return EGL_FALSE;
+	}
+
+	EGLShmImpl* copyImage = walkerSurface->copyImage;
+
+	if (copyImage && (copyImage->width != width || copyImage->height != height || copyImage->pixmap != target))
+	{
+		__destroyShm(walkerDpy, copyImage);
+		free(copyImage);
+		free(walkerSurface->copyRow);
+
+		walkerSurface->copyImage = 0;
+		walkerSurface->copyRow = 0;
+		copyImage = 0;
+	}
+
+	if (!copyImage)
+	{
+		copyImage = (EGLShmImpl*)calloc(1, sizeof(EGLShmImpl));
+
+		if (!copyImage)
+		{
+			g_localStorage.error = EGL_BAD_ALLOC;
+
+			return EGL_FALSE;
+		}
+
+		copyImage->pixmap = target;
+		copyImage->width = width;
+		copyImage->height = height;
+
+		if (!__createShmImage(copyImage, walkerDpy, &g_localStorage.error))
+		{
+			free(copyImage);
+
+			return EGL_FALSE;
+		}
+
+		walkerSurface->copyImage = copyImage;
+	}
+
+	// The extensions are walked only once per context.
+	EGLContextImpl* currentCtx = g_localStorage.currentCtx;
+
+	if (currentCtx->packInvert < 0)
+	{
+		currentCtx->packInvert = _eglInternalHasGLExtension("GL_MESA_pack_invert") ? 1 : 0;
+	}
+
+	const EGLBoolean invert = currentCtx->packInvert ? EGL_TRUE : EGL_FALSE;
+
+	if (!invert && !walkerSurface->copyRow)
+	{
+		walkerSurface->copyRow = (unsigned char*)malloc((size_t)copyImage->stride);
+
+		if (!walkerSurface->copyRow)
+		{
+			g_localStorage.error = EGL_BAD_ALLOC;
+
+			return EGL_FALSE;
+		}
+	}
+
+	EGLReadStateImpl readState;
+
+	_eglInternalBeginSurfaceRead(&readState, walkerSurface, 0, 4, copyImage->stride / 4);
+	if (invert)
+	{
+		glPixelStorei(GL_PACK_INVERT_MESA, GL_TRUE);
+	}
+
+	glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, copyImage->pixels);
+
+	if (invert)
+	{
+		glPixelStorei(GL_PACK_INVERT_MESA, GL_FALSE);
+	}
+	_eglInternalEndSurfaceRead(&readState);
+
+	if (!invert)
+	{
+		unsigned char* pixels = (unsigned char*)copyImage->pixels;
+		unsigned char* row = walkerSurface->copyRow;
+
+		for (EGLint y = 0; y < height / 2; y++)
+		{
+			unsigned char* top = pixels + (size_t)y * (size_t)copyImage->stride;
+			unsigned char* bottom = pixels + (size_t)(height - 1 - y) * (size_t)copyImage->stride;
+
+			memcpy(row, top, (size_t)copyImage->stride);
+			memcpy(top, bottom, (size_t)copyImage->stride);
+			memcpy(bottom, row, (size_t)copyImage->stride);
+		}
+	}
+
+	return EGL_TRUE;
+}
+
+//
+// Locked surfaces. Windows and pixmaps are mapped with a shared image, pbuffers with a bitmap, which is read and written with the current context.
+//
+
+static EGLBoolean _eglInternalIsLocked(const EGLSurfaceImpl* walkerSurface)
+{
+	return walkerSurface->lock && walkerSurface->lock->locked;
+}
+
+static void _eglInternalReleaseLockMemory(EGLDisplayImpl* walkerDpy, EGLLockImpl* lock)
+{
+	if (lock->image)
+	{
+		__destroyShm(walkerDpy, lock->image);
+		free(lock->image);
+
+		lock->image = 0;
+	}
+
+	if (lock->bitmap)
+	{
+		free(lock->bitmap);
+
+		lock->bitmap = 0;
+	}
+
+	lock->pixels = 0;
+	lock->pitch = 0;
+}
+
+// Creates the memory of the lock. The memory of the previous lock is kept, if the size of the surface did not change.
+static EGLBoolean _eglInternalPrepareLock(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLLockImpl* lock = walkerSurface->lock;
+
+	EGLint width = 0;
+	EGLint height = 0;
+
+	if (!_eglInternalSurfaceSize(walkerDpy, walkerSurface, &width, &height) || width <= 0 || height <= 0)
+	{
+		g_localStorage.error = EGL_BAD_SURFACE;
+
+		return EGL_FALSE;
+	}
+
+	if (lock->width != width || lock->height != height)
+	{
+		_eglInternalReleaseLockMemory(walkerDpy, lock);
+	}
+
+	lock->width = width;
+	lock->height = height;
+
+	if (walkerSurface->drawToPBuffer)
+	{
+		if (!lock->bitmap)
+		{
+			lock->bitmap = malloc((size_t)width * 4 * (size_t)height);
+
+			if (!lock->bitmap)
+			{
+				g_localStorage.error = EGL_BAD_ALLOC;
+
+				return EGL_FALSE;
+			}
+		}
+
+		lock->pixels = lock->bitmap;
+		lock->pitch = width * 4;
+		lock->origin = EGL_LOWER_LEFT_KHR;
+
+		return EGL_TRUE;
+	}
+
+	if (!lock->image)
+	{
+		EGLShmImpl* image = (EGLShmImpl*)calloc(1, sizeof(EGLShmImpl));
+
+		if (!image)
+		{
+			g_localStorage.error = EGL_BAD_ALLOC;
+
+			return EGL_FALSE;
+		}
+
+		image->pixmap = walkerSurface->drawToPixmap ? walkerSurface->pixmap : (EGLNativePixmapType)walkerSurface->win;
+		image->width = width;
+		image->height = height;
+
+		if (!__createShmImage(image, walkerDpy, &g_localStorage.error))
+		{
+			free(image);
+
+			if (g_localStorage.error == EGL_SUCCESS)
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+			}
+
+			return EGL_FALSE;
+		}
+
+		lock->image = image;
+	}
+
+	lock->pixels = lock->image->pixels;
+	lock->pitch = lock->image->stride;
+	lock->origin = EGL_UPPER_LEFT_KHR;
+
+	return EGL_TRUE;
+}
+
+// Reads the color buffer of the current pbuffer into the bitmap, rows bottom up.
+static void _eglInternalReadLockBitmap(EGLLockImpl* lock)
+{
+	GLint boundBuffer = 0;
+	GLint readFramebuffer = 0;
+	GLint packAlignment = 4;
+	GLint packRowLength = 0;
+
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &boundBuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glGetIntegerv(GL_PACK_ROW_LENGTH, &packRowLength);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glPixelStorei(GL_PACK_ROW_LENGTH, lock->pitch / 4);
+
+	glReadPixels(0, 0, lock->width, lock->height, GL_BGRA, GL_UNSIGNED_BYTE, lock->bitmap);
+
+	glPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)boundBuffer);
+}
+
+// Writes the bitmap into the color buffer of the current pbuffer. The bitmap is uploaded into a texture and blitted, as
+// glDrawPixels is not available in a core profile. The GL state is restored.
+static EGLBoolean _eglInternalWriteLockBitmap(EGLLockImpl* lock)
+{
+	static const GLenum capabilities[] = { GL_SCISSOR_TEST, GL_FRAMEBUFFER_SRGB };
+	const EGLint numberCapabilities = (EGLint)(sizeof(capabilities) / sizeof(capabilities[0]));
+
+	GLboolean enabled[sizeof(capabilities) / sizeof(capabilities[0])];
+	GLint boundBuffer = 0;
+	GLint drawFramebuffer = 0;
+	GLint readFramebuffer = 0;
+	GLint activeTexture = 0;
+	GLint boundTexture = 0;
+	GLint unpackAlignment = 4;
+	GLint unpackRowLength = 0;
+
+	for (EGLint i = 0; i < numberCapabilities; i++)
+	{
+		enabled[i] = glIsEnabled(capabilities[i]);
+	}
+	glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &boundBuffer);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+	glActiveTexture(GL_TEXTURE0);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	glGetIntegerv(GL_UNPACK_ROW_LENGTH, &unpackRowLength);
+
+	GLuint texture = 0;
+	GLuint framebuffer = 0;
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, lock->pitch / 4);
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, lock->width, lock->height, 0, GL_BGRA, GL_UNSIGNED_BYTE, lock->bitmap);
+
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+	EGLBoolean result = EGL_TRUE;
+
+	if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+	{
+		for (EGLint i = 0; i < numberCapabilities; i++)
+		{
+			glDisable(capabilities[i]);
+		}
+
+		glBlitFramebuffer(0, 0, lock->width, lock->height, 0, 0, lock->width, lock->height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+	else
+	{
+		result = EGL_FALSE;
+	}
+
+	for (EGLint i = 0; i < numberCapabilities; i++)
+	{
+		if (enabled[i])
+		{
+			glEnable(capabilities[i]);
+		}
+		else
+		{
+			glDisable(capabilities[i]);
+		}
+	}
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+	glDeleteFramebuffers(1, &framebuffer);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+	glDeleteTextures(1, &texture);
+	glActiveTexture((GLenum)activeTexture);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, unpackRowLength);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)boundBuffer);
+
+	return result;
+}
+
+// A locked pbuffer is read and written with the context, it is current to in the calling thread.
+static EGLBoolean _eglInternalIsLockCurrent(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	return walkerDpy->currentDraw == walkerSurface && walkerDpy->currentCtx == g_localStorage.currentCtx && g_localStorage.currentCtx != EGL_NO_CONTEXT_IMPL;
+}
+
+// Maps the locked surface, when the bitmap pointer is queried the first time. Without preserved pixels, nothing is read.
+static EGLBoolean _eglInternalMapLock(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface)
+{
+	EGLLockImpl* lock = walkerSurface->lock;
+
+	if (lock->mapped)
+	{
+		return EGL_TRUE;
+	}
+
+	if (lock->preservePixels)
+	{
+		if (lock->image)
+		{
+			if (!__readShmImage(walkerDpy, lock->image, &g_localStorage.error))
+			{
+				return EGL_FALSE;
+			}
+		}
+		else
+		{
+			if (!_eglInternalIsLockCurrent(walkerDpy, walkerSurface))
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+
+				return EGL_FALSE;
+			}
+
+			_eglInternalReadLockBitmap(lock);
+		}
+	}
+
+	lock->mapped = EGL_TRUE;
+
+	return EGL_TRUE;
+}
+
+static EGLBoolean _eglInternalQueryLock(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLint attribute, EGLAttribKHR* value)
+{
+	EGLLockImpl* lock = walkerSurface->lock;
+
+	switch (attribute)
+	{
+		case EGL_BITMAP_POINTER_KHR:
+		case EGL_BITMAP_PITCH_KHR:
+		{
+			if (!lock || !lock->locked)
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+
+				return EGL_FALSE;
+			}
+
+			if (attribute == EGL_BITMAP_PITCH_KHR)
+			{
+				*value = (EGLAttribKHR)lock->pitch;
+
+				return EGL_TRUE;
+			}
+
+			if (!_eglInternalMapLock(walkerDpy, walkerSurface))
+			{
+				return EGL_FALSE;
+			}
+
+			*value = (EGLAttribKHR)lock->pixels;
+
+			return EGL_TRUE;
+		}
+		case EGL_BITMAP_ORIGIN_KHR:
+			*value = walkerSurface->drawToPBuffer ? EGL_LOWER_LEFT_KHR : EGL_UPPER_LEFT_KHR;
+
+			return EGL_TRUE;
+		// 32 bit pixels with the byte order of GL_BGRA, as X servers on little endian machines and GL_UNSIGNED_BYTE do store them.
+		case EGL_BITMAP_PIXEL_RED_OFFSET_KHR:
+			*value = 16;
+
+			return EGL_TRUE;
+		case EGL_BITMAP_PIXEL_GREEN_OFFSET_KHR:
+			*value = 8;
+
+			return EGL_TRUE;
+		case EGL_BITMAP_PIXEL_BLUE_OFFSET_KHR:
+		case EGL_BITMAP_PIXEL_LUMINANCE_OFFSET_KHR:
+			*value = 0;
+
+			return EGL_TRUE;
+		case EGL_BITMAP_PIXEL_ALPHA_OFFSET_KHR:
+		{
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig && walkerConfig->configId != walkerSurface->configId)
+			{
+				walkerConfig = walkerConfig->next;
+			}
+
+			*value = (walkerConfig && walkerConfig->alphaSize > 0) ? 24 : 0;
+
+			return EGL_TRUE;
+		}
+		case EGL_BITMAP_PIXEL_SIZE_KHR:
+			*value = 32;
+
+			return EGL_TRUE;
+	}
+
+	g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+	return EGL_FALSE;
+}
+
+// Attributes, which are not defined for the type of the surface, leave the value unchanged.
+static EGLBoolean _eglInternalQuerySurface(EGLDisplayImpl* walkerDpy, EGLSurfaceImpl* walkerSurface, EGLint attribute, EGLAttribKHR* value)
+{
+	switch (attribute)
+	{
+		case EGL_CONFIG_ID:
+		{
+			*value = walkerSurface->configId;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_WIDTH:
+		case EGL_HEIGHT:
+		{
+			EGLint width = 0;
+			EGLint height = 0;
+
+			if (!_eglInternalSurfaceSize(walkerDpy, walkerSurface, &width, &height))
+			{
+				g_localStorage.error = EGL_BAD_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			*value = attribute == EGL_WIDTH ? width : height;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_GL_COLORSPACE:
+		{
+			*value = walkerSurface->colorspace;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_HORIZONTAL_RESOLUTION:
+		case EGL_VERTICAL_RESOLUTION:
+		case EGL_PIXEL_ASPECT_RATIO:
+		{
+			*value = EGL_UNKNOWN;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_LARGEST_PBUFFER:
+		{
+			if (walkerSurface->drawToPBuffer)
+			{
+				*value = walkerSurface->largestPbuffer;
+			}
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_MIPMAP_TEXTURE:
+		{
+			if (walkerSurface->drawToPBuffer)
+			{
+				*value = EGL_FALSE;
+			}
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_MIPMAP_LEVEL:
+		{
+			if (walkerSurface->drawToPBuffer)
+			{
+				*value = walkerSurface->mipmapLevel;
+			}
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_TEXTURE_FORMAT:
+		case EGL_TEXTURE_TARGET:
+		{
+			if (walkerSurface->drawToPBuffer)
+			{
+				EGLenum texture = attribute == EGL_TEXTURE_FORMAT ? walkerSurface->textureFormat : walkerSurface->textureTarget;
+
+				*value = texture ? texture : EGL_NO_TEXTURE;
+			}
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_MULTISAMPLE_RESOLVE:
+		{
+			*value = walkerSurface->multisampleResolve;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_RENDER_BUFFER:
+		{
+			// The requested buffer, which can differ from the one rendered into until the next swap.
+			*value = walkerSurface->renderBuffer;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_SWAP_BEHAVIOR:
+		{
+			*value = walkerSurface->swapBehavior;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_TIMESTAMPS_ANDROID:
+		{
+			*value = walkerSurface->timestamps;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_MAX_FRAMES_IN_FLIGHT_DESKTOP:
+		{
+			*value = walkerSurface->maxFramesInFlight;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_FRAME_THROTTLE_BLOCKING_DESKTOP:
+		{
+			*value = walkerSurface->throttleBlocking;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_ASYNC_PRESENT_DESKTOP:
+		{
+			*value = walkerSurface->asyncPresent;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_FRAMES_IN_FLIGHT_DESKTOP:
+		{
+			*value = walkerSurface->framesInFlight;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_PEAK_FRAMES_IN_FLIGHT_DESKTOP:
+		{
+			*value = walkerSurface->peakFramesInFlight;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_VG_ALPHA_FORMAT:
+		{
+			*value = EGL_VG_ALPHA_FORMAT_NONPRE;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_VG_COLORSPACE:
+		{
+			*value = EGL_VG_COLORSPACE_sRGB;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_BUFFER_AGE_EXT:
+		{
+			if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface))
+			{
+				g_localStorage.error = EGL_BAD_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			// Zero tells, that the content is undefined. Only the back buffer of a window has a known age.
+			EGLint age = 0;
+
+			if (!walkerSurface->drawToWindow || !__querySurfaceAge(walkerDpy, walkerSurface, &age))
+			{
+				age = 0;
+			}
+
+			// A partial present copies out of the back buffer and a preserved swap copies back into it.
+			if (walkerSurface->backBufferKept)
+			{
+				age = 1;
+			}
+
+			// The pixmap of an asynchronously presented window keeps the frame, which was presented from it.
+			if (walkerSurface->present && walkerSurface->present->current >= 0)
+			{
+				const EGLPresentImpl* present = walkerSurface->present;
+				const EGLPresentBufferImpl* buffer = &present->buffers[present->current];
+
+				age = buffer->frame ? (EGLint)(present->numberFrames - buffer->frame + 1) : 0;
+			}
+
+			walkerSurface->ageQueried = EGL_TRUE;
+
+			*value = age;
+
+			return EGL_TRUE;
+		}
+		break;
+		case EGL_READBACK_FORMAT_DESKTOP:
+		{
+			*value = walkerSurface->readbackFormat ? walkerSurface->readbackFormat : EGL_READBACK_FORMAT_RGBA_DESKTOP;
+
+			return EGL_TRUE;
+		}
+		break;
+	}
+
+	return _eglInternalQueryLock(walkerDpy, walkerSurface, attribute, value);
+}
+
+static int _ChooseConfig_sort_predicate(const void* _lhs, const void* _rhs)
+{
+	const EGLConfigImpl* lhs = *(const EGLConfigImpl**)_lhs;
+	const EGLConfigImpl* rhs = *(const EGLConfigImpl**)_rhs;
+
+	if (lhs->configCaveat == rhs->configCaveat)
+	{
+		if (lhs->colorBufferType == rhs->colorBufferType)
+		{
+			EGLint color_bits[2] = { 0, 0 };
+			switch (lhs->colorBufferType)
+			{
+			case EGL_RGB_BUFFER:
+				color_bits[0] = lhs->redSize + lhs->greenSize + lhs->blueSize + lhs->alphaSize;
+				color_bits[1] = rhs->redSize + rhs->greenSize + rhs->blueSize + rhs->alphaSize;
+				break;
+			case EGL_LUMINANCE_BUFFER:
+				color_bits[0] = lhs->luminanceSize + lhs->alphaSize;
+				color_bits[1] = rhs->luminanceSize + rhs->alphaSize;
+				break;
+			default:
+				break;
+			}
+
+			if (color_bits[0] == color_bits[1])
+			{
+				if (lhs->bufferSize == rhs->bufferSize)
+				{
+					if (lhs->sampleBuffers == rhs->sampleBuffers)
+					{
+						if (lhs->samples == rhs->samples)
+						{
+							if (lhs->depthSize == rhs->depthSize)
+							{
+								if (lhs->stencilSize == rhs->stencilSize)
+								{
+									if (lhs->alphaMaskSize == rhs->alphaMaskSize)
+									{
+										// skip rule 10 since it's impl-defined
+										// 10. Special: EGL_NATIVE_VISUAL_TYPE (the actual sort order is implementation-defined, depending on the meaning of native visual types).
+
+										// 11. Smaller EGL_CONFIG_ID (guarantees a unique ordering)
+										return (lhs->configId - rhs->configId);
+									}
+									else return (lhs->alphaMaskSize - rhs->alphaMaskSize); // 9. Smaller EGL_ALPHA_MASK_SIZE
+								}
+								else return (lhs->stencilSize - rhs->stencilSize); // 8. Smaller EGL_STENCIL_SIZE
+							}
+							else return (lhs->depthSize - rhs->depthSize); // 7. Smaller EGL_DEPTH_SIZE
+						}
+						else return (lhs->samples - rhs->samples); // 6. Smaller EGL_SAMPLES
+					}
+					else return (lhs->sampleBuffers - rhs->sampleBuffers); // 5. Smaller EGL_SAMPLE_BUFFERS
+				}
+				else return (lhs->bufferSize - rhs->bufferSize); // 4. Smaller EGL_BUFFER_SIZE
+			}
+			else return color_bits[1] - color_bits[0]; // 3. by larger total number of color bits
+		}
+		else return (lhs->colorBufferType - rhs->colorBufferType); // 2. by EGL_COLOR_BUFFER_TYPE
+	}
+	else return (lhs->configCaveat - rhs->configCaveat); // 1. by EGL_CONFIG_CAVEAT
+}
+
+EGLBoolean _eglChooseConfig(EGLDisplay dpy, const EGLint *attrib_list, EGLConfig *configs, EGLint config_size, EGLint *num_config)
+{
+	if (!attrib_list)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (!configs)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (config_size == 0)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (!num_config)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			// The config table does not change, while it is published.
+			if (!_eglInternalConfigsPublished(walkerDpy))
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLint attribListIndex = 0;
+
+			EGLConfigImpl config;
+
+			_eglInternalSetDefaultConfig(&config);
+
+			while (attrib_list[attribListIndex] != EGL_NONE)
+			{
+				EGLint value = attrib_list[attribListIndex + 1];
+
+				const EGLConfigAttribSchemaImpl* schema = _eglInternalFindConfigSchema(attrib_list[attribListIndex]);
+
+				if (!schema || !_eglInternalValidConfigAttrib(schema->valid, value))
+				{
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				_EGL_CONFIG_VALUE(&config, *schema) = value;
+
+				attribListIndex += 2;
+
+				// More than 28 entries can not exist.
+				if (attribListIndex >= 28 * 2)
+				{
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+			}
+			config.drawToWindow = (config.surfaceType & EGL_WINDOW_BIT) ? EGL_TRUE : EGL_FALSE;
+			config.drawToPixmap = (config.surfaceType & EGL_PIXMAP_BIT) ? EGL_TRUE : EGL_FALSE;
+			config.drawToPBuffer = (config.surfaceType & EGL_PBUFFER_BIT) ? EGL_TRUE : EGL_FALSE;
+
+			EGLConfigCriterionImpl criteria[_EGL_CONFIG_SCHEMA_SIZE];
+
+			const EGLint numberCriteria = _eglInternalConfigCriteria(&config, criteria);
+
+			// Only the configs of the rarest requested surface type can match.
+			EGLint numberCandidates;
+			const EGLint* candidates = _eglInternalFindSurfaceTypeIndex(walkerDpy, config.surfaceType, &numberCandidates);
+
+			// The render buffer of a window defaults to the back buffer. Other surfaces do not depend on double buffering.
+			const EGLBoolean matchDoubleBuffer = (config.surfaceType & EGL_WINDOW_BIT) && config.doubleBuffer != EGL_DONT_CARE;
+
+			#define stack_mem_sz (1ull << 13) // 8k
+			char stack_mem[stack_mem_sz];
+			const EGLint max_configs = stack_mem_sz / sizeof(EGLConfig);
+			EGLConfig* configsOnStack = (EGLConfig*)stack_mem;
+
+			EGLint configIndex = 0;
+
+			for (EGLint candidateIndex = 0; candidateIndex < numberCandidates && configIndex < max_configs; candidateIndex++)
+			{
+				EGLConfigImpl* walkerConfig = &walkerDpy->configTable[candidates ? candidates[candidateIndex] : candidateIndex].config;
+
+				if (!_eglInternalMatchConfig(walkerConfig, criteria, numberCriteria))
+				{
+					continue;
+				}
+
+				if (matchDoubleBuffer && config.doubleBuffer != walkerConfig->doubleBuffer)
+				{
+					continue;
+				}
+
+				//
+
+				configsOnStack[configIndex] = walkerConfig;
+
+				configIndex++;
+			}
+
+			if (configIndex)
+				qsort(configsOnStack, configIndex, sizeof(*configs), &_ChooseConfig_sort_predicate);
+
+			*num_config = (std::min)(configIndex, config_size);
+			memcpy(configs, configsOnStack, *num_config*sizeof(EGLConfig));
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+	
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+// comment this to bring back original code
+#define FIXED_SHARE_CONTEXT
+EGLContext _eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint *attrib_list)
+{
+	if (!attrib_list)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_NO_CONTEXT;
+	}
+
+	if (g_localStorage.api == EGL_NONE)
+	{
+		g_localStorage.error = EGL_BAD_MATCH;
+
+		return EGL_NO_CONTEXT;
+	}
+
+	EGLint requested_version[2]{ 1, 0 };
+	EGLBoolean virtualAttrib = EGL_FALSE;
+	EGLBoolean virtualCtx = EGL_FALSE;
+	for (EGLint i = 0; attrib_list[i] != EGL_NONE; i += 2)
+	{
+		switch (attrib_list[i])
+		{
+		case EGL_CONTEXT_MAJOR_VERSION:
+			requested_version[0] = attrib_list[i + 1];
+			break;
+		case EGL_CONTEXT_MINOR_VERSION:
+			requested_version[1] = attrib_list[i + 1];
+			break;
+		case EGL_VIRTUAL_CONTEXT_DESKTOP:
+			virtualAttrib = EGL_TRUE;
+			virtualCtx = attrib_list[i + 1] ? EGL_TRUE : EGL_FALSE;
+			break;
+		}
+	}
+
+	if (virtualCtx && !g_virtualContextSupported)
+	{
+		g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+		return EGL_NO_CONTEXT;
+	}
+
+	if (virtualCtx && share_context != EGL_NO_CONTEXT)
+	{
+		g_localStorage.error = EGL_BAD_MATCH;
+
+		return EGL_NO_CONTEXT;
+	}
+
+	if (g_localStorage.api == EGL_OPENGL_API)
+	{
+		if (requested_version[0] > g_GL_max_supported_version[0] || requested_version[1] > g_GL_max_supported_version[1])
+			return EGL_NO_CONTEXT;
+	}
+	else if (g_localStorage.api == EGL_OPENGL_ES_API)
+	{
+		if (requested_version[0] > g_ES_max_supported_version[0] || requested_version[1] > g_ES_max_supported_version[1])
+			return EGL_NO_CONTEXT;
+	}
+	else
+	{
+		return EGL_NO_CONTEXT;
+	}
+
+
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					EGLint target_attrib_list[CONTEXT_ATTRIB_LIST_SIZE];
+
+					if (g_localStorage.api == EGL_OPENGL_ES_API && (walkerConfig->conformant & EGL_OPENGL_ES3_BIT) == 0)
+					{
+						return EGL_FALSE;
+					}
+					if (virtualAttrib)
+					{
+						// The native layer does not know the attribute.
+						EGLint* native_attrib_list = _eglInternalRemoveAttrib(attrib_list, EGL_VIRTUAL_CONTEXT_DESKTOP);
+
+						if (!native_attrib_list)
+						{
+							g_localStorage.error = EGL_BAD_ALLOC;
+
+							return EGL_FALSE;
+						}
+
+						const EGLBoolean processed = __processAttribList(g_localStorage.api, target_attrib_list, native_attrib_list, &g_localStorage.error);
+
+						free(native_attrib_list);
+
+						if (!processed)
+						{
+							return EGL_FALSE;
+						}
+					}
+					else if (!__processAttribList(g_localStorage.api, target_attrib_list, attrib_list, &g_localStorage.error))
+					{
+						return EGL_FALSE;
+					}
+
+					EGLContextImpl* sharedCtx = 0;
+
+					if (share_context != EGL_NO_CONTEXT)
+					{
+						EGLDisplayImpl* sharedWalkerDpy = g_globalStorage.rootDpy;
+
+						while (sharedWalkerDpy)
+						{
+							EGLContextImpl* sharedWalkerCtx = sharedWalkerDpy->rootCtx;
+
+							while (sharedWalkerCtx)
+							{
+								if ((EGLContext)sharedWalkerCtx == share_context)
+								{
+									if (!sharedWalkerCtx->initialized || sharedWalkerCtx->destroy)
+									{
+										g_localStorage.error = EGL_BAD_CONTEXT;
+
+										return EGL_FALSE;
+									}
+
+									// The objects of a virtual context belong to its host.
+									if (sharedWalkerCtx->virtualHost)
+									{
+										g_localStorage.error = EGL_BAD_MATCH;
+
+										return EGL_FALSE;
+									}
+
+									sharedCtx = sharedWalkerCtx;
+
+									break;
+								}
+
+								sharedWalkerCtx = sharedWalkerCtx->next;
+							}
+
+							sharedWalkerDpy = sharedWalkerDpy->next;
+						}
+
+						if (!sharedCtx)
+						{
+							g_localStorage.error = EGL_BAD_CONTEXT;
+
+							return EGL_FALSE;
+						}
+					}
+
+					EGLContextImpl* newCtx = (EGLContextImpl*)malloc(sizeof(EGLContextImpl));
+
+					if (!newCtx)
+					{
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_FALSE;
+					}
+
+					// Move the atttibutes for later creation.
+					memcpy(newCtx->attribList, target_attrib_list, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
+
+					newCtx->initialized = EGL_TRUE;
+					newCtx->destroy = EGL_FALSE;
+					newCtx->configId = walkerConfig->configId;
+					newCtx->sharedCtx = sharedCtx;
+					newCtx->rootCtxList = 0;
+					newCtx->createTime = _eglInternalGetTime();
+					newCtx->firstFrameTime = 0;
+					newCtx->pooled = EGL_FALSE;
+					newCtx->packInvert = -1;
+					newCtx->virtualHost = 0;
+					newCtx->virtualState = 0;
+					newCtx->virtualCtxList = 0;
+
+					if (virtualCtx)
+					{
+						newCtx->virtualState = (EGLVirtualStateImpl*)malloc(sizeof(EGLVirtualStateImpl));
+
+						if (newCtx->virtualState)
+						{
+							_eglInternalSetDefaultVirtualState(newCtx->virtualState);
+
+							newCtx->virtualHost = _eglInternalAcquireVirtualHost(walkerDpy, newCtx->configId, newCtx->attribList);
+						}
+
+						if (!newCtx->virtualHost)
+						{
+							free(newCtx->virtualState);
+
+							free(newCtx);
+
+							g_localStorage.error = EGL_BAD_ALLOC;
+
+							return EGL_FALSE;
+						}
+					}
+
+					newCtx->next = walkerDpy->rootCtx;
+					walkerDpy->rootCtx = newCtx;
+
+					return (EGLContext)newCtx;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONFIG;
+
+			return EGL_NO_CONTEXT;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_CONTEXT;
+}
+
+EGLBoolean _eglCopyBuffers(EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType target)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					if (!target)
+					{
+						g_localStorage.error = EGL_BAD_NATIVE_PIXMAP;
+
+						return EGL_FALSE;
+					}
+
+					const EGLBoolean current = walkerDpy->currentDraw == walkerSurface && walkerDpy->currentCtx == g_localStorage.currentCtx && g_localStorage.currentCtx != EGL_NO_CONTEXT_IMPL;
+
+					if (walkerSurface->drawToPBuffer)
+					{
+						// The pixels are read with the context of the pbuffer. The default framebuffer reads from the read surface.
+						if (!current || walkerDpy->currentRead != walkerSurface)
+						{
+							g_localStorage.error = EGL_BAD_SURFACE;
+
+							return EGL_FALSE;
+						}
+
+						if (!_eglInternalReadCopyImage(walkerDpy, walkerSurface, target))
+						{
+							return EGL_FALSE;
+						}
+					}
+					else if (current)
+					{
+						// The X server copies the drawable, so the rendering has to be finished.
+						glFinish();
+					}
+
+					return __copyBuffers(walkerDpy, walkerSurface, target, &g_localStorage.error);
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLSurface _eglCreatePbufferSurface(EGLDisplay dpy, EGLConfig config, const EGLint* attrib_list)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+
+					if (!newSurface)
+					{
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_NO_SURFACE;
+					}
+
+					memset(newSurface, 0, sizeof(EGLSurfaceImpl));
+
+					newSurface->readbackFormat = EGL_READBACK_FORMAT_RGBA_DESKTOP;
+					newSurface->textureFormat = EGL_NO_TEXTURE;
+					newSurface->textureTarget = EGL_NO_TEXTURE;
+
+					EGLint width = 0;
+					EGLint height = 0;
+					EGLBoolean largestPbuffer = EGL_FALSE;
+
+					EGLint attribListIndex = 0;
+
+					while (attrib_list && attrib_list[attribListIndex] != EGL_NONE)
+					{
+						EGLint value = attrib_list[attribListIndex + 1];
+
+						switch (attrib_list[attribListIndex])
+						{
+							case EGL_READBACK_FORMAT_DESKTOP:
+							{
+								if (value != EGL_READBACK_FORMAT_RGBA_DESKTOP && value != EGL_READBACK_FORMAT_NV12_DESKTOP && value != EGL_READBACK_FORMAT_I420_DESKTOP)
+								{
+									free(newSurface);
+
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_NO_SURFACE;
+								}
+
+								newSurface->readbackFormat = (EGLenum)value;
+							}
+							break;
+							case EGL_TEXTURE_FORMAT:
+							{
+								if ((value != EGL_NO_TEXTURE && value != EGL_TEXTURE_RGB && value != EGL_TEXTURE_RGBA) ||
+									(value == EGL_TEXTURE_RGB && walkerConfig->bindToTextureRGB != EGL_TRUE) ||
+									(value == EGL_TEXTURE_RGBA && walkerConfig->bindToTextureRGBA != EGL_TRUE))
+								{
+									free(newSurface);
+
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_NO_SURFACE;
+								}
+
+								newSurface->textureFormat = (EGLenum)value;
+							}
+							break;
+							case EGL_TEXTURE_TARGET:
+							{
+								if (value != EGL_NO_TEXTURE && value != EGL_TEXTURE_2D)
+								{
+									free(newSurface);
+
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_NO_SURFACE;
+								}
+
+								newSurface->textureTarget = (EGLenum)value;
+							}
+							break;
+							case EGL_MIPMAP_TEXTURE:
+							{
+								// Texture from pixmap does bind the base level only.
+								if (value != EGL_FALSE)
+								{
+									free(newSurface);
+
+									g_localStorage.error = EGL_BAD_MATCH;
+
+									return EGL_NO_SURFACE;
+								}
+							}
+							break;
+							case EGL_WIDTH:
+								width = value;
+							break;
+							case EGL_HEIGHT:
+								height = value;
+							break;
+							case EGL_LARGEST_PBUFFER:
+								largestPbuffer = value ? EGL_TRUE : EGL_FALSE;
+							break;
+							case EGL_GL_COLORSPACE:
+							{
+								if (value != EGL_GL_COLORSPACE_LINEAR && value != EGL_GL_COLORSPACE_SRGB)
+								{
+									free(newSurface);
+
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_NO_SURFACE;
+								}
+							}
+							break;
+							// OpenVG is not supported, so the attributes are only validated.
+							case EGL_VG_COLORSPACE:
+							{
+								if (value != EGL_VG_COLORSPACE_sRGB && value != EGL_VG_COLORSPACE_LINEAR)
+								{
+									free(newSurface);
+
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_NO_SURFACE;
+								}
+							}
+							break;
+							case EGL_VG_ALPHA_FORMAT:
+							{
+								if (value != EGL_VG_ALPHA_FORMAT_NONPRE && value != EGL_VG_ALPHA_FORMAT_PRE)
+								{
+									free(newSurface);
+
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_NO_SURFACE;
+								}
+							}
+							break;
+							default:
+							{
+								free(newSurface);
+
+								g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+								return EGL_NO_SURFACE;
+							}
+							break;
+						}
+
+						attribListIndex += 2;
+					}
+
+					if (width < 0 || height < 0)
+					{
+						free(newSurface);
+
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_NO_SURFACE;
+					}
+
+					// Either both or none has to be specified.
+					if ((newSurface->textureFormat == EGL_NO_TEXTURE) != (newSurface->textureTarget == EGL_NO_TEXTURE))
+					{
+						free(newSurface);
+
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_NO_SURFACE;
+					}
+
+					if (newSurface->textureFormat != EGL_NO_TEXTURE)
+					{
+						if (!walkerConfig->drawToPBuffer)
+						{
+							free(newSurface);
+
+							g_localStorage.error = EGL_BAD_MATCH;
+
+							return EGL_NO_SURFACE;
+						}
+
+						// A pixmap is not limited like a pbuffer, so the largest pbuffer is the maximum of the config.
+						if (largestPbuffer && walkerConfig->maxPBufferWidth > 0 && width > walkerConfig->maxPBufferWidth)
+						{
+							width = walkerConfig->maxPBufferWidth;
+						}
+						if (largestPbuffer && walkerConfig->maxPBufferHeight > 0 && height > walkerConfig->maxPBufferHeight)
+						{
+							height = walkerConfig->maxPBufferHeight;
+						}
+
+						// The color buffer is the pixmap, so binding it to a texture needs no copy. A pixmap can not be empty.
+						if (!__createTexturePixmap(&newSurface->nativeSurfaceContainer, walkerDpy, walkerConfig, newSurface->textureFormat, width > 0 ? width : 1, height > 0 ? height : 1, &g_localStorage.error))
+						{
+							free(newSurface);
+
+							if (g_localStorage.error == EGL_SUCCESS)
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+							}
+
+							return EGL_NO_SURFACE;
+						}
+
+						newSurface->drawToWindow = EGL_FALSE;
+						newSurface->drawToPixmap = EGL_FALSE;
+						newSurface->drawToPBuffer = EGL_TRUE;
+						newSurface->doubleBuffer = EGL_FALSE;
+						newSurface->configId = walkerConfig->configId;
+
+						newSurface->initialized = EGL_TRUE;
+						newSurface->destroy = EGL_FALSE;
+					}
+					else if (!__createPbufferSurface(newSurface, attrib_list, walkerDpy, walkerConfig, &g_localStorage.error))
+					{
+						free(newSurface);
+
+						return EGL_NO_SURFACE;
+					}
+
+					_eglInternalInitSurfaceState(walkerDpy, newSurface, attrib_list);
+
+					// The size of an empty pbuffer stays zero, although its pixmap has one pixel.
+					if (newSurface->textureFormat != EGL_NO_TEXTURE)
+					{
+						newSurface->width = width;
+						newSurface->height = height;
+					}
+
+					newSurface->next = walkerDpy->rootSurface;
+
+					walkerDpy->rootSurface = newSurface;
+
+					return (EGLSurface)newSurface;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONFIG;
+
+			return EGL_NO_SURFACE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+	
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_SURFACE;
+}
+
+EGLSurface _eglCreatePixmapSurface(EGLDisplay dpy, EGLConfig config, EGLNativePixmapType pixmap, const EGLint *attrib_list)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+
+					if (!newSurface)
+					{
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_NO_SURFACE;
+					}
+
+					memset(newSurface, 0, sizeof(EGLSurfaceImpl));
+
+					if (!__createPixmapSurface(newSurface, pixmap, attrib_list, walkerDpy, walkerConfig, &g_localStorage.error))
+					{
+						free(newSurface);
+
+						if (g_localStorage.error == EGL_SUCCESS)
+						{
+							g_localStorage.error = EGL_BAD_NATIVE_PIXMAP;
+						}
+
+						return EGL_NO_SURFACE;
+					}
+
+					_eglInternalInitSurfaceState(walkerDpy, newSurface, attrib_list);
+
+					newSurface->next = walkerDpy->rootSurface;
+
+					walkerDpy->rootSurface = newSurface;
+
+					return (EGLSurface)newSurface;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONFIG;
+
+			return EGL_NO_SURFACE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_SURFACE;
+}
+
+EGLSurface _eglCreateWindowSurface(EGLDisplay dpy, EGLConfig config, EGLNativeWindowType win, const EGLint *attrib_list)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+
+					if (!newSurface)
+					{
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_NO_SURFACE;
+					}
+
+					memset(newSurface, 0, sizeof(EGLSurfaceImpl));
+
+					if (!__createWindowSurface(newSurface, win, attrib_list, walkerDpy, walkerConfig, &g_localStorage.error))
+					{
+						free(newSurface);
+
+						return EGL_NO_SURFACE;
+					}
+
+					_eglInternalInitSurfaceState(walkerDpy, newSurface, attrib_list);
+
+					newSurface->next = walkerDpy->rootSurface;
+
+					walkerDpy->rootSurface = newSurface;
+
+					return (EGLSurface)newSurface;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONFIG;
+
+			return EGL_NO_SURFACE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+	
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_SURFACE;
+}
+
+EGLBoolean _eglDestroyContext(EGLDisplay dpy, EGLContext ctx)
+{
+	EGLBoolean success = EGL_FALSE;
+	{
+		auto _rl = g_globalStorage.placeRootDpy_readlock();
+		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+		while (walkerDpy)
+		{
+			if ((EGLDisplay)walkerDpy == dpy)
+			{
+				guard_t _{ walkerDpy->mutex };
+
+				if (!walkerDpy->initialized || walkerDpy->destroy)
+				{
+					g_localStorage.error = EGL_NOT_INITIALIZED;
+
+					return EGL_FALSE;
+				}
+
+				EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+
+				while (walkerCtx)
+				{
+					if ((EGLContext)walkerCtx == ctx)
+					{
+						if (!walkerCtx->initialized || walkerCtx->destroy)
+						{
+							g_localStorage.error = EGL_BAD_CONTEXT;
+
+							return EGL_FALSE;
+						}
+
+						walkerCtx->initialized = EGL_FALSE;
+						walkerCtx->destroy = EGL_TRUE;
+
+						success = EGL_TRUE;
+						break;
+					}
+
+					walkerCtx = walkerCtx->next;
+				}
+
+				g_localStorage.error = EGL_BAD_CONTEXT;
+
+				if (!success)
+					return EGL_FALSE;
+			}
+
+			walkerDpy = walkerDpy->next;
+		}
+	}
+	
+	if (success)
+		_eglInternalCleanup();
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglDestroySurface(EGLDisplay dpy, EGLSurface surface)
+{
+	EGLBoolean success = EGL_FALSE;
+
+	{
+		auto _rl = g_globalStorage.placeRootDpy_readlock();
+		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+		while (walkerDpy)
+		{
+			if ((EGLDisplay)walkerDpy == dpy)
+			{
+				guard_t _{ walkerDpy->mutex };
+
+				if (!walkerDpy->initialized || walkerDpy->destroy)
+				{
+					g_localStorage.error = EGL_NOT_INITIALIZED;
+
+					return EGL_FALSE;
+				}
+
+				EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+				while (walkerSurface)
+				{
+					if ((EGLSurface)walkerSurface == surface)
+					{
+						if (!walkerSurface->initialized || walkerSurface->destroy)
+						{
+							g_localStorage.error = EGL_BAD_SURFACE;
+
+							return EGL_FALSE;
+						}
+
+						walkerSurface->initialized = EGL_FALSE;
+						walkerSurface->destroy = EGL_TRUE;
+
+						// The present thread swaps the window, so it is stopped first.
+						_eglInternalReleasePresent(walkerDpy, walkerSurface);
+
+						if (walkerSurface->textureFormat == EGL_TEXTURE_RGB || walkerSurface->textureFormat == EGL_TEXTURE_RGBA)
+						{
+							if (walkerSurface->textureBound)
+							{
+								__releaseTexImage(walkerDpy, &walkerSurface->nativeSurfaceContainer);
+							}
+
+							__destroyTexturePixmap(walkerDpy, &walkerSurface->nativeSurfaceContainer);
+						}
+						else
+						{
+							__destroySurface(walkerDpy->display_id, walkerSurface);
+						}
+
+						if (walkerSurface->copyImage)
+						{
+							__destroyShm(walkerDpy, walkerSurface->copyImage);
+						}
+
+						if (walkerSurface->lock && walkerSurface->lock->image)
+						{
+							__destroyShm(walkerDpy, walkerSurface->lock->image);
+						}
+
+						_eglInternalReleasePreserve(walkerSurface);
+						_eglInternalReleaseFlightFences(walkerSurface);
+						_eglInternalReleaseReadbacks(walkerSurface);
+
+						if (walkerSurface->clientMemory)
+						{
+							_eglInternalReleaseClientMemoryBuffer(walkerSurface->clientMemory);
+						}
+
+						success = EGL_TRUE;
+						break;
+					}
+
+					walkerSurface = walkerSurface->next;
+				}
+
+				g_localStorage.error = EGL_BAD_SURFACE;
+
+				if (!success)
+					return EGL_FALSE;
+			}
+
+			walkerDpy = walkerDpy->next;
+		}
+	}
+
+	if (success)
+		_eglInternalCleanup();
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return success;
+}
+
+EGLBoolean _eglGetConfigAttrib(EGLDisplay dpy, EGLConfig config, EGLint attribute, EGLint *value)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			// The config table does not change, while it is published.
+			if (!_eglInternalConfigsPublished(walkerDpy))
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			const EGLConfigImpl* walkerConfig = _eglInternalFindConfig(walkerDpy, config);
+
+			if (!walkerConfig)
+			{
+				g_localStorage.error = EGL_BAD_CONFIG;
+
+				return EGL_FALSE;
+			}
+
+			const EGLint offset = _eglInternalConfigAttribOffset(attribute);
+
+			if (offset < 0)
+			{
+				g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+				return EGL_FALSE;
+			}
+
+			if (value)
+			{
+				*value = _eglInternalConfigAttrib(walkerConfig, offset);
+			}
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglGetConfigs(EGLDisplay dpy, EGLConfig *configs, EGLint config_size, EGLint *num_config)
+{
+	if (!configs)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (config_size == 0)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (!num_config)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			// The config table does not change, while it is published.
+			if (!_eglInternalConfigsPublished(walkerDpy))
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLint configIndex = 0;
+
+			while (configIndex < walkerDpy->numberConfigs && configIndex < config_size)
+			{
+				configs[configIndex] = &walkerDpy->configTable[configIndex].config;
+
+				configIndex++;
+			}
+
+			*num_config = configIndex;
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLDisplay _eglGetCurrentDisplay(void)
+{
+	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		{
+			return (EGLDisplay)walkerDpy;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+	
+
+	return EGL_NO_DISPLAY;
+}
+
+EGLSurface _eglGetCurrentSurface(EGLint readdraw)
+{
+	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
+	{
+		return EGL_NO_SURFACE;
+	}
+
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		{
+			if (readdraw == EGL_DRAW)
+			{
+				return (EGLSurface)walkerDpy->currentDraw;
+			}
+			else if (readdraw == EGL_READ)
+			{
+				return (EGLSurface)walkerDpy->currentRead;
+			}
+
+			return EGL_NO_SURFACE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	return EGL_NO_SURFACE;
+}
+
+EGLDisplay _eglGetDisplay(EGLNativeDisplayType display_id)
+{
+	if (!_eglInternalInit())
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	//
+	{
+		auto _rl = g_globalStorage.placeRootDpy_readlock();
+
+		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+		while (walkerDpy)
+		{
+			if (walkerDpy->display_id == display_id)
+			{
+				return (EGLDisplay)walkerDpy;
+			}
+
+			walkerDpy = walkerDpy->next;
+		}
+	}
+
+	EGLDisplayImpl* newDpy = new EGLDisplayImpl();
+
+	if (!newDpy)
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	newDpy->initialized = EGL_FALSE;
+	newDpy->destroy = EGL_FALSE;
+#if defined(_WIN32) || defined(_WIN64)
+	newDpy->display_id = display_id ? display_id : g_globalStorage.dummy_read().hdc;
+#elif defined(__ANDROID__) || defined(ANDROID) || defined(WL_EGL_PLATFORM)
+	newDpy->display_id = 0;
+#else
+	newDpy->display_id = display_id ? display_id : g_globalStorage.dummy_read().display;
+#endif
+	newDpy->rootSurface = 0;
+	newDpy->rootCtx = 0;
+	newDpy->rootConfig = 0;
+	newDpy->rootStream = 0;
+	newDpy->rootShm = 0;
+	newDpy->nativeCaps = 0;
+	memset(&newDpy->nativeDisplayContainer, 0, sizeof(NativeDisplayContainer));
+	newDpy->configTable = 0;
+	newDpy->numberConfigs = 0;
+	newDpy->configsPublished = EGL_FALSE;
+	memset(newDpy->surfaceTypeIndex, 0, sizeof(newDpy->surfaceTypeIndex));
+	memset(newDpy->surfaceTypeCount, 0, sizeof(newDpy->surfaceTypeCount));
+	newDpy->contextPool = 0;
+	newDpy->rootVirtualHost = 0;
+	newDpy->extensions[0] = '\0';
+	newDpy->currentDraw = EGL_NO_SURFACE_IMPL;
+	newDpy->currentRead = EGL_NO_SURFACE_IMPL;
+	newDpy->currentCtx = EGL_NO_CONTEXT_IMPL;
+	newDpy->next = g_globalStorage.rootDpy;
+
+	auto _wl = g_globalStorage.placeRootDpy_writelock();
+	g_globalStorage.rootDpy = newDpy;
+
+	return newDpy;
+}
+
+EGLint _eglGetError(void)
+{
+	EGLint currentError = g_localStorage.error;
+
+	g_localStorage.error = EGL_SUCCESS;
+
+	return currentError;
+}
+
+__eglMustCastToProperFunctionPointerType _eglGetProcAddress(const char *procname)
+{
+	// The state set through these is tracked for the virtual contexts.
+	if (g_virtualContextSupported && procname)
+	{
+		for (size_t i = 0; i < sizeof(g_virtualProcs) / sizeof(g_virtualProcs[0]); i++)
+		{
+			if (strcmp(g_virtualProcs[i].procname, procname) == 0)
+			{
+				return g_virtualProcs[i].proc;
+			}
+		}
+	}
+
+	return __getProcAddress(procname);
+}
+
+EGLBoolean _eglInitialize(EGLDisplay dpy, EGLint *major, EGLint *minor)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			{
+				auto dummy = g_globalStorage.dummy_read();
+				EGLBoolean fail = (!walkerDpy->initialized && !__initialize(walkerDpy, &dummy, &g_localStorage.error));
+				g_globalStorage.dummy_write(dummy);
+				if (fail)
+				{
+					return EGL_FALSE;
+				}
+			}
+
+			if (!walkerDpy->initialized)
+			{
+				_eglInternalSetExtensions(walkerDpy);
+
+				_eglInternalFreezeConfigs(walkerDpy);
+			}
+
+			walkerDpy->initialized = EGL_TRUE;
+
+			walkerDpy->configsPublished.store(EGL_TRUE, std::memory_order_release);
+
+
+			//
+
+			if (major)
+			{
+				*major = 1;
+			}
+
+			if (minor)
+			{
+				*minor = 5;
+			}
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLContext ctx)
+{
+	EGLBoolean success = EGL_FALSE;
+	{
+		auto _rl = g_globalStorage.placeRootDpy_readlock();
+		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+		if ((ctx == EGL_NO_CONTEXT && (draw != EGL_NO_SURFACE || read != EGL_NO_SURFACE)) || (ctx != EGL_NO_CONTEXT && (draw == EGL_NO_SURFACE || read == EGL_NO_SURFACE)))
+		{
+			g_localStorage.error = EGL_BAD_MATCH;
+
+			return EGL_FALSE;
+		}
+
+		while (walkerDpy)
+		{
+			if ((EGLDisplay)walkerDpy == dpy)
+			{
+				guard_t _{ walkerDpy->mutex };
+
+				if (!walkerDpy->initialized || walkerDpy->destroy)
+				{
+					g_localStorage.error = EGL_NOT_INITIALIZED;
+
+					return EGL_FALSE;
+				}
+
+				EGLSurfaceImpl* currentDraw = EGL_NO_SURFACE_IMPL;
+				EGLSurfaceImpl* currentRead = EGL_NO_SURFACE_IMPL;
+				EGLContextImpl* currentCtx = EGL_NO_CONTEXT_IMPL;
+
+				NativeSurfaceContainer* nativeSurfaceContainer = 0;
+				NativeContextContainer* nativeContextContainer = 0;
+				EGLContextListImpl* currentCtxList = 0;
+
+				EGLBoolean result;
+
+				if (draw != EGL_NO_SURFACE)
+				{
+					EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+					while (walkerSurface)
+					{
+						if ((EGLSurface)walkerSurface == draw)
+						{
+							if (!walkerSurface->initialized || walkerSurface->destroy)
+							{
+								g_localStorage.error = EGL_BAD_NATIVE_WINDOW;
+
+								return EGL_FALSE;
+							}
+
+							currentDraw = walkerSurface;
+
+							break;
+						}
+
+						walkerSurface = walkerSurface->next;
+					}
+
+					if (!currentDraw)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+				}
+
+				if (read != EGL_NO_SURFACE)
+				{
+					EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+					while (walkerSurface)
+					{
+						if ((EGLSurface)walkerSurface == read)
+						{
+							if (!walkerSurface->initialized || walkerSurface->destroy)
+							{
+								g_localStorage.error = EGL_BAD_NATIVE_WINDOW;
+
+								return EGL_FALSE;
+							}
+
+							currentRead = walkerSurface;
+
+							break;
+						}
+
+						walkerSurface = walkerSurface->next;
+					}
+
+					if (!currentRead)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+				}
+
+				// A locked window or pixmap cannot be made current. A locked pbuffer is current already.
+				if ((currentDraw && !currentDraw->drawToPBuffer && _eglInternalIsLocked(currentDraw)) || (currentRead && !currentRead->drawToPBuffer && _eglInternalIsLocked(currentRead)))
+				{
+					g_localStorage.error = EGL_BAD_ACCESS;
+
+					return EGL_FALSE;
+				}
+
+				if (ctx != EGL_NO_CONTEXT)
+				{
+					EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+
+					while (walkerCtx)
+					{
+						if ((EGLContext)walkerCtx == ctx)
+						{
+							if (!walkerCtx->initialized || walkerCtx->destroy)
+							{
+								g_localStorage.error = EGL_BAD_CONTEXT;
+
+								return EGL_FALSE;
+							}
+
+							currentCtx = walkerCtx;
+
+							break;
+						}
+
+						walkerCtx = walkerCtx->next;
+					}
+
+					if (!currentCtx)
+					{
+						g_localStorage.error = EGL_BAD_CONTEXT;
+
+						return EGL_FALSE;
+					}
+				}
+
+				if (currentDraw != EGL_NO_SURFACE)
+				{
+					// An asynchronously presented window is rendered into a pixmap of its present thread.
+					if (currentDraw->present && currentDraw->present->current >= 0)
+					{
+						nativeSurfaceContainer = &currentDraw->present->buffers[currentDraw->present->current].nativeSurfaceContainer;
+					}
+					else
+					{
+						nativeSurfaceContainer = &currentDraw->nativeSurfaceContainer;
+					}
+				}
+
+				if (currentCtx != EGL_NO_CONTEXT)
+				{
+					// The list of another virtual context of the host may have grown meanwhile.
+					if (currentCtx->virtualHost)
+					{
+						currentCtx->rootCtxList = currentCtx->virtualHost->rootCtxList;
+					}
+
+					EGLContextListImpl* ctxList = currentCtx->rootCtxList;
+
+					while (ctxList)
+					{
+						if (ctxList->surface == currentDraw)
+						{
+							break;
+						}
+
+						ctxList = ctxList->next;
+					}
+
+					if (!ctxList)
+					{
+						ctxList = (EGLContextListImpl*)malloc(sizeof(EGLContextListImpl));
+
+						if (!ctxList)
+						{
+							return EGL_FALSE;
+						}
+
+						ctxList->virtualState = 0;
+						ctxList->virtualTenant = 0;
+						ctxList->currentThread = 0;
+
+						if (currentCtx->virtualHost)
+						{
+							ctxList->virtualState = (EGLVirtualStateImpl*)malloc(sizeof(EGLVirtualStateImpl));
+
+							if (!ctxList->virtualState)
+							{
+								free(ctxList);
+
+								return EGL_FALSE;
+							}
+
+							_eglInternalSetDefaultVirtualState(ctxList->virtualState);
+						}
+
+						// Gather shared context, if one exists.
+						EGLContextListImpl* sharedCtxList = 0;
+						if (currentCtx->sharedCtx)
+						{
+							EGLContextImpl* sharedWalkerCtx = currentCtx->sharedCtx;
+							EGLContextImpl* beforeSharedWalkerCtx = 0;
+
+							while (sharedWalkerCtx)
+							{
+								// Check, if already created.
+								if (sharedWalkerCtx->rootCtxList)
+								{
+									sharedCtxList = sharedWalkerCtx->rootCtxList;
+
+									break;
+								}
+
+								beforeSharedWalkerCtx = sharedWalkerCtx;
+								sharedWalkerCtx = sharedWalkerCtx->sharedCtx;
+
+								// No created shared context found.
+								if (!sharedWalkerCtx)
+								{
+									sharedCtxList = (EGLContextListImpl*)malloc(sizeof(EGLContextListImpl));
+
+									if (!sharedCtxList)
+									{
+										free(ctxList);
+
+										return EGL_FALSE;
+									}
+
+									result = _eglInternalTakePooledContext(walkerDpy, beforeSharedWalkerCtx->attribList, 0, &currentDraw->nativeSurfaceContainer, &sharedCtxList->nativeContextContainer);
+
+									if (!result)
+									{
+										result = __createContext(&sharedCtxList->nativeContextContainer, walkerDpy, &currentDraw->nativeSurfaceContainer, 0, beforeSharedWalkerCtx->attribList);
+									}
+
+									if (!result)
+									{
+										free(sharedCtxList);
+
+										free(ctxList);
+
+										return EGL_FALSE;
+									}
+
+									sharedCtxList->surface = currentDraw;
+									sharedCtxList->frontBuffer = EGL_FALSE;
+									sharedCtxList->virtualState = 0;
+									sharedCtxList->virtualTenant = 0;
+									sharedCtxList->currentThread = 0;
+
+									sharedCtxList->next = beforeSharedWalkerCtx->rootCtxList;
+									beforeSharedWalkerCtx->rootCtxList = sharedCtxList;
+								}
+							}
+						}
+						else
+						{
+							// Use own context as shared context, if one exits.
+
+							sharedCtxList = currentCtx->rootCtxList;
+						}
+
+						result = _eglInternalTakePooledContext(walkerDpy, currentCtx->attribList, sharedCtxList, &currentDraw->nativeSurfaceContainer, &ctxList->nativeContextContainer);
+
+						if (result)
+						{
+							if (!currentCtx->rootCtxList)
+							{
+								currentCtx->pooled = EGL_TRUE;
+							}
+						}
+						else
+						{
+							result = __createContext(&ctxList->nativeContextContainer, walkerDpy, &currentDraw->nativeSurfaceContainer, sharedCtxList ? &sharedCtxList->nativeContextContainer : 0, currentCtx->attribList);
+						}
+
+						if (!result)
+						{
+							free(ctxList->virtualState);
+
+							free(ctxList);
+
+							return EGL_FALSE;
+						}
+
+						ctxList->surface = currentDraw;
+						ctxList->frontBuffer = EGL_FALSE;
+
+						ctxList->next = currentCtx->rootCtxList;
+						currentCtx->rootCtxList = ctxList;
+
+						if (currentCtx->virtualHost)
+						{
+							currentCtx->virtualHost->rootCtxList = ctxList;
+						}
+					}
+
+					nativeContextContainer = &ctxList->nativeContextContainer;
+
+					currentCtxList = ctxList;
+				}
+
+				// The native context of a virtual context can not be used by another thread meanwhile.
+				if (currentCtxList && currentCtxList->virtualState && currentCtxList->currentThread && currentCtxList->currentThread != &g_localStorage)
+				{
+					g_localStorage.error = EGL_BAD_ACCESS;
+
+					return EGL_FALSE;
+				}
+
+				// Switching between virtual contexts of the host does not make the native context current again, if this
+				// thread did make it current with the same surfaces last.
+				const EGLContextImpl* previousCtx = g_localStorage.currentCtx;
+
+				if (currentCtxList && currentCtxList->virtualState && previousCtx && currentCtxList->currentThread == &g_localStorage && previousCtx->virtualCtxList == currentCtxList && walkerDpy->currentDraw == currentDraw && walkerDpy->currentRead == currentRead && !currentDraw->present)
+				{
+					success = result = EGL_TRUE;
+				}
+				else
+				{
+					success = result = __makeCurrent(walkerDpy, nativeSurfaceContainer, nativeContextContainer);
+				}
+
+				if (!result)
+				{
+					g_localStorage.error = EGL_BAD_MATCH;
+
+					return EGL_FALSE;
+				}
+
+				walkerDpy->currentDraw = currentDraw;
+				walkerDpy->currentRead = currentRead;
+				walkerDpy->currentCtx = currentCtx;
+
+				_eglInternalReleaseContextLists(previousCtx);
+
+				if (currentCtxList)
+				{
+					currentCtxList->currentThread = &g_localStorage;
+				}
+
+				g_localStorage.currentCtx = currentCtx;
+
+				if (currentCtxList && currentCtxList->virtualState)
+				{
+					_eglInternalActivateVirtualContext(currentCtx, currentCtxList, currentDraw);
+				}
+				else
+				{
+					g_localStorage.virtualState = 0;
+				}
+
+				if (currentDraw && currentCtx)
+				{
+					_eglInternalApplyRenderBuffer(walkerDpy, currentDraw);
+					_eglInternalApplySwapInterval(walkerDpy, currentDraw);
+				}
+
+				break; // break displays loop
+			}
+
+			walkerDpy = walkerDpy->next;
+		}
+	}
+
+	if (success)
+		_eglInternalCleanup();
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return success;
+}
+
+EGLBoolean _eglQueryContext (EGLDisplay dpy, EGLContext ctx, EGLint attribute, EGLint *value)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			shared_guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+
+			while (walkerCtx)
+			{
+				if ((EGLContext)walkerCtx == ctx)
+				{
+					if (!walkerCtx->initialized || walkerCtx->destroy)
+					{
+						return EGL_FALSE;
+					}
+
+					switch (attribute)
+					{
+						case EGL_CONFIG_ID:
+						{
+							if (value)
+							{
+								*value = walkerCtx->configId;
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_CONTEXT_CLIENT_TYPE:
+						{
+							if (value)
+							{
+								*value = EGL_OPENGL_API;
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_CONTEXT_CLIENT_VERSION:
+						{
+							// Regarding the specification, it only makes sense for OpenGL ES.
+
+							return EGL_FALSE;
+						}
+						break;
+						case EGL_TIME_TO_FIRST_FRAME_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerCtx->firstFrameTime ? (EGLint)((walkerCtx->firstFrameTime - walkerCtx->createTime) / 1000) : 0;
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_CONTEXT_POOLED_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerCtx->pooled;
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_VIRTUAL_CONTEXT_DESKTOP:
+						{
+							if (value)
+							{
+								*value = walkerCtx->virtualHost ? EGL_TRUE : EGL_FALSE;
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_RENDER_BUFFER:
+						{
+							if (walkerDpy->currentCtx == walkerCtx)
+							{
+								EGLSurfaceImpl* currentSurface = walkerDpy->currentDraw ? walkerDpy->currentDraw : walkerDpy->currentRead;
+
+								if (currentSurface)
+								{
+									object_guard_t surfaceLock{ *currentSurface->mutex };
+
+									if (currentSurface->drawToWindow)
+									{
+										if (value)
+										{
+											*value = (currentSurface->doubleBuffer && !currentSurface->frontBuffer) ? EGL_BACK_BUFFER : EGL_SINGLE_BUFFER;
+										}
+
+										return EGL_TRUE;
+									}
+									else if (currentSurface->drawToPixmap)
+									{
+										if (value)
+										{
+											*value = EGL_SINGLE_BUFFER;
+										}
+
+										return EGL_TRUE;
+									}
+									else if (currentSurface->drawToPBuffer)
+									{
+										if (value)
+										{
+											*value = EGL_BACK_BUFFER;
+										}
+
+										return EGL_TRUE;
+									}
+								}
+
+								if (value)
+								{
+									*value = EGL_NONE;
+								}
+
+								return EGL_FALSE;
+							}
+							else
+							{
+								if (value)
+								{
+									*value = EGL_NONE;
+								}
+
+								return EGL_FALSE;
+							}
+						}
+						break;
+					}
+
+					g_localStorage.error = EGL_BAD_PARAMETER;
+
+					return EGL_FALSE;
+				}
+
+				walkerCtx = walkerCtx->next;
+			}
+
+			g_localStorage.error = EGL_BAD_CONTEXT;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+const char *_eglQueryString(EGLDisplay dpy, EGLint name)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return 0;
+			}
+
+			switch (name)
+			{
+				case EGL_CLIENT_APIS:
+				{
+					return "EGL_OPENGL_API";
+				}
+				break;
+				case EGL_VENDOR:
+				{
+					return _EGL_VENDOR;
+				}
+				break;
+				case EGL_VERSION:
+				{
+					return _EGL_VERSION;
+				}
+				break;
+				case EGL_EXTENSIONS:
+				{
+					return walkerDpy->extensions;
+				}
+				break;
+			}
+
+			g_localStorage.error = EGL_BAD_PARAMETER;
+
+			return 0;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return 0;
+}
+
+EGLBoolean _eglQuerySurface (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint *value)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			shared_guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					object_guard_t surfaceLock{ *walkerSurface->mutex };
+
+					if (!value)
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
+					}
+
+					EGLAttribKHR attribValue = (EGLAttribKHR)*value;
+
+					if (!_eglInternalQuerySurface(walkerDpy, walkerSurface, attribute, &attribValue))
+					{
+						return EGL_FALSE;
+					}
+
+					// The bitmap pointer can only be queried with eglQuerySurface64KHR, if it does not fit.
+					if ((EGLAttribKHR)(EGLint)attribValue != attribValue)
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					*value = (EGLint)attribValue;
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+static EGLBoolean _eglInternalSwapBuffers(EGLDisplay dpy, EGLSurface surface, const EGLint* rects, EGLint n_rects)
+{
+	if (n_rects < 0 || (n_rects > 0 && !rects))
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			shared_guard_t displayLock{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return 0;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					// Swaps of other surfaces of this display are not blocked.
+					SurfaceLock lock{ displayLock, walkerSurface };
+
+					if (_eglInternalIsLocked(walkerSurface))
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					if (!_eglInternalThrottleFrames(walkerDpy, walkerSurface, lock))
+					{
+						return EGL_FALSE;
+					}
+
+					// Frame boundary of EGL_KHR_partial_update.
+					walkerSurface->ageQueried = EGL_FALSE;
+					walkerSurface->damageSet = EGL_FALSE;
+					walkerSurface->numberDamageRects = 0;
+
+					if (walkerSurface->readbacks && walkerDpy->currentDraw == walkerSurface && walkerSurface->readbackCtx == g_localStorage.currentCtx)
+					{
+						_eglInternalDispatchReadbacks(walkerSurface);
+					}
+
+					// Ends the time to first frame of the current context.
+					if (g_localStorage.currentCtx && !g_localStorage.currentCtx->firstFrameTime)
+					{
+						g_localStorage.currentCtx->firstFrameTime = _eglInternalGetTime();
+					}
+
+					// No effect, as pixmap surfaces are single buffered.
+					if (walkerSurface->drawToPixmap)
+					{
+						return EGL_TRUE;
+					}
+
+					if (walkerSurface->clientMemory)
+					{
+						// The default framebuffer reads from the read surface.
+						if (walkerDpy->currentDraw != walkerSurface || walkerDpy->currentRead != walkerSurface || walkerDpy->currentCtx != g_localStorage.currentCtx)
+						{
+							g_localStorage.error = EGL_BAD_SURFACE;
+
+							return EGL_FALSE;
+						}
+
+						return _eglInternalWriteClientMemory(walkerSurface);
+					}
+
+					if (walkerSurface->stream)
+					{
+						return _eglInternalStreamInsertFrame(walkerDpy, walkerSurface, lock);
+					}
+
+					_eglInternalBeginFrame(walkerDpy, walkerSurface);
+
+					if (walkerSurface->drawToWindow && walkerSurface->doubleBuffer && (walkerSurface->frontBuffer || walkerSurface->renderBuffer == EGL_SINGLE_BUFFER))
+					{
+						return _eglInternalSwapRenderBuffer(walkerDpy, walkerSurface);
+					}
+
+					if (walkerSurface->asyncPresent || walkerSurface->present)
+					{
+						return _eglInternalSwapAsync(walkerDpy, walkerSurface, lock);
+					}
+
+					if (_eglInternalPresentDamage(walkerDpy, walkerSurface, rects, n_rects))
+					{
+						walkerSurface->backBufferKept = EGL_TRUE;
+
+						return EGL_TRUE;
+					}
+
+					walkerSurface->backBufferKept = EGL_FALSE;
+
+					const EGLBoolean preserved = _eglInternalSavePreserve(walkerDpy, walkerSurface);
+
+					if (!_eglInternalSwapNative(walkerDpy, walkerSurface))
+					{
+						return EGL_FALSE;
+					}
+
+					if (preserved)
+					{
+						walkerSurface->backBufferKept = _eglInternalBlitPreserve(walkerSurface->preserve, EGL_TRUE);
+					}
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
+{
+	return _eglInternalSwapBuffers(dpy, surface, NULL, 0);
+}
+
+EGLBoolean _eglTerminate(EGLDisplay dpy)
+{
+	EGLBoolean success = EGL_FALSE;
+	{
+		auto _rl = g_globalStorage.placeRootDpy_readlock();
+		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+		while (walkerDpy)
+		{
+			if ((EGLDisplay)walkerDpy == dpy)
+			{
+				guard_t _{ walkerDpy->mutex };
+
+				if (!walkerDpy->initialized || walkerDpy->destroy)
+				{
+					g_localStorage.error = EGL_BAD_DISPLAY;
+
+					return EGL_FALSE;
+				}
+
+				walkerDpy->configsPublished.store(EGL_FALSE, std::memory_order_release);
+
+				walkerDpy->initialized = EGL_FALSE;
+				walkerDpy->destroy = EGL_TRUE;
+
+				success = EGL_TRUE;
+			}
+
+			walkerDpy = walkerDpy->next;
+		}
+	}
+
+	if (success)
+		_eglInternalCleanup();
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+
+
+EGLBoolean _eglWaitNative(EGLint engine)
+{
+	if (engine != EGL_CORE_NATIVE_ENGINE)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (walkerDpy->currentDraw && (!walkerDpy->currentDraw->initialized || walkerDpy->currentDraw->destroy))
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentRead && (!walkerDpy->currentRead->initialized || walkerDpy->currentRead->destroy))
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			break;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	if (g_localStorage.api == EGL_OPENGL_API)
+	{
+		glFinish();
+	}
+
+	return EGL_TRUE;
+}
+
+//
+// EGL_VERSION_1_1
+//
+
+EGLBoolean _eglBindTexImage(EGLDisplay dpy, EGLSurface surface, EGLint buffer)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					if (buffer != EGL_BACK_BUFFER)
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
+					}
+
+					if (!walkerSurface->drawToPBuffer || (walkerSurface->textureFormat != EGL_TEXTURE_RGB && walkerSurface->textureFormat != EGL_TEXTURE_RGBA))
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
+					}
+
+					if (walkerSurface->textureBound)
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					// Ignored, if no context is current.
+					if (g_localStorage.currentCtx == EGL_NO_CONTEXT_IMPL)
+					{
+						return EGL_TRUE;
+					}
+
+					// Rendering into the surface has to be submitted, before the texture is sampled.
+					if (walkerDpy->currentDraw == walkerSurface)
+					{
+						glFlush();
+					}
+
+					// Binds to the texture object, which is bound to GL_TEXTURE_2D of the current context.
+					if (!__bindTexImage(walkerDpy, &walkerSurface->nativeSurfaceContainer))
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
+					}
+
+					walkerSurface->textureBound = EGL_TRUE;
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglReleaseTexImage(EGLDisplay dpy, EGLSurface surface, EGLint buffer)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					if (buffer != EGL_BACK_BUFFER)
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
+					}
+
+					if (!walkerSurface->drawToPBuffer || (walkerSurface->textureFormat != EGL_TEXTURE_RGB && walkerSurface->textureFormat != EGL_TEXTURE_RGBA))
+					{
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
+					}
+
+					// No effect, if the color buffer is not bound.
+					if (!walkerSurface->textureBound)
+					{
+						return EGL_TRUE;
+					}
+
+					__releaseTexImage(walkerDpy, &walkerSurface->nativeSurfaceContainer);
+
+					walkerSurface->textureBound = EGL_FALSE;
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglSurfaceAttrib(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint value)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			shared_guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					object_guard_t surfaceLock{ *walkerSurface->mutex };
+
+					EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+					while (walkerConfig && walkerConfig->configId != walkerSurface->configId)
+					{
+						walkerConfig = walkerConfig->next;
+					}
+
+					const EGLint surfaceType = walkerConfig ? walkerConfig->surfaceType : 0;
+
+					switch (attribute)
+					{
+						case EGL_MIPMAP_LEVEL:
+						{
+							// Ignored, if the surface has no mipmapped texture.
+							walkerSurface->mipmapLevel = value;
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_MULTISAMPLE_RESOLVE:
+						{
+							if (value != EGL_MULTISAMPLE_RESOLVE_DEFAULT && value != EGL_MULTISAMPLE_RESOLVE_BOX)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (value == EGL_MULTISAMPLE_RESOLVE_BOX && !(surfaceType & EGL_MULTISAMPLE_RESOLVE_BOX_BIT))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->multisampleResolve = (EGLenum)value;
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_RENDER_BUFFER:
+						{
+							if (value != EGL_BACK_BUFFER && value != EGL_SINGLE_BUFFER)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (!walkerSurface->drawToWindow || !walkerSurface->doubleBuffer || !(surfaceType & EGL_MUTABLE_RENDER_BUFFER_BIT_KHR))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							if (value == EGL_SINGLE_BUFFER && walkerSurface->asyncPresent)
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->renderBuffer = (EGLenum)value;
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_TIMESTAMPS_ANDROID:
+						{
+							if (!walkerSurface->drawToWindow)
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							if (value && !walkerSurface->frames)
+							{
+								walkerSurface->frames = (EGLFrameImpl*)calloc(_EGL_FRAME_HISTORY, sizeof(EGLFrameImpl));
+
+								if (!walkerSurface->frames)
+								{
+									g_localStorage.error = EGL_BAD_ALLOC;
+
+									return EGL_FALSE;
+								}
+							}
+
+							walkerSurface->timestamps = value ? EGL_TRUE : EGL_FALSE;
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_MAX_FRAMES_IN_FLIGHT_DESKTOP:
+						{
+							if (!walkerSurface->drawToWindow)
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							if (value < 0 || value > _EGL_FRAMES_IN_FLIGHT_MAX)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->maxFramesInFlight = value;
+
+							if (!walkerSurface->maxFramesInFlight)
+							{
+								_eglInternalReleaseFlightFences(walkerSurface);
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_FRAME_THROTTLE_BLOCKING_DESKTOP:
+						{
+							if (!walkerSurface->drawToWindow)
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->throttleBlocking = value ? EGL_TRUE : EGL_FALSE;
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_ASYNC_PRESENT_DESKTOP:
+						{
+							if (!walkerSurface->drawToWindow || !walkerSurface->doubleBuffer || (walkerDpy->nativeCaps & (_EGL_NATIVE_TEXTURE_FROM_PIXMAP | _EGL_NATIVE_THREADS)) != (_EGL_NATIVE_TEXTURE_FROM_PIXMAP | _EGL_NATIVE_THREADS))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							// The pixmaps have no back buffer to render into and do not keep the previous frame.
+							if (value && (walkerSurface->renderBuffer == EGL_SINGLE_BUFFER || walkerSurface->swapBehavior == EGL_BUFFER_PRESERVED))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->asyncPresent = value ? EGL_TRUE : EGL_FALSE;
+
+							return EGL_TRUE;
+						}
+						break;
+						case EGL_SWAP_BEHAVIOR:
+						{
+							if (value != EGL_BUFFER_PRESERVED && value != EGL_BUFFER_DESTROYED)
+							{
+								g_localStorage.error = EGL_BAD_PARAMETER;
+
+								return EGL_FALSE;
+							}
+
+							if (value == EGL_BUFFER_PRESERVED && (!(surfaceType & EGL_SWAP_BEHAVIOR_PRESERVED_BIT) || walkerSurface->asyncPresent))
+							{
+								g_localStorage.error = EGL_BAD_MATCH;
+
+								return EGL_FALSE;
+							}
+
+							walkerSurface->swapBehavior = (EGLenum)value;
+
+							if (walkerSurface->swapBehavior == EGL_BUFFER_DESTROYED)
+							{
+								_eglInternalReleasePreserve(walkerSurface);
+							}
+
+							return EGL_TRUE;
+						}
+						break;
+					}
+
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglSwapInterval(EGLDisplay dpy, EGLint interval)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			shared_guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_BAD_DISPLAY;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentDraw == EGL_NO_SURFACE || walkerDpy->currentRead == EGL_NO_SURFACE)
+			{
+				g_localStorage.error = EGL_BAD_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentCtx == EGL_NO_CONTEXT)
+			{
+				g_localStorage.error = EGL_BAD_CONTEXT;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->currentDraw;
+
+			object_guard_t surfaceLock{ *walkerSurface->mutex };
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig && walkerConfig->configId != walkerSurface->configId)
+			{
+				walkerConfig = walkerConfig->next;
+			}
+
+			// The interval is silently clamped to the range of the config.
+			if (walkerConfig && walkerConfig->minSwapInterval != EGL_DONT_CARE && interval < walkerConfig->minSwapInterval)
+			{
+				interval = walkerConfig->minSwapInterval;
+			}
+			if (walkerConfig && walkerConfig->maxSwapInterval != EGL_DONT_CARE && interval > walkerConfig->maxSwapInterval)
+			{
+				interval = walkerConfig->maxSwapInterval;
+			}
+
+			walkerSurface->swapInterval = interval;
+
+			_eglInternalApplySwapInterval(walkerDpy, walkerSurface);
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+//
+// EGL_VERSION_1_2
+//
+
+EGLBoolean _eglBindAPI(EGLenum api)
+{
+	if (api == EGL_OPENGL_API || api == EGL_OPENGL_ES_API)
+	{
+		g_localStorage.api = api;
+
+		return EGL_TRUE;
+	}
+
+	g_localStorage.error = EGL_BAD_PARAMETER;
+
+	return EGL_FALSE;
+}
+
+EGLSurface _eglCreatePbufferFromClientBuffer(EGLDisplay dpy, EGLenum buftype, EGLClientBuffer buffer, EGLConfig config, const EGLint *attrib_list)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_SURFACE;
+			}
+
+			if (buftype != EGL_CLIENT_MEMORY_DESKTOP || !buffer)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLint width = 0;
+			EGLint height = 0;
+			EGLint stride = 0;
+
+			EGLint attribListIndex = 0;
+
+			while (attrib_list && attrib_list[attribListIndex] != EGL_NONE)
+			{
+				EGLint value = attrib_list[attribListIndex + 1];
+
+				switch (attrib_list[attribListIndex])
+				{
+					case EGL_WIDTH:
+						width = value;
+					break;
+					case EGL_HEIGHT:
+						height = value;
+					break;
+					case EGL_CLIENT_MEMORY_STRIDE_DESKTOP:
+						stride = value;
+					break;
+					default:
+					{
+						g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_NO_SURFACE;
+					}
+					break;
+				}
+
+				attribListIndex += 2;
+			}
+
+			// The row size is compared in 64 bit, as it does not fit into an EGLint for a large width.
+			const EGLuint64KHR rowSize = width > 0 ? (EGLuint64KHR)width * 4 : 0;
+
+			if (stride == 0 && rowSize <= 0x7FFFFFFF)
+			{
+				stride = (EGLint)rowSize;
+			}
+
+			if (width <= 0 || height <= 0 || stride <= 0 || (EGLuint64KHR)stride < rowSize || (stride % 4) != 0 || ((uintptr_t)buffer % 4) != 0)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
+			{
+				if ((EGLConfig)walkerConfig == config)
+				{
+					break;
+				}
+
+				walkerConfig = walkerConfig->next;
+			}
+
+			if (!walkerConfig)
+			{
+				g_localStorage.error = EGL_BAD_CONFIG;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+			EGLClientMemoryImpl* clientMemory = (EGLClientMemoryImpl*)calloc(1, sizeof(EGLClientMemoryImpl));
+
+			if (!newSurface || !clientMemory)
+			{
+				free(newSurface);
+				free(clientMemory);
+
+				g_localStorage.error = EGL_BAD_ALLOC;
+
+				return EGL_NO_SURFACE;
+			}
+
+			memset(newSurface, 0, sizeof(EGLSurfaceImpl));
+
+			newSurface->readbackFormat = EGL_READBACK_FORMAT_RGBA_DESKTOP;
+
+			// The color buffer is a native pbuffer of the same size.
+			EGLint pbufferAttribList[] = {
+				EGL_WIDTH, width,
+				EGL_HEIGHT, height,
+				EGL_NONE
+			};
+
+			if (!__createPbufferSurface(newSurface, pbufferAttribList, walkerDpy, walkerConfig, &g_localStorage.error))
+			{
+				free(newSurface);
+				free(clientMemory);
+
+				if (g_localStorage.error == EGL_SUCCESS)
+				{
+					g_localStorage.error = EGL_BAD_MATCH;
+				}
+
+				return EGL_NO_SURFACE;
+			}
+
+			clientMemory->memory = (void*)buffer;
+			clientMemory->stride = stride;
+			clientMemory->width = width;
+			clientMemory->height = height;
+			clientMemory->size = (size_t)stride * (size_t)(height - 1) + (size_t)width * 4;
+			clientMemory->path = _EGL_CLIENT_MEMORY_NONE;
+
+			newSurface->clientMemory = clientMemory;
+
+			_eglInternalInitSurfaceState(walkerDpy, newSurface, attrib_list);
+
+			newSurface->next = walkerDpy->rootSurface;
+
+			walkerDpy->rootSurface = newSurface;
+
+			return (EGLSurface)newSurface;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_SURFACE;
+}
+
+EGLenum _eglQueryAPI(void)
+{
+	return g_localStorage.api;
+}
+
+EGLBoolean _eglWaitClient(void)
+{
+	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
+	{
+		return EGL_TRUE;
+	}
+
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentDraw && (!walkerDpy->currentDraw->initialized || walkerDpy->currentDraw->destroy))
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerDpy->currentRead && (!walkerDpy->currentRead->initialized || walkerDpy->currentRead->destroy))
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_FALSE;
+			}
+
+			break;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	if (g_localStorage.api == EGL_OPENGL_API)
+	{
+		glFinish();
+	}
+
+	return EGL_TRUE;
+}
+
+//
+// EGL_VERSION_1_3
+//
+
+//
+// EGL_VERSION_1_4
+//
+
+EGLContext _eglGetCurrentContext(void)
+{
+	return g_localStorage.currentCtx;
+}
+
+//
+// EGL_VERSION_1_5
+//
+
+//
+// EGL_KHR_stream
+//
+
+EGLStreamKHR _eglCreateStreamKHR(EGLDisplay dpy, const EGLint *attrib_list)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_STREAM_KHR;
+			}
+
+			if (!(walkerDpy->nativeCaps & _EGL_NATIVE_TEXTURE_FROM_PIXMAP))
+			{
+				g_localStorage.error = EGL_BAD_MATCH;
+
+				return EGL_NO_STREAM_KHR;
+			}
+
+			EGLint consumerLatency = 0;
+			EGLint consumerAcquireTimeout = 0;
+			EGLint fifoLength = 0;
+
+			EGLint attribListIndex = 0;
+
+			while (attrib_list && attrib_list[attribListIndex] != EGL_NONE)
+			{
+				EGLint value = attrib_list[attribListIndex + 1];
+
+				if (value < 0)
+				{
+					g_localStorage.error = EGL_BAD_PARAMETER;
+
+					return EGL_NO_STREAM_KHR;
+				}
+
+				switch (attrib_list[attribListIndex])
+				{
+					case EGL_CONSUMER_LATENCY_USEC_KHR:
+					{
+						consumerLatency = value;
+					}
+					break;
+					case EGL_CONSUMER_ACQUIRE_TIMEOUT_USEC_KHR:
+					{
+						consumerAcquireTimeout = value;
+					}
+					break;
+					case EGL_STREAM_FIFO_LENGTH_KHR:
+					{
+						fifoLength = value;
+					}
+					break;
+					default:
+					{
+						g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_NO_STREAM_KHR;
+					}
+					break;
+				}
+
+				attribListIndex += 2;
+			}
+
+			EGLStreamImpl* newStream = new EGLStreamImpl();
+
+			if (!newStream)
+			{
+				g_localStorage.error = EGL_BAD_ALLOC;
+
+				return EGL_NO_STREAM_KHR;
+			}
+
+			newStream->initialized = EGL_TRUE;
+			newStream->destroy = EGL_FALSE;
+			newStream->state = EGL_STREAM_STATE_CREATED_KHR;
+			newStream->fifoLength = fifoLength;
+			newStream->consumerLatency = consumerLatency;
+			newStream->consumerAcquireTimeout = consumerAcquireTimeout;
+			newStream->width = 0;
+			newStream->height = 0;
+			newStream->producer = 0;
+			newStream->consumerCtx = 0;
+			newStream->consumerTexture = 0;
+			newStream->numberFrames = 0;
+			newStream->frames = 0;
+			newStream->producerFrame = -1;
+			newStream->consumerFrame = -1;
+			newStream->queue = 0;
+			newStream->queueHead = 0;
+			newStream->queueTail = 0;
+			newStream->mailbox = -1;
+			newStream->numberSharedFrames = 0;
+			newStream->waiters = 0;
+			newStream->producerFrameNumber = 0;
+			newStream->consumerFrameNumber = 0;
+			newStream->producerTime = 0;
+			newStream->consumerTime = 0;
+			newStream->crossProcess = EGL_FALSE;
+			newStream->fileDescriptorTaken = EGL_FALSE;
+			memset(&newStream->nativeStreamContainer, 0, sizeof(NativeStreamContainer));
+			newStream->shared = 0;
+
+			newStream->next = walkerDpy->rootStream;
+			walkerDpy->rootStream = newStream;
+
+			return (EGLStreamKHR)newStream;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_NO_STREAM_KHR;
+}
+
+EGLBoolean _eglDestroyStreamKHR(EGLDisplay dpy, EGLStreamKHR stream)
+{
+	EGLBoolean success = EGL_FALSE;
+	{
+		auto _rl = g_globalStorage.placeRootDpy_readlock();
+		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+		while (walkerDpy)
+		{
+			if ((EGLDisplay)walkerDpy == dpy)
+			{
+				guard_t _{ walkerDpy->mutex };
+
+				if (!walkerDpy->initialized || walkerDpy->destroy)
+				{
+					g_localStorage.error = EGL_NOT_INITIALIZED;
+
+					return EGL_FALSE;
+				}
+
+				EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
+
+				if (!walkerStream)
+				{
+					return EGL_FALSE;
+				}
+
+				walkerStream->initialized = EGL_FALSE;
+				walkerStream->destroy = EGL_TRUE;
+				walkerStream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
+
+				_eglInternalStreamNotify(walkerStream);
+
+				success = EGL_TRUE;
+
+				break;
+			}
+
+			walkerDpy = walkerDpy->next;
+		}
+	}
+
+	if (success)
+	{
+		_eglInternalCleanup();
+
+		return EGL_TRUE;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglStreamAttribKHR(EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLint value)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
+
+			if (!walkerStream)
+			{
+				return EGL_FALSE;
+			}
+
+			if (value < 0)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_FALSE;
+			}
+
+			switch (attribute)
+			{
+				case EGL_CONSUMER_LATENCY_USEC_KHR:
+				{
+					walkerStream->consumerLatency = value;
+				}
+				break;
+				case EGL_CONSUMER_ACQUIRE_TIMEOUT_USEC_KHR:
+				{
+					walkerStream->consumerAcquireTimeout = value;
+				}
+				break;
+				default:
+				{
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
 				}
-				if (config.nativeRenderable != EGL_DONT_CARE && config.nativeRenderable != walkerConfig->nativeRenderable)
+				break;
+			}
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglQueryStreamKHR(EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLint *value)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
+
+			if (!walkerStream)
+			{
+				return EGL_FALSE;
+			}
+
+			if (!value)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_FALSE;
+			}
+
+			switch (attribute)
+			{
+				case EGL_STREAM_STATE_KHR:
 				{
-					walkerConfig = walkerConfig->next;
+					if (walkerStream->crossProcess && walkerStream->consumerCtx && walkerStream->state == EGL_STREAM_STATE_CONNECTING_KHR)
+					{
+						_eglInternalStreamReceiveShared(walkerStream, 0);
+					}
 
-					continue;
+					*value = (EGLint)_eglInternalStreamState(walkerStream);
 				}
-				if (config.maxSwapInterval != EGL_DONT_CARE && config.maxSwapInterval != walkerConfig->maxSwapInterval)
+				break;
+				case EGL_CONSUMER_LATENCY_USEC_KHR:
 				{
-					walkerConfig = walkerConfig->next;
-
-					continue;
+					*value = walkerStream->consumerLatency;
 				}
-				if (config.minSwapInterval != EGL_DONT_CARE && config.minSwapInterval != walkerConfig->minSwapInterval)
+				break;
+				case EGL_CONSUMER_ACQUIRE_TIMEOUT_USEC_KHR:
 				{
-					walkerConfig = walkerConfig->next;
-
-					continue;
+					*value = walkerStream->consumerAcquireTimeout;
 				}
-				if (config.redSize > walkerConfig->redSize)
+				break;
+				case EGL_STREAM_FIFO_LENGTH_KHR:
 				{
-					walkerConfig = walkerConfig->next;
-
-					continue;
+					*value = walkerStream->fifoLength;
 				}
-				if (config.sampleBuffers > walkerConfig->sampleBuffers)
+				break;
+				default:
 				{
-					walkerConfig = walkerConfig->next;
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-					continue;
+					return EGL_FALSE;
 				}
-				if (config.samples > walkerConfig->samples)
-				{
-					walkerConfig = walkerConfig->next;
+				break;
+			}
 
-					continue;
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglQueryStreamu64KHR(EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLuint64KHR *value)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
+
+			if (!walkerStream)
+			{
+				return EGL_FALSE;
+			}
+
+			if (!value)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_FALSE;
+			}
+
+			switch (attribute)
+			{
+				case EGL_PRODUCER_FRAME_KHR:
+				{
+					*value = walkerStream->shared ? walkerStream->shared->producerFrameNumber.load() : walkerStream->producerFrameNumber.load();
 				}
-				if ((config.stencilSize != EGL_DONT_CARE) && (config.stencilSize != walkerConfig->stencilSize))
+				break;
+				case EGL_CONSUMER_FRAME_KHR:
 				{
-					walkerConfig = walkerConfig->next;
-
-					continue;
+					*value = walkerStream->shared ? walkerStream->shared->consumerFrameNumber.load() : walkerStream->consumerFrameNumber.load();
 				}
-				if ((config.renderableType & walkerConfig->renderableType) != config.renderableType)
+				break;
+				default:
 				{
-					walkerConfig = walkerConfig->next;
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-					continue;
+					return EGL_FALSE;
+				}
+				break;
+			}
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+//
+// EGL_KHR_stream_fifo
+//
+
+EGLBoolean _eglQueryStreamTimeKHR(EGLDisplay dpy, EGLStreamKHR stream, EGLenum attribute, EGLTimeKHR *value)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
+
+			if (!walkerStream)
+			{
+				return EGL_FALSE;
+			}
+
+			if (!value)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
+
+				return EGL_FALSE;
+			}
+
+			switch (attribute)
+			{
+				case EGL_STREAM_TIME_NOW_KHR:
+				{
+					*value = _eglInternalGetTime();
+				}
+				break;
+				case EGL_STREAM_TIME_CONSUMER_KHR:
+				{
+					*value = walkerStream->shared ? walkerStream->shared->consumerTime.load() : walkerStream->consumerTime.load();
+				}
+				break;
+				case EGL_STREAM_TIME_PRODUCER_KHR:
+				{
+					*value = walkerStream->shared ? walkerStream->shared->producerTime.load() : walkerStream->producerTime.load();
 				}
-				if ((config.surfaceType & walkerConfig->surfaceType) != config.surfaceType)
+				break;
+				default:
 				{
-					walkerConfig = walkerConfig->next;
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+				break;
+			}
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+//
+// EGL_KHR_stream_consumer_gltexture
+//
+
+EGLBoolean _eglStreamConsumerGLTextureExternalKHR(EGLDisplay dpy, EGLStreamKHR stream)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
+
+			if (!walkerStream)
+			{
+				return EGL_FALSE;
+			}
+
+			if (walkerStream->state != EGL_STREAM_STATE_CREATED_KHR)
+			{
+				g_localStorage.error = EGL_BAD_STATE_KHR;
+
+				return EGL_FALSE;
+			}
+
+			if (g_localStorage.currentCtx == EGL_NO_CONTEXT || walkerDpy->currentCtx != g_localStorage.currentCtx)
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+
+				return EGL_FALSE;
+			}
+
+			// Desktop OpenGL has no external textures, so the consumer is the texture bound to GL_TEXTURE_2D.
+			GLint boundTexture = 0;
+
+			glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+
+			if (!boundTexture)
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+
+				return EGL_FALSE;
+			}
+
+			walkerStream->consumerCtx = g_localStorage.currentCtx;
+			walkerStream->consumerTexture = (unsigned int)boundTexture;
+			walkerStream->state = EGL_STREAM_STATE_CONNECTING_KHR;
+
+			return EGL_TRUE;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+EGLBoolean _eglStreamConsumerAcquireKHR(EGLDisplay dpy, EGLStreamKHR stream)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			unique_guard_t lock{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
+
+			if (!walkerStream)
+			{
+				return EGL_FALSE;
+			}
+
+			if (walkerStream->crossProcess && walkerStream->consumerCtx && walkerStream->state == EGL_STREAM_STATE_CONNECTING_KHR)
+			{
+				_eglInternalStreamReceiveShared(walkerStream, 0);
+			}
+
+			if (walkerStream->state != EGL_STREAM_STATE_EMPTY_KHR)
+			{
+				g_localStorage.error = EGL_BAD_STATE_KHR;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerStream->consumerCtx != g_localStorage.currentCtx)
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerStream->crossProcess)
+			{
+				EGLint frameIndex = _eglInternalStreamTakeSharedFrame(walkerStream);
 
-					continue;
-				}
-				if (config.transparentType != walkerConfig->transparentType)
+				if (frameIndex < 0 && walkerStream->consumerAcquireTimeout > 0)
 				{
-					walkerConfig = walkerConfig->next;
+					lock.unlock();
 
-					continue;
-				}
-				if (walkerConfig->transparentType == EGL_TRANSPARENT_RGB)
-				{
-					if (config.transparentRedValue != EGL_DONT_CARE && config.transparentRedValue != walkerConfig->transparentRedValue)
-					{
-						walkerConfig = walkerConfig->next;
+					_eglInternalStreamBeginWait(walkerStream);
 
-						continue;
-					}
-					if (config.transparentGreenValue != EGL_DONT_CARE && config.transparentGreenValue != walkerConfig->transparentGreenValue)
+					EGLTimeKHR deadline = _eglInternalGetTime() + (EGLTimeKHR)walkerStream->consumerAcquireTimeout * 1000;
+					EGLTimeKHR now;
+
+					// The state is only changed with the display locked, so a disconnect is published after the wait.
+					EGLBoolean disconnected = EGL_FALSE;
+
+					while ((frameIndex = _eglInternalStreamTakeSharedFrame(walkerStream)) < 0 && walkerStream->state != EGL_STREAM_STATE_DISCONNECTED_KHR && (now = _eglInternalGetTime()) < deadline)
 					{
-						walkerConfig = walkerConfig->next;
+						if (__waitStream(&walkerStream->nativeStreamContainer, EGL_TRUE, deadline - now) == _EGL_STREAM_WAIT_DISCONNECTED)
+						{
+							disconnected = EGL_TRUE;
 
-						continue;
+							break;
+						}
 					}
-					if (config.transparentBlueValue != EGL_DONT_CARE && config.transparentBlueValue != walkerConfig->transparentBlueValue)
-					{
-						walkerConfig = walkerConfig->next;
 
-						continue;
+					_eglInternalStreamEndWait(walkerStream);
+
+					lock.lock();
+
+					if (disconnected)
+					{
+						walkerStream->state = EGL_STREAM_STATE_DISCONNECTED_KHR;
 					}
 				}
 
-				//
-				/*
-				if (config.drawToWindow != walkerConfig->drawToWindow)
+				if (frameIndex < 0)
 				{
-					walkerConfig = walkerConfig->next;
+					if (walkerStream->consumerFrame >= 0 && walkerStream->state == EGL_STREAM_STATE_EMPTY_KHR)
+					{
+						return EGL_TRUE;
+					}
 
-					continue;
+					g_localStorage.error = EGL_BAD_STATE_KHR;
+
+					return EGL_FALSE;
 				}
 
-				if (config.drawToPixmap != walkerConfig->drawToPixmap)
-				{
-					walkerConfig = walkerConfig->next;
+				_eglInternalStreamUploadFrame(walkerStream, frameIndex);
 
-					continue;
-				}
+				return EGL_TRUE;
+			}
 
-				if (config.drawToPBuffer != walkerConfig->drawToPBuffer)
-				{
-					walkerConfig = walkerConfig->next;
+			EGLint frameIndex = _eglInternalStreamTakeFrame(walkerStream);
 
-					continue;
-				}
-				*/
+			if (frameIndex < 0 && walkerStream->consumerAcquireTimeout > 0)
+			{
+				// Wait for the producer without blocking it or other calls.
+				lock.unlock();
+
+				_eglInternalStreamBeginWait(walkerStream);
 
-				if (config.doubleBuffer != EGL_DONT_CARE && config.doubleBuffer != walkerConfig->doubleBuffer)
 				{
-					walkerConfig = walkerConfig->next;
+					unique_object_guard_t waitLock{ walkerStream->waitMutex };
 
-					continue;
+					walkerStream->waitCondition.wait_for(waitLock, std::chrono::microseconds(walkerStream->consumerAcquireTimeout), [walkerStream, &frameIndex] { return (frameIndex = _eglInternalStreamTakeFrame(walkerStream)) >= 0 || walkerStream->state != EGL_STREAM_STATE_EMPTY_KHR; });
 				}
 
-				//
+				_eglInternalStreamEndWait(walkerStream);
 
-				configsOnStack[configIndex] = walkerConfig;
+				lock.lock();
+			}
 
-				walkerConfig = walkerConfig->next;
+			if (frameIndex < 0)
+			{
+				// No new frame, so the old frame stays latched.
+				if (walkerStream->consumerFrame >= 0)
+				{
+					return EGL_TRUE;
+				}
 
-				configIndex++;
-			}
+				g_localStorage.error = EGL_BAD_STATE_KHR;
 
-			if (configIndex)
-				qsort(configsOnStack, configIndex, sizeof(*configs), &_ChooseConfig_sort_predicate);
+				return EGL_FALSE;
+			}
 
-			*num_config = (std::min)(configIndex, config_size);
-			memcpy(configs, configsOnStack, *num_config*sizeof(EGLConfig));
+			_eglInternalStreamLatchFrame(walkerDpy, walkerStream, frameIndex);
 
 			return EGL_TRUE;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
-	
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
 	return EGL_FALSE;
 }
 
-// comment this to bring back original code
-#define FIXED_SHARE_CONTEXT
-EGLContext _eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint *attrib_list)
+EGLBoolean _eglStreamConsumerReleaseKHR(EGLDisplay dpy, EGLStreamKHR stream)
 {
-	if (!attrib_list)
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
 	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
 
-		return EGL_NO_CONTEXT;
-	}
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-	if (g_localStorage.api == EGL_NONE)
-	{
-		g_localStorage.error = EGL_BAD_MATCH;
+				return EGL_FALSE;
+			}
 
-		return EGL_NO_CONTEXT;
-	}
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
 
-	EGLint requested_version[2]{ 1, 0 };
-	for (EGLint i = 0; attrib_list[i] != EGL_NONE; i += 2)
-	{
-		switch (attrib_list[i])
-		{
-		case EGL_CONTEXT_MAJOR_VERSION:
-			requested_version[0] = attrib_list[i + 1];
-			break;
-		case EGL_CONTEXT_MINOR_VERSION:
-			requested_version[1] = attrib_list[i + 1];
-			break;
+			if (!walkerStream)
+			{
+				return EGL_FALSE;
+			}
+
+			if (walkerStream->consumerFrame < 0)
+			{
+				g_localStorage.error = EGL_BAD_STATE_KHR;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerStream->consumerCtx != g_localStorage.currentCtx)
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerStream->crossProcess)
+			{
+				// The frame was already handed back after uploading.
+				walkerStream->consumerFrame = -1;
+
+				return EGL_TRUE;
+			}
+
+			_eglInternalStreamLatchFrame(walkerDpy, walkerStream, -1);
+
+			return EGL_TRUE;
 		}
-	}
 
-	if (g_localStorage.api == EGL_OPENGL_API)
-	{
-		if (requested_version[0] > g_GL_max_supported_version[0] || requested_version[1] > g_GL_max_supported_version[1])
-			return EGL_NO_CONTEXT;
-	}
-	else if (g_localStorage.api == EGL_OPENGL_ES_API)
-	{
-		if (requested_version[0] > g_ES_max_supported_version[0] || requested_version[1] > g_ES_max_supported_version[1])
-			return EGL_NO_CONTEXT;
-	}
-	else
-	{
-		return EGL_NO_CONTEXT;
+		walkerDpy = walkerDpy->next;
 	}
 
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
+}
+
+//
+// EGL_KHR_stream_producer_eglsurface
+//
 
+EGLSurface _eglCreateStreamProducerSurfaceKHR(EGLDisplay dpy, EGLConfig config, EGLStreamKHR stream, const EGLint *attrib_list)
+{
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
@@ -1225,7 +9500,7 @@ EGLContext _eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_
 			{
 				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				return EGL_FALSE;
+				return EGL_NO_SURFACE;
 			}
 
 			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
@@ -1234,87 +9509,272 @@ EGLContext _eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_
 			{
 				if ((EGLConfig)walkerConfig == config)
 				{
-					EGLint target_attrib_list[CONTEXT_ATTRIB_LIST_SIZE];
+					break;
+				}
 
-					if (g_localStorage.api == EGL_OPENGL_ES_API && (walkerConfig->conformant & EGL_OPENGL_ES3_BIT) == 0)
+				walkerConfig = walkerConfig->next;
+			}
+
+			if (!walkerConfig)
+			{
+				g_localStorage.error = EGL_BAD_CONFIG;
+
+				return EGL_NO_SURFACE;
+			}
+
+			if (!(walkerConfig->surfaceType & EGL_STREAM_BIT_KHR))
+			{
+				g_localStorage.error = EGL_BAD_MATCH;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
+
+			if (!walkerStream)
+			{
+				return EGL_NO_SURFACE;
+			}
+
+			// A cross process stream has its consumer in the other process.
+			if (walkerStream->state != (walkerStream->crossProcess ? EGL_STREAM_STATE_CREATED_KHR : EGL_STREAM_STATE_CONNECTING_KHR))
+			{
+				g_localStorage.error = EGL_BAD_STATE_KHR;
+
+				return EGL_NO_SURFACE;
+			}
+
+			EGLint width = 0;
+			EGLint height = 0;
+
+			EGLint attribListIndex = 0;
+
+			while (attrib_list && attrib_list[attribListIndex] != EGL_NONE)
+			{
+				EGLint value = attrib_list[attribListIndex + 1];
+
+				switch (attrib_list[attribListIndex])
+				{
+					case EGL_WIDTH:
 					{
-						return EGL_FALSE;
+						width = value;
 					}
-					if (!__processAttribList(g_localStorage.api, target_attrib_list, attrib_list, &g_localStorage.error))
+					break;
+					case EGL_HEIGHT:
 					{
-						return EGL_FALSE;
+						height = value;
 					}
+					break;
+					default:
+					{
+						g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-					EGLContextImpl* sharedCtx = 0;
+						return EGL_NO_SURFACE;
+					}
+					break;
+				}
 
-					if (share_context != EGL_NO_CONTEXT)
-					{
-						EGLDisplayImpl* sharedWalkerDpy = g_globalStorage.rootDpy;
+				attribListIndex += 2;
+			}
 
-						while (sharedWalkerDpy)
-						{
-							EGLContextImpl* sharedWalkerCtx = sharedWalkerDpy->rootCtx;
+			if (width <= 0 || height <= 0)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
 
-							while (sharedWalkerCtx)
-							{
-								if ((EGLContext)sharedWalkerCtx == share_context)
-								{
-									if (!sharedWalkerCtx->initialized || sharedWalkerCtx->destroy)
-									{
-										g_localStorage.error = EGL_BAD_CONTEXT;
+				return EGL_NO_SURFACE;
+			}
+
+			// One frame is rendered by the producer and one is latched by the consumer, the others are queued.
+			// Across processes, the producer renders into one local frame, which is copied into the shared frames.
+			EGLint numberFrames = walkerStream->crossProcess ? 1 : (walkerStream->fifoLength ? walkerStream->fifoLength + 2 : 3);
+			EGLint numberSharedFrames = walkerStream->fifoLength ? walkerStream->fifoLength + 1 : 3;
+
+			if (walkerStream->crossProcess && numberSharedFrames > _EGL_STREAM_SHARED_MAX_FRAMES)
+			{
+				g_localStorage.error = EGL_BAD_MATCH;
+
+				return EGL_NO_SURFACE;
+			}
+
+			walkerStream->frames = new EGLStreamFrameImpl[numberFrames];
+			walkerStream->queue = new EGLint[numberFrames];
+
+			for (EGLint i = 0; i < numberFrames; i++)
+			{
+				EGLStreamFrameImpl* frame = &walkerStream->frames[i];
+
+				memset(&frame->nativeSurfaceContainer, 0, sizeof(NativeSurfaceContainer));
+				frame->state = _EGL_STREAM_FRAME_FREE;
+				frame->frameNumber = 0;
+				frame->timestamp = 0;
+
+				walkerStream->queue[i] = -1;
+			}
+
+			walkerStream->numberFrames = numberFrames;
+
+			// The consumer latches a frame with the format, for which the config has been given EGL_STREAM_BIT_KHR.
+			const EGLenum textureFormat = walkerConfig->alphaSize ? EGL_TEXTURE_RGBA : EGL_TEXTURE_RGB;
+
+			for (EGLint i = 0; i < numberFrames; i++)
+			{
+				if (!__createTexturePixmap(&walkerStream->frames[i].nativeSurfaceContainer, walkerDpy, walkerConfig, textureFormat, width, height, &g_localStorage.error))
+				{
+					_eglInternalDestroyStreamFrames(walkerDpy, walkerStream);
+
+					return EGL_NO_SURFACE;
+				}
+			}
+
+			if (walkerStream->crossProcess)
+			{
+				void* memory = 0;
+
+				if (!__createStreamMemory(&walkerStream->nativeStreamContainer, _EGL_STREAM_SHARED_HEADER_SIZE + (size_t)numberSharedFrames * (size_t)width * (size_t)height * 4, &memory, &g_localStorage.error))
+				{
+					_eglInternalDestroyStreamFrames(walkerDpy, walkerStream);
+
+					return EGL_NO_SURFACE;
+				}
+
+				// The memory is zero initialized, so all frames are free.
+				EGLStreamSharedImpl* shared = (EGLStreamSharedImpl*)memory;
+
+				shared->width = width;
+				shared->height = height;
+				shared->numberFrames = numberSharedFrames;
+				shared->mailbox = -1;
+
+				walkerStream->numberSharedFrames = numberSharedFrames;
+
+				EGLStreamMessageImpl message;
+				message.fifoLength = walkerStream->fifoLength;
+				message.consumerLatency = walkerStream->consumerLatency;
+				message.consumerAcquireTimeout = walkerStream->consumerAcquireTimeout;
+
+				if (!__sendStreamMessage(&walkerStream->nativeStreamContainer, &message, EGL_TRUE, &g_localStorage.error))
+				{
+					_eglInternalDestroyStreamFrames(walkerDpy, walkerStream);
+
+					return EGL_NO_SURFACE;
+				}
+
+				walkerStream->shared = shared;
+			}
+
+			EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+
+			if (!newSurface)
+			{
+				_eglInternalDestroyStreamFrames(walkerDpy, walkerStream);
+
+				g_localStorage.error = EGL_BAD_ALLOC;
+
+				return EGL_NO_SURFACE;
+			}
+
+			memset(newSurface, 0, sizeof(EGLSurfaceImpl));
+
+			walkerStream->producerFrame = _eglInternalStreamClaimFrame(walkerStream);
+			walkerStream->width = width;
+			walkerStream->height = height;
+			walkerStream->producer = newSurface;
+			walkerStream->state = EGL_STREAM_STATE_EMPTY_KHR;
+
+			newSurface->initialized = EGL_TRUE;
+			newSurface->destroy = EGL_FALSE;
+			newSurface->drawToWindow = EGL_FALSE;
+			newSurface->drawToPixmap = EGL_FALSE;
+			newSurface->drawToPBuffer = EGL_FALSE;
+			newSurface->doubleBuffer = EGL_FALSE;
+			newSurface->configId = walkerConfig->configId;
+			newSurface->nativeSurfaceContainer = walkerStream->frames[walkerStream->producerFrame].nativeSurfaceContainer;
+			newSurface->stream = walkerStream;
+
+			_eglInternalInitSurfaceState(walkerDpy, newSurface, attrib_list);
+
+			newSurface->next = walkerDpy->rootSurface;
+			walkerDpy->rootSurface = newSurface;
+
+			return (EGLSurface)newSurface;
+		}
+
+		walkerDpy = walkerDpy->next;
+	}
+
+	g_localStorage.error = EGL_BAD_DISPLAY;
 
-										return EGL_FALSE;
-									}
+	return EGL_NO_SURFACE;
+}
 
-									sharedCtx = sharedWalkerCtx;
+//
+// EGL_KHR_stream_cross_process_fd
+//
 
-									break;
-								}
+EGLNativeFileDescriptorKHR _eglGetStreamFileDescriptorKHR(EGLDisplay dpy, EGLStreamKHR stream)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
-								sharedWalkerCtx = sharedWalkerCtx->next;
-							}
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
 
-							sharedWalkerDpy = sharedWalkerDpy->next;
-						}
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-						if (!sharedCtx)
-						{
-							g_localStorage.error = EGL_BAD_CONTEXT;
+				return EGL_NO_FILE_DESCRIPTOR_KHR;
+			}
 
-							return EGL_FALSE;
-						}
-					}
+			EGLStreamImpl* walkerStream = _eglInternalFindStream(walkerDpy, stream);
 
-					EGLContextImpl* newCtx = (EGLContextImpl*)malloc(sizeof(EGLContextImpl));
+			if (!walkerStream)
+			{
+				return EGL_NO_FILE_DESCRIPTOR_KHR;
+			}
 
-					if (!newCtx)
-					{
-						g_localStorage.error = EGL_BAD_ALLOC;
+			if (!(walkerDpy->nativeCaps & _EGL_NATIVE_STREAM_CROSS_PROCESS))
+			{
+				g_localStorage.error = EGL_BAD_STREAM_KHR;
 
-						return EGL_FALSE;
-					}
+				return EGL_NO_FILE_DESCRIPTOR_KHR;
+			}
 
-					// Move the atttibutes for later creation.
-					memcpy(newCtx->attribList, target_attrib_list, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
+			// Only one other process can be connected, and only before the producer is connected.
+			if (walkerStream->crossProcess || walkerStream->fileDescriptorTaken || (walkerStream->state != EGL_STREAM_STATE_CREATED_KHR && walkerStream->state != EGL_STREAM_STATE_CONNECTING_KHR))
+			{
+				g_localStorage.error = EGL_BAD_STATE_KHR;
 
-					newCtx->initialized = EGL_TRUE;
-					newCtx->destroy = EGL_FALSE;
-					newCtx->configId = walkerConfig->configId;
-					newCtx->sharedCtx = sharedCtx;
-					newCtx->rootCtxList = 0;
+				return EGL_NO_FILE_DESCRIPTOR_KHR;
+			}
 
-					newCtx->next = walkerDpy->rootCtx;
-					walkerDpy->rootCtx = newCtx;
+			EGLNativeFileDescriptorKHR fileDescriptor = EGL_NO_FILE_DESCRIPTOR_KHR;
 
-					return (EGLContext)newCtx;
-				}
+			if (!__createStreamConnection(&walkerStream->nativeStreamContainer, &fileDescriptor, &g_localStorage.error))
+			{
+				return EGL_NO_FILE_DESCRIPTOR_KHR;
+			}
 
-				walkerConfig = walkerConfig->next;
+			// The stream attributes are queued in the channel, so they arrive before anything else.
+			EGLStreamMessageImpl message;
+			message.fifoLength = walkerStream->fifoLength;
+			message.consumerLatency = walkerStream->consumerLatency;
+			message.consumerAcquireTimeout = walkerStream->consumerAcquireTimeout;
+
+			if (!__sendStreamMessage(&walkerStream->nativeStreamContainer, &message, EGL_FALSE, &g_localStorage.error))
+			{
+				__destroyStreamConnection(&walkerStream->nativeStreamContainer);
+
+				return EGL_NO_FILE_DESCRIPTOR_KHR;
 			}
 
-			g_localStorage.error = EGL_BAD_CONFIG;
+			walkerStream->crossProcess = EGL_TRUE;
+			walkerStream->fileDescriptorTaken = EGL_TRUE;
 
-			return EGL_NO_CONTEXT;
+			return fileDescriptor;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -1322,13 +9782,12 @@ EGLContext _eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
-	return EGL_NO_CONTEXT;
+	return EGL_NO_FILE_DESCRIPTOR_KHR;
 }
 
-EGLSurface _eglCreatePbufferSurface(EGLDisplay dpy, EGLConfig config, const EGLint* attrib_list)
+EGLStreamKHR _eglCreateStreamFromFileDescriptorKHR(EGLDisplay dpy, EGLNativeFileDescriptorKHR file_descriptor)
 {
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
-
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
 	while (walkerDpy)
@@ -1341,56 +9800,97 @@ EGLSurface _eglCreatePbufferSurface(EGLDisplay dpy, EGLConfig config, const EGLi
 			{
 				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				return EGL_NO_SURFACE;
+				return EGL_NO_STREAM_KHR;
 			}
 
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+			if (!(walkerDpy->nativeCaps & _EGL_NATIVE_STREAM_CROSS_PROCESS) || file_descriptor == EGL_NO_FILE_DESCRIPTOR_KHR)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
 
-			while (walkerConfig)
+				return EGL_NO_STREAM_KHR;
+			}
+
+			NativeStreamContainer nativeStreamContainer;
+
+			if (!__openStreamConnection(&nativeStreamContainer, file_descriptor, &g_localStorage.error))
 			{
-				if ((EGLConfig)walkerConfig == config)
-				{
-					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+				return EGL_NO_STREAM_KHR;
+			}
 
-					if (!newSurface)
-					{
-						g_localStorage.error = EGL_BAD_ALLOC;
+			EGLStreamMessageImpl message;
+			void* memory = 0;
+			size_t size = 0;
 
-						return EGL_NO_SURFACE;
-					}
+			// The creating process did send the stream attributes, before handing out the file descriptor.
+			if (__receiveStreamMessage(&nativeStreamContainer, &message, &memory, &size, 0) != _EGL_STREAM_WAIT_SIGNALED || memory || message.fifoLength < 0 || message.consumerLatency < 0 || message.consumerAcquireTimeout < 0)
+			{
+				__destroyStreamConnection(&nativeStreamContainer);
 
-					if (!__createPbufferSurface(newSurface, attrib_list, walkerDpy, walkerConfig, &g_localStorage.error))
-					{
-						free(newSurface);
+				g_localStorage.error = EGL_BAD_PARAMETER;
 
-						return EGL_NO_SURFACE;
-					}
+				return EGL_NO_STREAM_KHR;
+			}
 
-					newSurface->next = walkerDpy->rootSurface;
+			EGLStreamImpl* newStream = new EGLStreamImpl();
 
-					walkerDpy->rootSurface = newSurface;
+			if (!newStream)
+			{
+				__destroyStreamConnection(&nativeStreamContainer);
 
-					return (EGLSurface)newSurface;
-				}
+				g_localStorage.error = EGL_BAD_ALLOC;
 
-				walkerConfig = walkerConfig->next;
+				return EGL_NO_STREAM_KHR;
 			}
 
-			g_localStorage.error = EGL_BAD_CONFIG;
-
-			return EGL_NO_SURFACE;
+			newStream->initialized = EGL_TRUE;
+			newStream->destroy = EGL_FALSE;
+			newStream->state = EGL_STREAM_STATE_CREATED_KHR;
+			newStream->fifoLength = message.fifoLength;
+			newStream->consumerLatency = message.consumerLatency;
+			newStream->consumerAcquireTimeout = message.consumerAcquireTimeout;
+			newStream->width = 0;
+			newStream->height = 0;
+			newStream->producer = 0;
+			newStream->consumerCtx = 0;
+			newStream->consumerTexture = 0;
+			newStream->numberFrames = 0;
+			newStream->frames = 0;
+			newStream->producerFrame = -1;
+			newStream->consumerFrame = -1;
+			newStream->queue = 0;
+			newStream->queueHead = 0;
+			newStream->queueTail = 0;
+			newStream->mailbox = -1;
+			newStream->numberSharedFrames = 0;
+			newStream->waiters = 0;
+			newStream->producerFrameNumber = 0;
+			newStream->consumerFrameNumber = 0;
+			newStream->producerTime = 0;
+			newStream->consumerTime = 0;
+			newStream->crossProcess = EGL_TRUE;
+			newStream->fileDescriptorTaken = EGL_TRUE;
+			newStream->nativeStreamContainer = nativeStreamContainer;
+			newStream->shared = 0;
+
+			newStream->next = walkerDpy->rootStream;
+			walkerDpy->rootStream = newStream;
+
+			return (EGLStreamKHR)newStream;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
-	
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
-	return EGL_NO_SURFACE;
+	return EGL_NO_STREAM_KHR;
 }
 
-EGLSurface _eglCreateWindowSurface(EGLDisplay dpy, EGLConfig config, EGLNativeWindowType win, const EGLint *attrib_list)
+//
+// EGL_KHR_lock_surface3
+//
+
+EGLBoolean _eglLockSurfaceKHR(EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list)
 {
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
@@ -1405,184 +9905,300 @@ EGLSurface _eglCreateWindowSurface(EGLDisplay dpy, EGLConfig config, EGLNativeWi
 			{
 				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				return EGL_NO_SURFACE;
+				return EGL_FALSE;
 			}
 
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-			while (walkerConfig)
+			while (walkerSurface)
 			{
-				if ((EGLConfig)walkerConfig == config)
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					EGLSurfaceImpl* newSurface = (EGLSurfaceImpl*)malloc(sizeof(EGLSurfaceImpl));
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-					if (!newSurface)
+						return EGL_FALSE;
+					}
+
+					if (_eglInternalIsLocked(walkerSurface))
 					{
-						g_localStorage.error = EGL_BAD_ALLOC;
+						g_localStorage.error = EGL_BAD_ACCESS;
 
-						return EGL_NO_SURFACE;
+						return EGL_FALSE;
 					}
 
-					if (!__createWindowSurface(newSurface, win, attrib_list, walkerDpy, walkerConfig, &g_localStorage.error))
+					EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+					while (walkerConfig && walkerConfig->configId != walkerSurface->configId)
 					{
-						free(newSurface);
+						walkerConfig = walkerConfig->next;
+					}
 
-						return EGL_NO_SURFACE;
+					if (!walkerConfig || !(walkerConfig->surfaceType & EGL_LOCK_SURFACE_BIT_KHR))
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
 					}
 
-					newSurface->next = walkerDpy->rootSurface;
+					EGLBoolean preservePixels = EGL_FALSE;
+					EGLint usageHint = EGL_READ_SURFACE_BIT_KHR | EGL_WRITE_SURFACE_BIT_KHR;
 
-					walkerDpy->rootSurface = newSurface;
+					EGLint index = 0;
 
-					return (EGLSurface)newSurface;
+					while (attrib_list && attrib_list[index] != EGL_NONE)
+					{
+						switch (attrib_list[index])
+						{
+							case EGL_MAP_PRESERVE_PIXELS_KHR:
+								preservePixels = attrib_list[index + 1] ? EGL_TRUE : EGL_FALSE;
+							break;
+							case EGL_LOCK_USAGE_HINT_KHR:
+								if (attrib_list[index + 1] & ~(EGL_READ_SURFACE_BIT_KHR | EGL_WRITE_SURFACE_BIT_KHR))
+								{
+									g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+									return EGL_FALSE;
+								}
+
+								usageHint = attrib_list[index + 1];
+							break;
+							default:
+								g_localStorage.error = EGL_BAD_ATTRIBUTE;
+
+								return EGL_FALSE;
+						}
+
+						index += 2;
+					}
+
+					// Windows and pixmaps are accessed by the X server, so they must not be rendered to while locked.
+					// A pbuffer is transferred with its context, so it has to be current to the calling thread instead.
+					if (walkerSurface->drawToPBuffer)
+					{
+						if (!_eglInternalIsLockCurrent(walkerDpy, walkerSurface))
+						{
+							g_localStorage.error = EGL_BAD_ACCESS;
+
+							return EGL_FALSE;
+						}
+					}
+					else if ((!walkerSurface->drawToWindow && !walkerSurface->drawToPixmap) || walkerDpy->currentDraw == walkerSurface || walkerDpy->currentRead == walkerSurface)
+					{
+						// A stream producer renders into the frames of the stream, which are no drawable of its own.
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					if (!walkerSurface->lock)
+					{
+						walkerSurface->lock = (EGLLockImpl*)calloc(1, sizeof(EGLLockImpl));
+
+						if (!walkerSurface->lock)
+						{
+							g_localStorage.error = EGL_BAD_ALLOC;
+
+							return EGL_FALSE;
+						}
+					}
+
+					if (!_eglInternalPrepareLock(walkerDpy, walkerSurface))
+					{
+						return EGL_FALSE;
+					}
+
+					EGLLockImpl* lock = walkerSurface->lock;
+
+					lock->locked = EGL_TRUE;
+					lock->preservePixels = preservePixels;
+					lock->usageHint = usageHint;
+					lock->mapped = EGL_FALSE;
+
+					return EGL_TRUE;
 				}
 
-				walkerConfig = walkerConfig->next;
+				walkerSurface = walkerSurface->next;
 			}
 
-			g_localStorage.error = EGL_BAD_CONFIG;
+			g_localStorage.error = EGL_BAD_SURFACE;
 
-			return EGL_NO_SURFACE;
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
-	
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
-	return EGL_NO_SURFACE;
+	return EGL_FALSE;
 }
 
-EGLBoolean _eglDestroyContext(EGLDisplay dpy, EGLContext ctx)
+EGLBoolean _eglUnlockSurfaceKHR(EGLDisplay dpy, EGLSurface surface)
 {
-	EGLBoolean success = EGL_FALSE;
-	{
-		auto _rl = g_globalStorage.placeRootDpy_readlock();
-		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
-		while (walkerDpy)
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			if ((EGLDisplay)walkerDpy == dpy)
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
-				guard_t _{ walkerDpy->mutex };
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				if (!walkerDpy->initialized || walkerDpy->destroy)
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					g_localStorage.error = EGL_NOT_INITIALIZED;
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-					return EGL_FALSE;
-				}
+						return EGL_FALSE;
+					}
 
-				EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+					EGLLockImpl* lock = walkerSurface->lock;
 
-				while (walkerCtx)
-				{
-					if ((EGLContext)walkerCtx == ctx)
+					if (!lock || !lock->locked)
 					{
-						if (!walkerCtx->initialized || walkerCtx->destroy)
-						{
-							g_localStorage.error = EGL_BAD_CONTEXT;
+						g_localStorage.error = EGL_BAD_PARAMETER;
 
-							return EGL_FALSE;
-						}
+						return EGL_FALSE;
+					}
 
-						walkerCtx->initialized = EGL_FALSE;
-						walkerCtx->destroy = EGL_TRUE;
+					lock->locked = EGL_FALSE;
 
-						success = EGL_TRUE;
-						break;
+					// Nothing was written, if the bitmap was never mapped or only read.
+					if (!lock->mapped || !(lock->usageHint & EGL_WRITE_SURFACE_BIT_KHR))
+					{
+						return EGL_TRUE;
 					}
 
-					walkerCtx = walkerCtx->next;
-				}
+					lock->mapped = EGL_FALSE;
 
-				g_localStorage.error = EGL_BAD_CONTEXT;
+					if (lock->image)
+					{
+						return __writeShmImage(walkerDpy, lock->image, &g_localStorage.error);
+					}
 
-				if (!success)
-					return EGL_FALSE;
+					// The surface is unlocked anyway, but the pixels are lost.
+					if (!_eglInternalIsLockCurrent(walkerDpy, walkerSurface))
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					if (!_eglInternalWriteLockBitmap(lock))
+					{
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
+					}
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			walkerDpy = walkerDpy->next;
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
+
+		walkerDpy = walkerDpy->next;
 	}
-	
-	if (success)
-		_eglInternalCleanup();
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglDestroySurface(EGLDisplay dpy, EGLSurface surface)
+EGLBoolean _eglQuerySurface64KHR(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLAttribKHR *value)
 {
-	EGLBoolean success = EGL_FALSE;
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
+	while (walkerDpy)
 	{
-		auto _rl = g_globalStorage.placeRootDpy_readlock();
-		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
-
-		while (walkerDpy)
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			if ((EGLDisplay)walkerDpy == dpy)
-			{
-				guard_t _{ walkerDpy->mutex };
+			shared_guard_t _{ walkerDpy->mutex };
 
-				if (!walkerDpy->initialized || walkerDpy->destroy)
-				{
-					g_localStorage.error = EGL_NOT_INITIALIZED;
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-					return EGL_FALSE;
-				}
+				return EGL_FALSE;
+			}
 
-				EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-				while (walkerSurface)
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if ((EGLSurface)walkerSurface == surface)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						if (!walkerSurface->initialized || walkerSurface->destroy)
-						{
-							g_localStorage.error = EGL_BAD_SURFACE;
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-							return EGL_FALSE;
-						}
+						return EGL_FALSE;
+					}
 
-						walkerSurface->initialized = EGL_FALSE;
-						walkerSurface->destroy = EGL_TRUE;
+					object_guard_t surfaceLock{ *walkerSurface->mutex };
 
-						__destroySurface(walkerDpy->display_id, walkerSurface);
+					if (!value)
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
 
-						success = EGL_TRUE;
-						break;
+						return EGL_FALSE;
 					}
 
-					walkerSurface = walkerSurface->next;
+					return _eglInternalQuerySurface(walkerDpy, walkerSurface, attribute, value);
 				}
 
-				g_localStorage.error = EGL_BAD_SURFACE;
-
-				if (!success)
-					return EGL_FALSE;
+				walkerSurface = walkerSurface->next;
 			}
 
-			walkerDpy = walkerDpy->next;
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
-	}
 
-	if (success)
-		_eglInternalCleanup();
+		walkerDpy = walkerDpy->next;
+	}
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
-	return success;
+	return EGL_FALSE;
 }
 
-EGLBoolean _eglGetConfigAttrib(EGLDisplay dpy, EGLConfig config, EGLint attribute, EGLint *value)
+//
+// EGL_EXT_swap_buffers_with_damage
+//
+
+EGLBoolean _eglSwapBuffersWithDamageEXT(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
 {
-	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	return _eglInternalSwapBuffers(dpy, surface, rects, n_rects);
+}
+
+//
+// EGL_KHR_partial_update
+//
 
+EGLBoolean _eglSetDamageRegionKHR(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
 	while (walkerDpy)
@@ -1598,328 +10214,86 @@ EGLBoolean _eglGetConfigAttrib(EGLDisplay dpy, EGLConfig config, EGLint attribut
 				return EGL_FALSE;
 			}
 
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
-
-			while (walkerConfig)
-			{
-				if ((EGLConfig)walkerConfig == config)
-				{
-					break;
-				}
-
-				walkerConfig = walkerConfig->next;
-			}
-
-			if (!walkerConfig)
-			{
-				g_localStorage.error = EGL_BAD_CONFIG;
-
-				return EGL_FALSE;
-			}
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-			switch (attribute)
+			while (walkerSurface)
 			{
-				case EGL_ALPHA_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->alphaSize;
-					}
-				}
-				break;
-				case EGL_ALPHA_MASK_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->alphaMaskSize;
-					}
-				}
-				break;
-				case EGL_BIND_TO_TEXTURE_RGB:
-				{
-					if (value)
-					{
-						*value = walkerConfig->bindToTextureRGB;
-					}
-				}
-				break;
-				case EGL_BIND_TO_TEXTURE_RGBA:
-				{
-					if (value)
-					{
-						*value = walkerConfig->bindToTextureRGBA;
-					}
-				}
-				break;
-				case EGL_BLUE_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->blueSize;
-					}
-				}
-				break;
-				case EGL_BUFFER_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->bufferSize;
-					}
-				}
-				break;
-				case EGL_COLOR_BUFFER_TYPE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->colorBufferType;
-					}
-				}
-				break;
-				case EGL_CONFIG_CAVEAT:
-				{
-					if (value)
-					{
-						*value = walkerConfig->configCaveat;
-					}
-				}
-				break;
-				case EGL_CONFIG_ID:
-				{
-					if (value)
-					{
-						*value = walkerConfig->configId;
-					}
-				}
-				break;
-				case EGL_CONFORMANT:
-				{
-					if (value)
-					{
-						*value = walkerConfig->conformant;
-					}
-				}
-				break;
-				case EGL_DEPTH_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->depthSize;
-					}
-				}
-				break;
-				case EGL_GREEN_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->greenSize;
-					}
-				}
-				break;
-				case EGL_LEVEL:
-				{
-					if (value)
-					{
-						*value = walkerConfig->level;
-					}
-				}
-				break;
-				case EGL_LUMINANCE_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->luminanceSize;
-					}
-				}
-				break;
-				case EGL_MAX_PBUFFER_WIDTH:
-				{
-					if (value)
-					{
-						*value = walkerConfig->maxPBufferWidth;
-					}
-				}
-				break;
-				case EGL_MAX_PBUFFER_HEIGHT:
-				{
-					if (value)
-					{
-						*value = walkerConfig->maxPBufferHeight;
-					}
-				}
-				break;
-				case EGL_MAX_PBUFFER_PIXELS:
-				{
-					if (value)
-					{
-						*value = walkerConfig->maxPBufferPixels;
-					}
-				}
-				break;
-				case EGL_MAX_SWAP_INTERVAL:
-				{
-					if (value)
-					{
-						*value = walkerConfig->maxSwapInterval;
-					}
-				}
-				break;
-				case EGL_MIN_SWAP_INTERVAL:
-				{
-					if (value)
-					{
-						*value = walkerConfig->minSwapInterval;
-					}
-				}
-				break;
-				case EGL_NATIVE_RENDERABLE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->nativeRenderable;
-					}
-				}
-				break;
-				case EGL_NATIVE_VISUAL_ID:
-				{
-					if (value)
-					{
-						*value = walkerConfig->nativeVisualId;
-					}
-				}
-				break;
-				case EGL_NATIVE_VISUAL_TYPE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->nativeVisualType;
-					}
-				}
-				break;
-				case EGL_RED_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->redSize;
-					}
-				}
-				break;
-				case EGL_RENDERABLE_TYPE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->renderableType;
-					}
-				}
-				break;
-				case EGL_SAMPLE_BUFFERS:
-				{
-					if (value)
-					{
-						*value = walkerConfig->sampleBuffers;
-					}
-				}
-				break;
-				case EGL_SAMPLES:
-				{
-					if (value)
-					{
-						*value = walkerConfig->samples;
-					}
-				}
-				break;
-				case EGL_STENCIL_SIZE:
-				{
-					if (value)
-					{
-						*value = walkerConfig->stencilSize;
-					}
-				}
-				break;
-				case EGL_SURFACE_TYPE:
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					if (value)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						*value = walkerConfig->surfaceType;
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_TRANSPARENT_TYPE:
-				{
-					if (value)
+
+					if (!_eglInternalIsCurrentDraw(walkerDpy, walkerSurface) || walkerSurface->swapBehavior == EGL_BUFFER_PRESERVED)
 					{
-						*value = walkerConfig->transparentType;
+						g_localStorage.error = EGL_BAD_MATCH;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_TRANSPARENT_RED_VALUE:
-				{
-					if (value)
+
+					// Once per frame, after the buffer age was queried.
+					if (walkerSurface->damageSet || !walkerSurface->ageQueried)
 					{
-						*value = walkerConfig->transparentRedValue;
+						g_localStorage.error = EGL_BAD_ACCESS;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_TRANSPARENT_GREEN_VALUE:
-				{
-					if (value)
+
+					if (n_rects < 0 || (n_rects > 0 && !rects))
 					{
-						*value = walkerConfig->transparentGreenValue;
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
 					}
-				}
-				break;
-				case EGL_TRANSPARENT_BLUE_VALUE:
-				{
-					if (value)
+
+					if (n_rects > 0)
 					{
-						*value = walkerConfig->transparentBlueValue;
+						EGLint* damageRects = (EGLint*)realloc(walkerSurface->damageRects, (size_t)n_rects * 4 * sizeof(EGLint));
+
+						if (!damageRects)
+						{
+							g_localStorage.error = EGL_BAD_ALLOC;
+
+							return EGL_FALSE;
+						}
+
+						memcpy(damageRects, rects, (size_t)n_rects * 4 * sizeof(EGLint));
+
+						walkerSurface->damageRects = damageRects;
 					}
-				}
-				break;
-				default:
-				{
-					g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-					return EGL_FALSE;
+					// Zero rectangles mean, that the whole surface is damaged.
+					walkerSurface->numberDamageRects = n_rects;
+					walkerSurface->damageSet = EGL_TRUE;
+
+					return EGL_TRUE;
 				}
-				break;
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			return EGL_TRUE;
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
 
-	
-
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglGetConfigs(EGLDisplay dpy, EGLConfig *configs, EGLint config_size, EGLint *num_config)
-{
-	if (!configs)
-	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
-
-		return EGL_FALSE;
-	}
-
-	if (config_size == 0)
-	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
-
-		return EGL_FALSE;
-	}
-
-	if (!num_config)
-	{
-		g_localStorage.error = EGL_BAD_PARAMETER;
-
-		return EGL_FALSE;
-	}
+//
+// EGL_ANDROID_get_frame_timestamps
+//
 
+EGLBoolean _eglGetCompositorTimingSupportedANDROID(EGLDisplay dpy, EGLSurface surface, EGLint name)
+{
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
@@ -1936,22 +10310,28 @@ EGLBoolean _eglGetConfigs(EGLDisplay dpy, EGLConfig *configs, EGLint config_size
 				return EGL_FALSE;
 			}
 
-			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
-
-			EGLint configIndex = 0;
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-			while (walkerConfig && configIndex < config_size)
+			while (walkerSurface)
 			{
-				configs[configIndex] = walkerConfig;
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-				walkerConfig = walkerConfig->next;
+						return EGL_FALSE;
+					}
 
-				configIndex++;
+					return _eglInternalIsCompositorTimingSupported(walkerDpy, walkerSurface, name);
+				}
+
+				walkerSurface = walkerSurface->next;
 			}
 
-			*num_config = configIndex;
+			g_localStorage.error = EGL_BAD_SURFACE;
 
-			return EGL_TRUE;
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -1962,131 +10342,185 @@ EGLBoolean _eglGetConfigs(EGLDisplay dpy, EGLConfig *configs, EGLint config_size
 	return EGL_FALSE;
 }
 
-EGLDisplay _eglGetCurrentDisplay(void)
+EGLBoolean _eglGetCompositorTimingANDROID(EGLDisplay dpy, EGLSurface surface, EGLint numTimestamps, const EGLint *names, EGLnsecsANDROID *values)
 {
-	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
-	{
-		return EGL_NO_DISPLAY;
-	}
-
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
 	while (walkerDpy)
 	{
-		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			return (EGLDisplay)walkerDpy;
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					if (!walkerSurface->timestamps)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
+
+						return EGL_FALSE;
+					}
+
+					if (numTimestamps < 0 || (numTimestamps > 0 && (!names || !values)))
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
+
+						return EGL_FALSE;
+					}
+
+					for (EGLint i = 0; i < numTimestamps; i++)
+					{
+						if (!_eglInternalIsCompositorTimingSupported(walkerDpy, walkerSurface, names[i]))
+						{
+							g_localStorage.error = EGL_BAD_PARAMETER;
+
+							return EGL_FALSE;
+						}
+					}
+
+					EGLnsecsANDROID interval;
+					EGLnsecsANDROID ust;
+					EGLuint64KHR msc;
+					EGLuint64KHR sbc;
+
+					if (!__queryRefreshInterval(walkerDpy, walkerSurface, &interval))
+					{
+						interval = EGL_TIMESTAMP_INVALID_ANDROID;
+					}
+
+					if (!__querySwapCompletion(walkerDpy, walkerSurface, &ust, &msc, &sbc) || sbc == 0)
+					{
+						ust = EGL_TIMESTAMP_INVALID_ANDROID;
+					}
+
+					for (EGLint i = 0; i < numTimestamps; i++)
+					{
+						switch (names[i])
+						{
+							case EGL_COMPOSITE_DEADLINE_ANDROID:
+							{
+								// The next vertical blank, extrapolated from the completion of the last swap.
+								values[i] = EGL_TIMESTAMP_INVALID_ANDROID;
+
+								if (interval > 0 && ust >= 0)
+								{
+									const EGLnsecsANDROID now = (EGLnsecsANDROID)_eglInternalGetTime();
+
+									values[i] = ust + ((now > ust ? (now - ust) / interval : 0) + 1) * interval;
+								}
+							}
+							break;
+							case EGL_COMPOSITE_INTERVAL_ANDROID:
+								values[i] = interval;
+							break;
+						}
+					}
+
+					return EGL_TRUE;
+				}
+
+				walkerSurface = walkerSurface->next;
+			}
+
+			g_localStorage.error = EGL_BAD_SURFACE;
+
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
-	
 
-	return EGL_NO_DISPLAY;
+	g_localStorage.error = EGL_BAD_DISPLAY;
+
+	return EGL_FALSE;
 }
 
-EGLSurface _eglGetCurrentSurface(EGLint readdraw)
+EGLBoolean _eglGetNextFrameIdANDROID(EGLDisplay dpy, EGLSurface surface, EGLuint64KHR *frameId)
 {
-	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
-	{
-		return EGL_NO_SURFACE;
-	}
-
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
 	while (walkerDpy)
 	{
-		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			if (readdraw == EGL_DRAW)
-			{
-				return (EGLSurface)walkerDpy->currentDraw;
-			}
-			else if (readdraw == EGL_READ)
-			{
-				return (EGLSurface)walkerDpy->currentRead;
-			}
+			guard_t _{ walkerDpy->mutex };
 
-			return EGL_NO_SURFACE;
-		}
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-		walkerDpy = walkerDpy->next;
-	}
+				return EGL_FALSE;
+			}
 
-	return EGL_NO_SURFACE;
-}
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-EGLDisplay _eglGetDisplay(EGLNativeDisplayType display_id)
-{
-	if (!_eglInternalInit())
-	{
-		return EGL_NO_DISPLAY;
-	}
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
+				{
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-	//
-	{
-		auto _rl = g_globalStorage.placeRootDpy_readlock();
+						return EGL_FALSE;
+					}
 
-		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+					if (!walkerSurface->timestamps)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-		while (walkerDpy)
-		{
-			if (walkerDpy->display_id == display_id)
-			{
-				return (EGLDisplay)walkerDpy;
-			}
+						return EGL_FALSE;
+					}
 
-			walkerDpy = walkerDpy->next;
-		}
-	}
+					if (!frameId)
+					{
+						g_localStorage.error = EGL_BAD_PARAMETER;
 
-	EGLDisplayImpl* newDpy = new EGLDisplayImpl();
+						return EGL_FALSE;
+					}
 
-	if (!newDpy)
-	{
-		return EGL_NO_DISPLAY;
-	}
+					*frameId = walkerSurface->nextFrameId;
 
-	newDpy->initialized = EGL_FALSE;
-	newDpy->destroy = EGL_FALSE;
-#if defined(_WIN32) || defined(_WIN64)
-	newDpy->display_id = display_id ? display_id : g_globalStorage.dummy_read().hdc;
-#elif defined(__ANDROID__) || defined(ANDROID) || defined(WL_EGL_PLATFORM)
-	newDpy->display_id = 0;
-#else
-	newDpy->display_id = display_id ? display_id : g_globalStorage.dummy_read().display;
-#endif
-	newDpy->rootSurface = 0;
-	newDpy->rootCtx = 0;
-	newDpy->rootConfig = 0;
-	newDpy->currentDraw = EGL_NO_SURFACE_IMPL;
-	newDpy->currentRead = EGL_NO_SURFACE_IMPL;
-	newDpy->currentCtx = EGL_NO_CONTEXT_IMPL;
-	newDpy->next = g_globalStorage.rootDpy;
+					return EGL_TRUE;
+				}
 
-	auto _wl = g_globalStorage.placeRootDpy_writelock();
-	g_globalStorage.rootDpy = newDpy;
+				walkerSurface = walkerSurface->next;
+			}
 
-	return newDpy;
-}
+			g_localStorage.error = EGL_BAD_SURFACE;
 
-EGLint _eglGetError(void)
-{
-	EGLint currentError = g_localStorage.error;
+			return EGL_FALSE;
+		}
 
-	g_localStorage.error = EGL_SUCCESS;
+		walkerDpy = walkerDpy->next;
+	}
 
-	return currentError;
-}
+	g_localStorage.error = EGL_BAD_DISPLAY;
 
-__eglMustCastToProperFunctionPointerType _eglGetProcAddress(const char *procname)
-{
-	return __getProcAddress(procname);
+	return EGL_FALSE;
 }
 
-EGLBoolean _eglInitialize(EGLDisplay dpy, EGLint *major, EGLint *minor)
+EGLBoolean _eglGetFrameTimestampSupportedANDROID(EGLDisplay dpy, EGLSurface surface, EGLint timestamp)
 {
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
@@ -2097,39 +10531,35 @@ EGLBoolean _eglInitialize(EGLDisplay dpy, EGLint *major, EGLint *minor)
 		{
 			guard_t _{ walkerDpy->mutex };
 
-			if (walkerDpy->destroy)
+			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
 				g_localStorage.error = EGL_NOT_INITIALIZED;
 
 				return EGL_FALSE;
 			}
 
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
 			{
-				auto dummy = g_globalStorage.dummy_read();
-				EGLBoolean fail = (!walkerDpy->initialized && !__initialize(walkerDpy, &dummy, &g_localStorage.error));
-				g_globalStorage.dummy_write(dummy);
-				if (fail)
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					return EGL_FALSE;
-				}
-			}
-
-			walkerDpy->initialized = EGL_TRUE;
+					if (!walkerSurface->initialized || walkerSurface->destroy)
+					{
+						g_localStorage.error = EGL_BAD_SURFACE;
 
+						return EGL_FALSE;
+					}
 
-			//
+					return _eglInternalIsFrameTimestampSupported(walkerDpy, walkerSurface, timestamp);
+				}
 
-			if (major)
-			{
-				*major = 1;
+				walkerSurface = walkerSurface->next;
 			}
 
-			if (minor)
-			{
-				*minor = 5;
-			}
+			g_localStorage.error = EGL_BAD_SURFACE;
 
-			return EGL_TRUE;
+			return EGL_FALSE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -2140,269 +10570,331 @@ EGLBoolean _eglInitialize(EGLDisplay dpy, EGLint *major, EGLint *minor)
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLContext ctx)
+EGLBoolean _eglGetFrameTimestampsANDROID(EGLDisplay dpy, EGLSurface surface, EGLuint64KHR frameId, EGLint numTimestamps, const EGLint *timestamps, EGLnsecsANDROID *values)
 {
-	EGLBoolean success = EGL_FALSE;
-	{
-		auto _rl = g_globalStorage.placeRootDpy_readlock();
-		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
-		if ((ctx == EGL_NO_CONTEXT && (draw != EGL_NO_SURFACE || read != EGL_NO_SURFACE)) || (ctx != EGL_NO_CONTEXT && (draw == EGL_NO_SURFACE || read == EGL_NO_SURFACE)))
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			g_localStorage.error = EGL_BAD_MATCH;
-
-			return EGL_FALSE;
-		}
+			guard_t _{ walkerDpy->mutex };
 
-		while (walkerDpy)
-		{
-			if ((EGLDisplay)walkerDpy == dpy)
+			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
-				guard_t _{ walkerDpy->mutex };
-
-				if (!walkerDpy->initialized || walkerDpy->destroy)
-				{
-					g_localStorage.error = EGL_NOT_INITIALIZED;
-
-					return EGL_FALSE;
-				}
-
-				EGLSurfaceImpl* currentDraw = EGL_NO_SURFACE_IMPL;
-				EGLSurfaceImpl* currentRead = EGL_NO_SURFACE_IMPL;
-				EGLContextImpl* currentCtx = EGL_NO_CONTEXT_IMPL;
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				NativeSurfaceContainer* nativeSurfaceContainer = 0;
-				NativeContextContainer* nativeContextContainer = 0;
+				return EGL_FALSE;
+			}
 
-				EGLBoolean result;
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-				if (draw != EGL_NO_SURFACE)
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
-
-					while (walkerSurface)
+					if (!walkerSurface->initialized || walkerSurface->destroy)
 					{
-						if ((EGLSurface)walkerSurface == draw)
-						{
-							if (!walkerSurface->initialized || walkerSurface->destroy)
-							{
-								g_localStorage.error = EGL_BAD_NATIVE_WINDOW;
-
-								return EGL_FALSE;
-							}
-
-							currentDraw = walkerSurface;
-
-							break;
-						}
+						g_localStorage.error = EGL_BAD_SURFACE;
 
-						walkerSurface = walkerSurface->next;
+						return EGL_FALSE;
 					}
 
-					if (!currentDraw)
+					if (!walkerSurface->timestamps)
 					{
 						g_localStorage.error = EGL_BAD_SURFACE;
 
 						return EGL_FALSE;
 					}
-				}
-
-				if (read != EGL_NO_SURFACE)
-				{
-					EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
 
-					while (walkerSurface)
+					if (numTimestamps < 0 || (numTimestamps > 0 && (!timestamps || !values)))
 					{
-						if ((EGLSurface)walkerSurface == read)
-						{
-							if (!walkerSurface->initialized || walkerSurface->destroy)
-							{
-								g_localStorage.error = EGL_BAD_NATIVE_WINDOW;
+						g_localStorage.error = EGL_BAD_PARAMETER;
 
-								return EGL_FALSE;
-							}
+						return EGL_FALSE;
+					}
 
-							currentRead = walkerSurface;
+					for (EGLint i = 0; i < numTimestamps; i++)
+					{
+						if (!_eglInternalIsFrameTimestampSupported(walkerDpy, walkerSurface, timestamps[i]))
+						{
+							g_localStorage.error = EGL_BAD_PARAMETER;
 
-							break;
+							return EGL_FALSE;
 						}
-
-						walkerSurface = walkerSurface->next;
 					}
 
-					if (!currentRead)
+					_eglInternalUpdateFrames(walkerDpy, walkerSurface);
+
+					// The frame is not swapped yet or is too old.
+					const EGLFrameImpl* frame = _eglInternalFindFrame(walkerSurface, frameId);
+
+					if (!frame)
 					{
-						g_localStorage.error = EGL_BAD_SURFACE;
+						g_localStorage.error = EGL_BAD_ACCESS;
 
 						return EGL_FALSE;
 					}
-				}
-
-				if (ctx != EGL_NO_CONTEXT)
-				{
-					EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
 
-					while (walkerCtx)
+					for (EGLint i = 0; i < numTimestamps; i++)
 					{
-						if ((EGLContext)walkerCtx == ctx)
+						switch (timestamps[i])
 						{
-							if (!walkerCtx->initialized || walkerCtx->destroy)
-							{
-								g_localStorage.error = EGL_BAD_CONTEXT;
+							case EGL_SUBMIT_TIME_DESKTOP:
+								values[i] = frame->submitTime;
+							break;
+							case EGL_DISPLAY_PRESENT_TIME_ANDROID:
+								values[i] = frame->presentTime;
+							break;
+							case EGL_DISPLAY_PRESENT_MSC_DESKTOP:
+								values[i] = frame->presentMsc;
+							break;
+						}
+					}
 
-								return EGL_FALSE;
-							}
+					return EGL_TRUE;
+				}
 
-							currentCtx = walkerCtx;
+				walkerSurface = walkerSurface->next;
+			}
 
-							break;
-						}
+			g_localStorage.error = EGL_BAD_SURFACE;
 
-						walkerCtx = walkerCtx->next;
-					}
+			return EGL_FALSE;
+		}
 
-					if (!currentCtx)
-					{
-						g_localStorage.error = EGL_BAD_CONTEXT;
+		walkerDpy = walkerDpy->next;
+	}
 
-						return EGL_FALSE;
-					}
-				}
+	g_localStorage.error = EGL_BAD_DISPLAY;
 
-				if (currentDraw != EGL_NO_SURFACE)
+	return EGL_FALSE;
+}
+
+//
+// EGL_DESKTOP_readback_async
+//
+
+EGLReadbackDESKTOP _eglReadPixelsAsyncDESKTOP(EGLDisplay dpy, EGLSurface surface, const EGLint *attrib_list, EGLReadbackCallbackDESKTOP callback, void *user_data)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
+
+				return EGL_NO_READBACK_DESKTOP;
+			}
+
+			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+
+			while (walkerSurface)
+			{
+				if ((EGLSurface)walkerSurface == surface)
 				{
-					nativeSurfaceContainer = &currentDraw->nativeSurfaceContainer;
+					break;
 				}
 
-				if (currentCtx != EGL_NO_CONTEXT)
-				{
-					EGLContextListImpl* ctxList = currentCtx->rootCtxList;
+				walkerSurface = walkerSurface->next;
+			}
 
-					while (ctxList)
+			if (!walkerSurface || !walkerSurface->initialized || walkerSurface->destroy)
+			{
+				g_localStorage.error = EGL_BAD_SURFACE;
+
+				return EGL_NO_READBACK_DESKTOP;
+			}
+
+			// The default framebuffer reads from the read surface.
+			if (walkerDpy->currentDraw != walkerSurface || walkerDpy->currentRead != walkerSurface || walkerDpy->currentCtx != g_localStorage.currentCtx)
+			{
+				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+
+				return EGL_NO_READBACK_DESKTOP;
+			}
+
+			EGLint ringSize = _EGL_READBACK_RING_SIZE;
+
+			EGLint attribListIndex = 0;
+
+			while (attrib_list && attrib_list[attribListIndex] != EGL_NONE)
+			{
+				EGLint value = attrib_list[attribListIndex + 1];
+
+				switch (attrib_list[attribListIndex])
+				{
+					case EGL_READBACK_RING_SIZE_DESKTOP:
 					{
-						if (ctxList->surface == currentDraw)
+						if (value <= 0)
 						{
-							break;
+							g_localStorage.error = EGL_BAD_PARAMETER;
+
+							return EGL_NO_READBACK_DESKTOP;
 						}
 
-						ctxList = ctxList->next;
+						ringSize = value;
 					}
+					break;
+					default:
+					{
+						g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-					if (!ctxList)
+						return EGL_NO_READBACK_DESKTOP;
+					}
+					break;
+				}
+
+				attribListIndex += 2;
+			}
+
+			// The ring is recreated for another size or another context, but only if nothing is in flight.
+			if (walkerSurface->readbacks && (walkerSurface->numberReadbacks != ringSize || walkerSurface->readbackCtx != g_localStorage.currentCtx))
+			{
+				for (EGLint i = 0; i < walkerSurface->numberReadbacks; i++)
+				{
+					if (walkerSurface->readbacks[i].state != _EGL_READBACK_FREE)
 					{
-						ctxList = (EGLContextListImpl*)malloc(sizeof(EGLContextListImpl));
+						g_localStorage.error = EGL_BAD_ACCESS;
 
-						if (!ctxList)
-						{
-							return EGL_FALSE;
-						}
+						return EGL_NO_READBACK_DESKTOP;
+					}
+				}
 
-						// Gather shared context, if one exists.
-						EGLContextListImpl* sharedCtxList = 0;
-						if (currentCtx->sharedCtx)
-						{
-							EGLContextImpl* sharedWalkerCtx = currentCtx->sharedCtx;
-							EGLContextImpl* beforeSharedWalkerCtx = 0;
+				// The conversion objects of the same context are kept.
+				EGLConvertImpl* convert = walkerSurface->readbackCtx == g_localStorage.currentCtx ? walkerSurface->convert : 0;
+
+				if (convert)
+				{
+					walkerSurface->convert = 0;
+				}
 
-							while (sharedWalkerCtx)
-							{
-								// Check, if already created.
-								if (sharedWalkerCtx->rootCtxList)
-								{
-									sharedCtxList = sharedWalkerCtx->rootCtxList;
+				_eglInternalReleaseReadbacks(walkerSurface);
 
-									break;
-								}
+				walkerSurface->convert = convert;
+			}
 
-								beforeSharedWalkerCtx = sharedWalkerCtx;
-								sharedWalkerCtx = sharedWalkerCtx->sharedCtx;
+			if (!walkerSurface->readbacks)
+			{
+				walkerSurface->readbacks = (EGLReadbackImpl*)calloc((size_t)ringSize, sizeof(EGLReadbackImpl));
 
-								// No created shared context found.
-								if (!sharedWalkerCtx)
-								{
-									sharedCtxList = (EGLContextListImpl*)malloc(sizeof(EGLContextListImpl));
+				if (!walkerSurface->readbacks)
+				{
+					g_localStorage.error = EGL_BAD_ALLOC;
 
-									if (!sharedCtxList)
-									{
-										free(ctxList);
+					return EGL_NO_READBACK_DESKTOP;
+				}
 
-										return EGL_FALSE;
-									}
+				walkerSurface->numberReadbacks = ringSize;
+				walkerSurface->nextReadback = 0;
+				walkerSurface->readbackCtx = g_localStorage.currentCtx;
+			}
 
-									result = __createContext(&sharedCtxList->nativeContextContainer, walkerDpy, &currentDraw->nativeSurfaceContainer, 0, beforeSharedWalkerCtx->attribList);
+			_eglInternalDispatchReadbacks(walkerSurface);
 
-									if (!result)
-									{
-										free(sharedCtxList);
+			EGLReadbackImpl* readback = &walkerSurface->readbacks[walkerSurface->nextReadback];
 
-										free(ctxList);
+			// The oldest readback is still in flight or not released by the caller.
+			if (readback->state != _EGL_READBACK_FREE)
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
 
-										return EGL_FALSE;
-									}
+				return EGL_NO_READBACK_DESKTOP;
+			}
 
-									sharedCtxList->surface = currentDraw;
+			EGLint width = 0;
+			EGLint height = 0;
 
-									sharedCtxList->next = beforeSharedWalkerCtx->rootCtxList;
-									beforeSharedWalkerCtx->rootCtxList = sharedCtxList;
-								}
-							}
-						}
-						else
-						{
-							// Use own context as shared context, if one exits.
+			if (!_eglInternalSurfaceSize(walkerDpy, walkerSurface, &width, &height) || width <= 0 || height <= 0)
+			{
+				g_localStorage.error = EGL_BAD_SURFACE;
 
-							sharedCtxList = currentCtx->rootCtxList;
-						}
+				return EGL_NO_READBACK_DESKTOP;
+			}
 
-						result = __createContext(&ctxList->nativeContextContainer, walkerDpy, &currentDraw->nativeSurfaceContainer, sharedCtxList ? &sharedCtxList->nativeContextContainer : 0, currentCtx->attribList);
+			EGLBoolean convert = walkerSurface->readbackFormat == EGL_READBACK_FORMAT_NV12_DESKTOP || walkerSurface->readbackFormat == EGL_READBACK_FORMAT_I420_DESKTOP;
 
-						if (!result)
-						{
-							free(ctxList);
+			// The chroma planes are subsampled by two in both directions.
+			if (convert && ((width & 1) || (height & 1)))
+			{
+				g_localStorage.error = EGL_BAD_MATCH;
 
-							return EGL_FALSE;
-						}
+				return EGL_NO_READBACK_DESKTOP;
+			}
 
-						ctxList->surface = currentDraw;
+			size_t size = convert ? (size_t)width * (size_t)height * 3 / 2 : (size_t)width * (size_t)height * 4;
 
-						ctxList->next = currentCtx->rootCtxList;
-						currentCtx->rootCtxList = ctxList;
-					}
+			// The surface is read, not a framebuffer object of the application. The rows are tightly packed into the buffer,
+			// whatever pack state the application did set.
+			EGLReadStateImpl readState;
 
-					nativeContextContainer = &ctxList->nativeContextContainer;
-				}
+			_eglInternalBeginSurfaceRead(&readState, walkerSurface, 0, 4, 0);
 
-				success = result = __makeCurrent(walkerDpy, nativeSurfaceContainer, nativeContextContainer);
+			if (!readback->buffer)
+			{
+				glGenBuffers(1, &readback->buffer);
+			}
 
-				if (!result)
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+
+			if (readback->bufferSize != size)
+			{
+				glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_READ);
+
+				readback->bufferSize = size;
+			}
+
+			// Returns immediately, as the destination is a buffer object.
+			if (convert)
+			{
+				if (!_eglInternalConvertReadback(walkerSurface, width, height))
 				{
-					g_localStorage.error = EGL_BAD_MATCH;
+					_eglInternalEndSurfaceRead(&readState);
 
-					return EGL_FALSE;
+					g_localStorage.error = EGL_BAD_ALLOC;
+
+					return EGL_NO_READBACK_DESKTOP;
 				}
+			}
+			else
+			{
+				glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+			}
 
-				walkerDpy->currentDraw = currentDraw;
-				walkerDpy->currentRead = currentRead;
-				walkerDpy->currentCtx = currentCtx;
+			_eglInternalEndSurfaceRead(&readState);
 
-				g_localStorage.currentCtx = currentCtx;
+			readback->fence = (void*)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
-				break; // break displays loop
-			}
+			glFlush();
 
-			walkerDpy = walkerDpy->next;
+			readback->state = _EGL_READBACK_PENDING;
+			readback->width = width;
+			readback->height = height;
+			readback->size = size;
+			readback->callback = callback;
+			readback->userData = user_data;
+
+			walkerSurface->nextReadback = (walkerSurface->nextReadback + 1) % walkerSurface->numberReadbacks;
+
+			return (EGLReadbackDESKTOP)readback;
 		}
-	}
 
-	if (success)
-		_eglInternalCleanup();
+		walkerDpy = walkerDpy->next;
+	}
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
-	return success;
+	return EGL_NO_READBACK_DESKTOP;
 }
 
-EGLBoolean _eglQueryContext (EGLDisplay dpy, EGLContext ctx, EGLint attribute, EGLint *value)
+EGLint _eglClientWaitReadbackDESKTOP(EGLDisplay dpy, EGLReadbackDESKTOP readback, EGLTime timeout)
 {
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
@@ -2420,114 +10912,103 @@ EGLBoolean _eglQueryContext (EGLDisplay dpy, EGLContext ctx, EGLint attribute, E
 				return EGL_FALSE;
 			}
 
-			EGLContextImpl* walkerCtx = walkerDpy->rootCtx;
+			EGLSurfaceImpl* walkerSurface = 0;
 
-			while (walkerCtx)
+			EGLReadbackImpl* walkerReadback = _eglInternalFindReadback(walkerDpy, readback, &walkerSurface);
+
+			if (!walkerReadback || !_eglInternalIsReadbackCurrent(walkerDpy, walkerSurface))
 			{
-				if ((EGLContext)walkerCtx == ctx)
-				{
-					if (!walkerCtx->initialized || walkerCtx->destroy)
-					{
-						return EGL_FALSE;
-					}
+				return EGL_FALSE;
+			}
 
-					switch (attribute)
-					{
-						case EGL_CONFIG_ID:
-						{
-							if (value)
-							{
-								*value = walkerCtx->configId;
-							}
+			EGLint result = _eglInternalWaitReadback(walkerReadback, timeout);
 
-							return EGL_TRUE;
-						}
-						break;
-						case EGL_CONTEXT_CLIENT_TYPE:
-						{
-							if (value)
-							{
-								*value = EGL_OPENGL_API;
-							}
+			if (result == EGL_CONDITION_SATISFIED && walkerReadback->callback)
+			{
+				_eglInternalDeliverReadback(walkerReadback);
+			}
 
-							return EGL_TRUE;
-						}
-						break;
-						case EGL_CONTEXT_CLIENT_VERSION:
-						{
-							// Regarding the specification, it only makes sense for OpenGL ES.
+			return result;
+		}
 
-							return EGL_FALSE;
-						}
-						break;
-						case EGL_RENDER_BUFFER:
-						{
-							if (walkerDpy->currentCtx == walkerCtx)
-							{
-								EGLSurfaceImpl* currentSurface = walkerDpy->currentDraw ? walkerDpy->currentDraw : walkerDpy->currentRead;
+		walkerDpy = walkerDpy->next;
+	}
 
-								if (currentSurface)
-								{
-									if (currentSurface->drawToWindow)
-									{
-										if (value)
-										{
-											*value = currentSurface->doubleBuffer ? EGL_BACK_BUFFER : EGL_SINGLE_BUFFER;
-										}
+	g_localStorage.error = EGL_BAD_DISPLAY;
 
-										return EGL_TRUE;
-									}
-									else if (currentSurface->drawToPixmap)
-									{
-										if (value)
-										{
-											*value = EGL_SINGLE_BUFFER;
-										}
+	return EGL_FALSE;
+}
 
-										return EGL_TRUE;
-									}
-									else if (currentSurface->drawToPBuffer)
-									{
-										if (value)
-										{
-											*value = EGL_BACK_BUFFER;
-										}
+EGLBoolean _eglMapReadbackDESKTOP(EGLDisplay dpy, EGLReadbackDESKTOP readback, const void **pixels, EGLint *width, EGLint *height)
+{
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
-										return EGL_TRUE;
-									}
-								}
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
+		{
+			guard_t _{ walkerDpy->mutex };
 
-								if (value)
-								{
-									*value = EGL_NONE;
-								}
+			if (!walkerDpy->initialized || walkerDpy->destroy)
+			{
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-								return EGL_FALSE;
-							}
-							else
-							{
-								if (value)
-								{
-									*value = EGL_NONE;
-								}
+				return EGL_FALSE;
+			}
 
-								return EGL_FALSE;
-							}
-						}
-						break;
-					}
+			if (!pixels)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
 
-					g_localStorage.error = EGL_BAD_PARAMETER;
+				return EGL_FALSE;
+			}
+
+			EGLSurfaceImpl* walkerSurface = 0;
+
+			EGLReadbackImpl* walkerReadback = _eglInternalFindReadback(walkerDpy, readback, &walkerSurface);
+
+			if (!walkerReadback || !_eglInternalIsReadbackCurrent(walkerDpy, walkerSurface))
+			{
+				return EGL_FALSE;
+			}
 
+			// Delivered by the callback instead.
+			if (walkerReadback->callback)
+			{
+				g_localStorage.error = EGL_BAD_ACCESS;
+
+				return EGL_FALSE;
+			}
+
+			if (walkerReadback->state != _EGL_READBACK_MAPPED)
+			{
+				if (_eglInternalWaitReadback(walkerReadback, EGL_FOREVER) != EGL_CONDITION_SATISFIED)
+				{
 					return EGL_FALSE;
 				}
 
-				walkerCtx = walkerCtx->next;
+				if (!_eglInternalMapReadback(walkerReadback))
+				{
+					g_localStorage.error = EGL_BAD_ALLOC;
+
+					return EGL_FALSE;
+				}
 			}
 
-			g_localStorage.error = EGL_BAD_CONTEXT;
+			*pixels = walkerReadback->pixels;
 
-			return EGL_FALSE;
+			if (width)
+			{
+				*width = walkerReadback->width;
+			}
+
+			if (height)
+			{
+				*height = walkerReadback->height;
+			}
+
+			return EGL_TRUE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -2538,7 +11019,7 @@ EGLBoolean _eglQueryContext (EGLDisplay dpy, EGLContext ctx, EGLint attribute, E
 	return EGL_FALSE;
 }
 
-const char *_eglQueryString(EGLDisplay dpy, EGLint name)
+EGLBoolean _eglReleaseReadbackDESKTOP(EGLDisplay dpy, EGLReadbackDESKTOP readback)
 {
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
@@ -2553,36 +11034,21 @@ const char *_eglQueryString(EGLDisplay dpy, EGLint name)
 			{
 				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				return 0;
+				return EGL_FALSE;
 			}
 
-			switch (name)
+			EGLSurfaceImpl* walkerSurface = 0;
+
+			EGLReadbackImpl* walkerReadback = _eglInternalFindReadback(walkerDpy, readback, &walkerSurface);
+
+			if (!walkerReadback || !_eglInternalIsReadbackCurrent(walkerDpy, walkerSurface))
 			{
-				case EGL_CLIENT_APIS:
-				{
-					return "EGL_OPENGL_API";
-				}
-				break;
-				case EGL_VENDOR:
-				{
-					return _EGL_VENDOR;
-				}
-				break;
-				case EGL_VERSION:
-				{
-					return _EGL_VERSION;
-				}
-				break;
-				case EGL_EXTENSIONS:
-				{
-					return "";
-				}
-				break;
+				return EGL_FALSE;
 			}
 
-			g_localStorage.error = EGL_BAD_PARAMETER;
+			_eglInternalReleaseReadback(walkerReadback);
 
-			return 0;
+			return EGL_TRUE;
 		}
 
 		walkerDpy = walkerDpy->next;
@@ -2590,17 +11056,14 @@ const char *_eglQueryString(EGLDisplay dpy, EGLint name)
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
-	return 0;
-}
-
-EGLBoolean _eglQuerySurface (EGLDisplay dpy, EGLSurface surface, EGLint attribute, EGLint *value)
-{
-	// TODO Implement querying a surface.
-
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
+//
+// EGL_DESKTOP_shm_pixmap
+//
+
+EGLBoolean _eglCreateShmPixmapDESKTOP(EGLDisplay dpy, EGLConfig config, EGLint width, EGLint height, EGLNativePixmapType *pixmap, void **pixels, EGLint *stride)
 {
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
@@ -2615,29 +11078,56 @@ EGLBoolean _eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
 			{
 				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				return 0;
+				return EGL_FALSE;
 			}
 
-			EGLSurfaceImpl* walkerSurface = walkerDpy->rootSurface;
+			if (!pixmap || !pixels || !stride || width <= 0 || height <= 0)
+			{
+				g_localStorage.error = EGL_BAD_PARAMETER;
 
-			while (walkerSurface)
+				return EGL_FALSE;
+			}
+
+			EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+
+			while (walkerConfig)
 			{
-				if ((EGLSurface)walkerSurface == surface)
+				if ((EGLConfig)walkerConfig == config)
 				{
-					if (!walkerSurface->initialized || walkerSurface->destroy)
+					EGLShmImpl* newShm = (EGLShmImpl*)calloc(1, sizeof(EGLShmImpl));
+
+					if (!newShm)
 					{
-						g_localStorage.error = EGL_BAD_SURFACE;
+						g_localStorage.error = EGL_BAD_ALLOC;
+
+						return EGL_FALSE;
+					}
+
+					newShm->width = width;
+					newShm->height = height;
+
+					if (!__createShmPixmap(newShm, walkerDpy, walkerConfig, &g_localStorage.error))
+					{
+						free(newShm);
 
 						return EGL_FALSE;
 					}
 
-					return __swapBuffers(walkerDpy, walkerSurface);
+					newShm->next = walkerDpy->rootShm;
+
+					walkerDpy->rootShm = newShm;
+
+					*pixmap = newShm->pixmap;
+					*pixels = newShm->pixels;
+					*stride = newShm->stride;
+
+					return EGL_TRUE;
 				}
 
-				walkerSurface = walkerSurface->next;
+				walkerConfig = walkerConfig->next;
 			}
 
-			g_localStorage.error = EGL_BAD_SURFACE;
+			g_localStorage.error = EGL_BAD_CONFIG;
 
 			return EGL_FALSE;
 		}
@@ -2650,49 +11140,74 @@ EGLBoolean _eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
 	return EGL_FALSE;
 }
 
-EGLBoolean _eglTerminate(EGLDisplay dpy)
+EGLBoolean _eglDestroyShmPixmapDESKTOP(EGLDisplay dpy, EGLNativePixmapType pixmap)
 {
-	EGLBoolean success = EGL_FALSE;
-	{
-		auto _rl = g_globalStorage.placeRootDpy_readlock();
-		EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+	auto _rl = g_globalStorage.placeRootDpy_readlock();
+	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
-		while (walkerDpy)
+	while (walkerDpy)
+	{
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			if ((EGLDisplay)walkerDpy == dpy)
+			guard_t _{ walkerDpy->mutex };
+
+			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
-				guard_t _{ walkerDpy->mutex };
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
-				if (!walkerDpy->initialized || walkerDpy->destroy)
+				return EGL_FALSE;
+			}
+
+			EGLShmImpl* tempShm = 0;
+
+			EGLShmImpl* walkerShm = walkerDpy->rootShm;
+
+			while (walkerShm)
+			{
+				if (walkerShm->pixmap == pixmap)
 				{
-					g_localStorage.error = EGL_BAD_DISPLAY;
+					if (tempShm == 0)
+					{
+						walkerDpy->rootShm = walkerShm->next;
+					}
+					else
+					{
+						tempShm->next = walkerShm->next;
+					}
 
-					return EGL_FALSE;
+					// Surfaces on the pixmap have to be destroyed before.
+					__destroyShm(walkerDpy, walkerShm);
+
+					free(walkerShm);
+
+					return EGL_TRUE;
 				}
 
-				walkerDpy->initialized = EGL_FALSE;
-				walkerDpy->destroy = EGL_TRUE;
+				tempShm = walkerShm;
 
-				success = EGL_TRUE;
+				walkerShm = walkerShm->next;
 			}
 
-			walkerDpy = walkerDpy->next;
+			g_localStorage.error = EGL_BAD_NATIVE_PIXMAP;
+
+			return EGL_FALSE;
 		}
-	}
 
-	if (success)
-		_eglInternalCleanup();
+		walkerDpy = walkerDpy->next;
+	}
 
 	g_localStorage.error = EGL_BAD_DISPLAY;
 
 	return EGL_FALSE;
 }
 
+//
+// EGL_DESKTOP_config_attribs
+//
 
-
-EGLBoolean _eglWaitNative(EGLint engine)
+EGLBoolean _eglGetConfigAttribsDESKTOP(EGLDisplay dpy, const EGLConfig *configs, EGLint num_configs, const EGLint *attributes, EGLint num_attributes, EGLint *values)
 {
-	if (engine != EGL_CORE_NATIVE_ENGINE)
+	if (num_configs < 0 || num_attributes < 0 || (num_configs > 0 && !configs) || (num_attributes > 0 && !attributes) || (num_configs > 0 && num_attributes > 0 && !values))
 	{
 		g_localStorage.error = EGL_BAD_PARAMETER;
 
@@ -2704,44 +11219,83 @@ EGLBoolean _eglWaitNative(EGLint engine)
 
 	while (walkerDpy)
 	{
-		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
+		if ((EGLDisplay)walkerDpy == dpy)
 		{
-			guard_t _{ walkerDpy->mutex };
-
-			if (walkerDpy->currentDraw && (!walkerDpy->currentDraw->initialized || walkerDpy->currentDraw->destroy))
+			// The config table does not change, while it is published.
+			if (!_eglInternalConfigsPublished(walkerDpy))
 			{
-				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
 				return EGL_FALSE;
 			}
 
-			if (walkerDpy->currentRead && (!walkerDpy->currentRead->initialized || walkerDpy->currentRead->destroy))
+			for (EGLint attributeIndex = 0; attributeIndex < num_attributes; attributeIndex++)
 			{
-				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+				if (_eglInternalConfigAttribOffset(attributes[attributeIndex]) < 0)
+				{
+					g_localStorage.error = EGL_BAD_ATTRIBUTE;
 
-				return EGL_FALSE;
+					return EGL_FALSE;
+				}
 			}
 
-			break;
+			for (EGLint configIndex = 0; configIndex < num_configs; configIndex++)
+			{
+				const EGLConfigImpl* walkerConfig = _eglInternalFindConfig(walkerDpy, configs[configIndex]);
+
+				if (!walkerConfig)
+				{
+					g_localStorage.error = EGL_BAD_CONFIG;
+
+					return EGL_FALSE;
+				}
+
+				EGLint* configValues = values + (size_t)configIndex * (size_t)num_attributes;
+
+				for (EGLint attributeIndex = 0; attributeIndex < num_attributes; attributeIndex++)
+				{
+					configValues[attributeIndex] = _eglInternalConfigAttrib(walkerConfig, _eglInternalConfigAttribOffset(attributes[attributeIndex]));
+				}
+			}
+
+			return EGL_TRUE;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
 
-	if (g_localStorage.api == EGL_OPENGL_API)
-	{
-		glFinish();
-	}
+	g_localStorage.error = EGL_BAD_DISPLAY;
 
-	return EGL_TRUE;
+	return EGL_FALSE;
 }
 
 //
-// EGL_VERSION_1_1
+// EGL_DESKTOP_context_pool
 //
 
-EGLBoolean _eglSwapInterval(EGLDisplay dpy, EGLint interval)
+EGLBoolean _eglPrewarmContextsDESKTOP(EGLDisplay dpy, EGLConfig config, EGLint surface_type, EGLContext share_context, const EGLint *attrib_list, EGLint count)
 {
+	if (!attrib_list || count <= 0)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (surface_type != EGL_WINDOW_BIT && surface_type != EGL_PIXMAP_BIT && surface_type != EGL_PBUFFER_BIT)
+	{
+		g_localStorage.error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	if (g_localStorage.api == EGL_NONE)
+	{
+		g_localStorage.error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
 	auto _rl = g_globalStorage.placeRootDpy_readlock();
 	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
 
@@ -2753,125 +11307,114 @@ EGLBoolean _eglSwapInterval(EGLDisplay dpy, EGLint interval)
 
 			if (!walkerDpy->initialized || walkerDpy->destroy)
 			{
-				g_localStorage.error = EGL_BAD_DISPLAY;
+				g_localStorage.error = EGL_NOT_INITIALIZED;
 
 				return EGL_FALSE;
 			}
 
-			if (walkerDpy->currentDraw == EGL_NO_SURFACE || walkerDpy->currentRead == EGL_NO_SURFACE)
+			if (!(walkerDpy->nativeCaps & _EGL_NATIVE_CONTEXT_POOL))
 			{
-				g_localStorage.error = EGL_BAD_SURFACE;
+				g_localStorage.error = EGL_BAD_ACCESS;
 
 				return EGL_FALSE;
 			}
 
-			if (walkerDpy->currentCtx == EGL_NO_CONTEXT)
+			const EGLConfigImpl* walkerConfig = _eglInternalFindConfig(walkerDpy, config);
+
+			if (!walkerConfig)
 			{
-				g_localStorage.error = EGL_BAD_CONTEXT;
+				g_localStorage.error = EGL_BAD_CONFIG;
 
 				return EGL_FALSE;
 			}
 
-			return __swapInterval(walkerDpy, interval);
-		}
-
-		walkerDpy = walkerDpy->next;
-	}
+			if (!(walkerConfig->surfaceType & surface_type))
+			{
+				g_localStorage.error = EGL_BAD_MATCH;
 
-	g_localStorage.error = EGL_BAD_DISPLAY;
+				return EGL_FALSE;
+			}
 
-	return EGL_FALSE;
-}
+			EGLint target_attrib_list[CONTEXT_ATTRIB_LIST_SIZE];
 
-//
-// EGL_VERSION_1_2
-//
+			if (!__processAttribList(g_localStorage.api, target_attrib_list, attrib_list, &g_localStorage.error))
+			{
+				return EGL_FALSE;
+			}
 
-EGLBoolean _eglBindAPI(EGLenum api)
-{
-	if (api == EGL_OPENGL_API || api == EGL_OPENGL_ES_API)
-	{
-		g_localStorage.api = api;
+			// eglMakeCurrent shares a new native context with the first native context found along the shared contexts.
+			EGLContextListImpl* sharedCtxList = 0;
 
-		return EGL_TRUE;
-	}
+			if (share_context != EGL_NO_CONTEXT)
+			{
+				EGLContextImpl* sharedCtx = walkerDpy->rootCtx;
 
-	g_localStorage.error = EGL_BAD_PARAMETER;
+				while (sharedCtx && ((EGLContext)sharedCtx != share_context || !sharedCtx->initialized || sharedCtx->destroy))
+				{
+					sharedCtx = sharedCtx->next;
+				}
 
-	return EGL_FALSE;
-}
+				if (!sharedCtx)
+				{
+					g_localStorage.error = EGL_BAD_CONTEXT;
 
-EGLenum _eglQueryAPI(void)
-{
-	return g_localStorage.api;
-}
+					return EGL_FALSE;
+				}
 
-EGLBoolean _eglWaitClient(void)
-{
-	if (g_localStorage.currentCtx == EGL_NO_CONTEXT)
-	{
-		return EGL_TRUE;
-	}
+				while (sharedCtx && !sharedCtx->rootCtxList)
+				{
+					sharedCtx = sharedCtx->sharedCtx;
+				}
 
-	auto _rl = g_globalStorage.placeRootDpy_readlock();
-	EGLDisplayImpl* walkerDpy = g_globalStorage.rootDpy;
+				// The share group has no native context yet.
+				if (!sharedCtx)
+				{
+					g_localStorage.error = EGL_BAD_MATCH;
 
-	while (walkerDpy)
-	{
-		if (walkerDpy->currentCtx == g_localStorage.currentCtx)
-		{
-			guard_t _{ walkerDpy->mutex };
+					return EGL_FALSE;
+				}
 
-			if (!walkerDpy->initialized || walkerDpy->destroy)
-			{
-				return EGL_FALSE;
+				sharedCtxList = sharedCtx->rootCtxList;
 			}
 
-			if (walkerDpy->currentDraw && (!walkerDpy->currentDraw->initialized || walkerDpy->currentDraw->destroy))
-			{
-				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+			EGLContextPoolImpl* pool = _eglInternalStartContextPool(walkerDpy);
 
-				return EGL_FALSE;
-			}
+			object_guard_t poolLock{ pool->mutex };
 
-			if (walkerDpy->currentRead && (!walkerDpy->currentRead->initialized || walkerDpy->currentRead->destroy))
+			for (EGLint i = 0; i < count; i++)
 			{
-				g_localStorage.error = EGL_BAD_CURRENT_SURFACE;
+				EGLPooledContextImpl* request = (EGLPooledContextImpl*)malloc(sizeof(EGLPooledContextImpl));
 
-				return EGL_FALSE;
+				if (!request)
+				{
+					g_localStorage.error = EGL_BAD_ALLOC;
+
+					return EGL_FALSE;
+				}
+
+				request->config = walkerConfig;
+				request->surfaceType = surface_type;
+				memcpy(request->attribList, target_attrib_list, CONTEXT_ATTRIB_LIST_SIZE * sizeof(EGLint));
+				request->sharedCtxList = sharedCtxList;
+				memset(&request->nativeContextContainer, 0, sizeof(NativeContextContainer));
+
+				request->next = pool->rootRequest;
+				pool->rootRequest = request;
 			}
 
-			break;
+			pool->condition.notify_all();
+
+			return EGL_TRUE;
 		}
 
 		walkerDpy = walkerDpy->next;
 	}
 
-	if (g_localStorage.api == EGL_OPENGL_API)
-	{
-		glFinish();
-	}
-
-	return EGL_TRUE;
-}
-
-//
-// EGL_VERSION_1_3
-//
-
-//
-// EGL_VERSION_1_4
-//
+	g_localStorage.error = EGL_BAD_DISPLAY;
 
-EGLContext _eglGetCurrentContext(void)
-{
-	return g_localStorage.currentCtx;
+	return EGL_FALSE;
 }
 
-//
-// EGL_VERSION_1_5
-//
-
 //
 // non-standard stuff
 //
@@ -31,9 +31,14 @@
 
 #define _EGL_VERSION "1.5 Version 0.3.3"
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
 
 #if defined(_WIN32) || defined(__VC32__) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__) /* Win32 and WinCE */
 
@@ -51,6 +56,9 @@
 
 #define CONTEXT_ATTRIB_LIST_SIZE 13
 
+// Selects the pixel format attribute, which corresponds to an EGL config attribute.
+#define _EGL_NATIVE_CONFIG_ATTRIB(wgl, glx) wgl
+
 typedef struct _NativeSurfaceContainer {
 
 	HDC hdc;
@@ -75,12 +83,36 @@ typedef struct _NativeLocalStorageContainer {
 
 } NativeLocalStorageContainer;
 
+typedef struct _NativeStreamContainer {
+
+} NativeStreamContainer;
+
+typedef struct _NativeShmContainer {
+
+} NativeShmContainer;
+
+typedef struct _NativeDisplayContainer {
+
+} NativeDisplayContainer;
+
+typedef struct _NativeConfigContainer {
+
+} NativeConfigContainer;
+
 typedef HPBUFFERARB NativePbufferType;
 
 #elif defined(__ANDROID__) || defined(ANDROID) || defined(WL_EGL_PLATFORM)
 
+#if defined(WL_EGL_PLATFORM)
+#include <GL/gl.h>
+#else
+#include <GLES2/gl2.h>
+#endif
+
 #define CONTEXT_ATTRIB_LIST_SIZE 1
 
+#define _EGL_NATIVE_CONFIG_ATTRIB(wgl, glx) 0
+
 typedef struct _NativeSurfaceContainer {
 
 } NativeSurfaceContainer;
@@ -93,6 +125,22 @@ typedef struct _NativeLocalStorageContainer {
 
 } NativeLocalStorageContainer;
 
+typedef struct _NativeStreamContainer {
+
+} NativeStreamContainer;
+
+typedef struct _NativeShmContainer {
+
+} NativeShmContainer;
+
+typedef struct _NativeDisplayContainer {
+
+} NativeDisplayContainer;
+
+typedef struct _NativeConfigContainer {
+
+} NativeConfigContainer;
+
 typedef void* NativePbufferType;
 
 #elif defined(__unix__)
@@ -105,20 +153,30 @@ typedef void* NativePbufferType;
 #else
 #include <GL/glx.h>
 #endif  // EGL_NO_GLEW
+#include <X11/extensions/XShm.h>
 #define CONTEXT_ATTRIB_LIST_SIZE 11
 
+// Selects the FBConfig attribute, which corresponds to an EGL config attribute.
+#define _EGL_NATIVE_CONFIG_ATTRIB(wgl, glx) glx
+
 typedef struct _NativeSurfaceContainer {
 
 	GLXDrawable drawable;
 
 	GLXFBConfig config;
 
+	// X pixmap owned by EGL, if the drawable is a GLX pixmap created by EGL.
+	Pixmap pixmap;
+
 } NativeSurfaceContainer;
 
 typedef struct _NativeContextContainer {
 
 	GLXContext ctx;
 
+	// FBConfig, the context was created for.
+	GLXFBConfig config;
+
 } NativeContextContainer;
 
 typedef struct _NativeLocalStorageContainer {
@@ -131,6 +189,54 @@ typedef struct _NativeLocalStorageContainer {
 
 } NativeLocalStorageContainer;
 
+typedef struct _NativeStreamContainer {
+
+	// Unix domain socket, connected to the other process.
+	int socket;
+
+	// Shared memory holding the stream header and the frames.
+	int memory;
+	size_t memorySize;
+	void* mapped;
+
+	// Event file descriptors. Signaled by the producer after inserting a frame, by the consumer after releasing a frame.
+	int frameReady;
+	int frameFree;
+
+} NativeStreamContainer;
+
+typedef struct _NativeShmContainer {
+
+	// MIT-SHM segment, attached by the X server and this process.
+	XShmSegmentInfo shminfo;
+
+	// Either a pixmap or an image is created on the segment.
+	Pixmap pixmap;
+	XImage* image;
+
+} NativeShmContainer;
+
+typedef struct _NativeDisplayContainer {
+
+	// Private connection, which receives the structure events of the windows of window surfaces.
+	Display* events;
+
+} NativeDisplayContainer;
+
+typedef struct _NativeConfigContainer {
+
+	// Best FBConfig for each surface type of the config, which can be merged from several FBConfigs. Zero, if not supported.
+	GLXFBConfig window;
+	GLXFBConfig pixmap;
+	GLXFBConfig pbuffer;
+
+	// Rank of the FBConfigs above. Lower is better.
+	int windowRank;
+	int pixmapRank;
+	int pbufferRank;
+
+} NativeConfigContainer;
+
 typedef GLXPbuffer NativePbufferType;
 
 #else
@@ -138,6 +244,24 @@ typedef GLXPbuffer NativePbufferType;
 #endif
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <EGL/egldesktopext.h>
+
+// Native capabilities, detected during initialization of a display.
+
+#define _EGL_NATIVE_TEXTURE_FROM_PIXMAP 0x00000001
+#define _EGL_NATIVE_STREAM_CROSS_PROCESS 0x00000002
+#define _EGL_NATIVE_SHM 0x00000004
+#define _EGL_NATIVE_BUFFER_AGE 0x00000008
+#define _EGL_NATIVE_COPY_SUB_BUFFER 0x00000010
+#define _EGL_NATIVE_SYNC_CONTROL 0x00000020
+#define _EGL_NATIVE_SWAP_CONTROL 0x00000040
+#define _EGL_NATIVE_SWAP_CONTROL_TEAR 0x00000080
+#define _EGL_NATIVE_CONTEXT_POOL 0x00000100
+#define _EGL_NATIVE_THREADS 0x00000200
+#define _EGL_NATIVE_LOCK_SURFACE 0x00000400
+
+#define _EGL_EXTENSIONS_SIZE 1024
 
 //
 
@@ -250,10 +374,322 @@ typedef struct _EGLConfigImpl
 	EGLint drawToPBuffer;
 	EGLint doubleBuffer;
 
+	NativeConfigContainer nativeConfigContainer;
+
 	struct _EGLConfigImpl* next;
 
 } EGLConfigImpl;
 
+#define _EGL_CACHE_LINE_SIZE 64
+
+// Surface types, which have an index of the configs supporting them.
+#define _EGL_SURFACE_TYPE_INDEX_WINDOW 0
+#define _EGL_SURFACE_TYPE_INDEX_PIXMAP 1
+#define _EGL_SURFACE_TYPE_INDEX_PBUFFER 2
+#define _EGL_SURFACE_TYPE_INDEX_COUNT 3
+
+// Element of the config table of an initialized display. Each config starts on a cache line.
+typedef struct alignas(_EGL_CACHE_LINE_SIZE) _EGLConfigSlotImpl
+{
+
+	EGLConfigImpl config;
+
+} EGLConfigSlotImpl;
+
+// How eglChooseConfig matches a requested value against the one of a config.
+#define _EGL_MATCH_NONE 0
+#define _EGL_MATCH_AT_LEAST 1
+#define _EGL_MATCH_EXACT 2
+#define _EGL_MATCH_EXACT_ALWAYS 3
+#define _EGL_MATCH_MASK 4
+#define _EGL_MATCH_PIXMAP 5
+#define _EGL_MATCH_TRANSPARENT 6
+
+// Values, which eglChooseConfig accepts. Attributes without valid values can not be chosen.
+#define _EGL_VALID_NONE 0
+#define _EGL_VALID_ANY 1
+#define _EGL_VALID_SIZE 2
+#define _EGL_VALID_BOOLEAN 3
+#define _EGL_VALID_COLOR_BUFFER_TYPE 4
+#define _EGL_VALID_CAVEAT 5
+#define _EGL_VALID_API_MASK 6
+#define _EGL_VALID_SURFACE_MASK 7
+#define _EGL_VALID_TRANSPARENT_TYPE 8
+
+// Returned by eglGetConfigAttrib.
+#define _EGL_ATTRIB_QUERY 0x1
+// Read from the native config by __initialize.
+#define _EGL_ATTRIB_NATIVE_READ 0x2
+// Passed to the native config selection of the surfaces.
+#define _EGL_ATTRIB_NATIVE_CHOOSE 0x4
+
+typedef struct _EGLConfigAttribSchemaImpl
+{
+	EGLint attribute;
+	EGLint offset;
+	EGLint defaultValue;
+	EGLint match;
+	EGLint valid;
+	EGLint flags;
+	EGLint nativeAttribute;
+} EGLConfigAttribSchemaImpl;
+
+#define _EGL_CONFIG_FIELD(field) (EGLint)offsetof(EGLConfigImpl, field)
+
+// Every attribute of a config. The defaults are the ones of eglChooseConfig and of a config, before it is read from the native config.
+static constexpr EGLConfigAttribSchemaImpl g_configSchema[] = {
+	{ EGL_ALPHA_MASK_SIZE, _EGL_CONFIG_FIELD(alphaMaskSize), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_ALPHA_SIZE, _EGL_CONFIG_FIELD(alphaSize), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ | _EGL_ATTRIB_NATIVE_CHOOSE, _EGL_NATIVE_CONFIG_ATTRIB(WGL_ALPHA_BITS_ARB, GLX_ALPHA_SIZE) },
+	{ EGL_BIND_TO_TEXTURE_RGB, _EGL_CONFIG_FIELD(bindToTextureRGB), EGL_DONT_CARE, _EGL_MATCH_EXACT, _EGL_VALID_BOOLEAN, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(0, GLX_BIND_TO_TEXTURE_RGB_EXT) },
+	{ EGL_BIND_TO_TEXTURE_RGBA, _EGL_CONFIG_FIELD(bindToTextureRGBA), EGL_DONT_CARE, _EGL_MATCH_EXACT, _EGL_VALID_BOOLEAN, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(0, GLX_BIND_TO_TEXTURE_RGBA_EXT) },
+	{ EGL_BLUE_SIZE, _EGL_CONFIG_FIELD(blueSize), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ | _EGL_ATTRIB_NATIVE_CHOOSE, _EGL_NATIVE_CONFIG_ATTRIB(WGL_BLUE_BITS_ARB, GLX_BLUE_SIZE) },
+	{ EGL_BUFFER_SIZE, _EGL_CONFIG_FIELD(bufferSize), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ | _EGL_ATTRIB_NATIVE_CHOOSE, _EGL_NATIVE_CONFIG_ATTRIB(WGL_COLOR_BITS_ARB, GLX_BUFFER_SIZE) },
+	{ EGL_COLOR_BUFFER_TYPE, _EGL_CONFIG_FIELD(colorBufferType), EGL_DONT_CARE, _EGL_MATCH_EXACT, _EGL_VALID_COLOR_BUFFER_TYPE, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_CONFIG_CAVEAT, _EGL_CONFIG_FIELD(configCaveat), EGL_DONT_CARE, _EGL_MATCH_EXACT, _EGL_VALID_CAVEAT, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_ACCELERATION_ARB, GLX_CONFIG_CAVEAT) },
+	{ EGL_CONFIG_ID, _EGL_CONFIG_FIELD(configId), EGL_DONT_CARE, _EGL_MATCH_EXACT, _EGL_VALID_ANY, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_CONFORMANT, _EGL_CONFIG_FIELD(conformant), 0, _EGL_MATCH_MASK, _EGL_VALID_API_MASK, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_DEPTH_SIZE, _EGL_CONFIG_FIELD(depthSize), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ | _EGL_ATTRIB_NATIVE_CHOOSE, _EGL_NATIVE_CONFIG_ATTRIB(WGL_DEPTH_BITS_ARB, GLX_DEPTH_SIZE) },
+	{ EGL_GREEN_SIZE, _EGL_CONFIG_FIELD(greenSize), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ | _EGL_ATTRIB_NATIVE_CHOOSE, _EGL_NATIVE_CONFIG_ATTRIB(WGL_GREEN_BITS_ARB, GLX_GREEN_SIZE) },
+	{ EGL_LEVEL, _EGL_CONFIG_FIELD(level), 0, _EGL_MATCH_EXACT_ALWAYS, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_CHOOSE, _EGL_NATIVE_CONFIG_ATTRIB(0, GLX_LEVEL) },
+	{ EGL_LUMINANCE_SIZE, _EGL_CONFIG_FIELD(luminanceSize), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_MATCH_NATIVE_PIXMAP, _EGL_CONFIG_FIELD(matchNativePixmap), EGL_NONE, _EGL_MATCH_PIXMAP, _EGL_VALID_ANY, 0, 0 },
+	{ EGL_MAX_PBUFFER_HEIGHT, _EGL_CONFIG_FIELD(maxPBufferHeight), EGL_DONT_CARE, _EGL_MATCH_NONE, _EGL_VALID_NONE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_MAX_PBUFFER_HEIGHT_ARB, GLX_MAX_PBUFFER_HEIGHT) },
+	{ EGL_MAX_PBUFFER_PIXELS, _EGL_CONFIG_FIELD(maxPBufferPixels), EGL_DONT_CARE, _EGL_MATCH_NONE, _EGL_VALID_NONE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_MAX_PBUFFER_PIXELS_ARB, GLX_MAX_PBUFFER_PIXELS) },
+	{ EGL_MAX_PBUFFER_WIDTH, _EGL_CONFIG_FIELD(maxPBufferWidth), EGL_DONT_CARE, _EGL_MATCH_NONE, _EGL_VALID_NONE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_MAX_PBUFFER_WIDTH_ARB, GLX_MAX_PBUFFER_WIDTH) },
+	{ EGL_MAX_SWAP_INTERVAL, _EGL_CONFIG_FIELD(maxSwapInterval), EGL_DONT_CARE, _EGL_MATCH_EXACT, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_MIN_SWAP_INTERVAL, _EGL_CONFIG_FIELD(minSwapInterval), EGL_DONT_CARE, _EGL_MATCH_EXACT, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_NATIVE_RENDERABLE, _EGL_CONFIG_FIELD(nativeRenderable), EGL_DONT_CARE, _EGL_MATCH_EXACT, _EGL_VALID_BOOLEAN, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_NATIVE_VISUAL_ID, _EGL_CONFIG_FIELD(nativeVisualId), 0, _EGL_MATCH_NONE, _EGL_VALID_NONE, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_NATIVE_VISUAL_TYPE, _EGL_CONFIG_FIELD(nativeVisualType), EGL_NONE, _EGL_MATCH_NONE, _EGL_VALID_NONE, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_RED_SIZE, _EGL_CONFIG_FIELD(redSize), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ | _EGL_ATTRIB_NATIVE_CHOOSE, _EGL_NATIVE_CONFIG_ATTRIB(WGL_RED_BITS_ARB, GLX_RED_SIZE) },
+	{ EGL_RENDERABLE_TYPE, _EGL_CONFIG_FIELD(renderableType), EGL_OPENGL_ES_BIT, _EGL_MATCH_MASK, _EGL_VALID_API_MASK, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_SAMPLE_BUFFERS, _EGL_CONFIG_FIELD(sampleBuffers), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_SAMPLE_BUFFERS_ARB, GLX_SAMPLE_BUFFERS) },
+	{ EGL_SAMPLES, _EGL_CONFIG_FIELD(samples), 0, _EGL_MATCH_AT_LEAST, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_SAMPLES_ARB, GLX_SAMPLES) },
+	{ EGL_STENCIL_SIZE, _EGL_CONFIG_FIELD(stencilSize), 0, _EGL_MATCH_EXACT, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ | _EGL_ATTRIB_NATIVE_CHOOSE, _EGL_NATIVE_CONFIG_ATTRIB(WGL_STENCIL_BITS_ARB, GLX_STENCIL_SIZE) },
+	{ EGL_SURFACE_TYPE, _EGL_CONFIG_FIELD(surfaceType), EGL_WINDOW_BIT, _EGL_MATCH_MASK, _EGL_VALID_SURFACE_MASK, _EGL_ATTRIB_QUERY, 0 },
+	{ EGL_TRANSPARENT_BLUE_VALUE, _EGL_CONFIG_FIELD(transparentBlueValue), EGL_DONT_CARE, _EGL_MATCH_TRANSPARENT, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_TRANSPARENT_BLUE_VALUE_ARB, GLX_TRANSPARENT_BLUE_VALUE) },
+	{ EGL_TRANSPARENT_GREEN_VALUE, _EGL_CONFIG_FIELD(transparentGreenValue), EGL_DONT_CARE, _EGL_MATCH_TRANSPARENT, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_TRANSPARENT_GREEN_VALUE_ARB, GLX_TRANSPARENT_GREEN_VALUE) },
+	{ EGL_TRANSPARENT_RED_VALUE, _EGL_CONFIG_FIELD(transparentRedValue), EGL_DONT_CARE, _EGL_MATCH_TRANSPARENT, _EGL_VALID_SIZE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_TRANSPARENT_RED_VALUE_ARB, GLX_TRANSPARENT_RED_VALUE) },
+	{ EGL_TRANSPARENT_TYPE, _EGL_CONFIG_FIELD(transparentType), EGL_NONE, _EGL_MATCH_EXACT_ALWAYS, _EGL_VALID_TRANSPARENT_TYPE, _EGL_ATTRIB_QUERY | _EGL_ATTRIB_NATIVE_READ, _EGL_NATIVE_CONFIG_ATTRIB(WGL_TRANSPARENT_ARB, GLX_TRANSPARENT_TYPE) },
+};
+
+#define _EGL_CONFIG_SCHEMA_SIZE (EGLint)(sizeof(g_configSchema) / sizeof(g_configSchema[0]))
+
+// Field of a config, which is described by a row of the schema.
+#define _EGL_CONFIG_VALUE(config, schema) (*(EGLint*)((char*)(config) + (schema).offset))
+
+struct _EGLStreamImpl;
+struct _EGLSurfaceImpl;
+struct _EGLContextImpl;
+
+#define _EGL_READBACK_RING_SIZE 3
+
+#define _EGL_READBACK_FREE 0
+#define _EGL_READBACK_PENDING 1
+#define _EGL_READBACK_MAPPED 2
+
+typedef struct _EGLReadbackImpl
+{
+	// One of the _EGL_READBACK_* values.
+	EGLint state;
+
+	// Pixel pack buffer and the fence of the last readback into it.
+	unsigned int buffer;
+	size_t bufferSize;
+	void* fence;
+
+	// Size of the read back pixels, which depends on the readback format.
+	size_t size;
+
+	EGLint width;
+	EGLint height;
+
+	// Valid while mapped.
+	const void* pixels;
+
+	EGLReadbackCallbackDESKTOP callback;
+	void* userData;
+
+} EGLReadbackImpl;
+
+// Conversion pass from RGBA to planar YUV, which runs before the readback.
+typedef struct _EGLConvertImpl
+{
+	unsigned int program;
+	unsigned int vertexArray;
+	unsigned int framebuffer;
+
+	// Copy of the read buffer and the single channel target, holding all planes.
+	unsigned int sourceTexture;
+	unsigned int targetTexture;
+
+	EGLint width;
+	EGLint height;
+
+	EGLint sourceLocation;
+	EGLint sizeLocation;
+	EGLint layoutLocation;
+
+} EGLConvertImpl;
+
+#define _EGL_CLIENT_MEMORY_NONE 0
+#define _EGL_CLIENT_MEMORY_PINNED 1
+#define _EGL_CLIENT_MEMORY_PERSISTENT 2
+#define _EGL_CLIENT_MEMORY_DIRECT 3
+
+// GL_AMD_pinned_memory does only accept page aligned memory.
+#define _EGL_CLIENT_MEMORY_PAGE_SIZE 4096
+
+// Memory of the application, which receives the color buffer of a pbuffer on swap.
+typedef struct _EGLClientMemoryImpl
+{
+	void* memory;
+	EGLint stride;
+	EGLint width;
+	EGLint height;
+
+	// Bytes written, the last row is not padded to the stride.
+	size_t size;
+
+	// One of the _EGL_CLIENT_MEMORY_* paths. The buffer object belongs to the native context of ctx and the surface.
+	EGLint path;
+	unsigned int buffer;
+	void* mapped;
+	struct _EGLContextImpl* ctx;
+
+} EGLClientMemoryImpl;
+
+// Memory shared with the native window system. Either a pixmap of the application, or an image used by eglCopyBuffers or a surface lock.
+typedef struct _EGLShmImpl
+{
+	// The pixmap on the memory, or the target drawable the image was created for.
+	EGLNativePixmapType pixmap;
+
+	void* pixels;
+	EGLint width;
+	EGLint height;
+	EGLint stride;
+
+	NativeShmContainer nativeShmContainer;
+
+	struct _EGLShmImpl* next;
+
+} EGLShmImpl;
+
+// Color buffer of a surface locked with EGL_KHR_lock_surface3. The bitmap is kept for the next lock of the same size.
+typedef struct _EGLLockImpl
+{
+	EGLBoolean locked;
+
+	// Set by eglLockSurfaceKHR. The pixels are read, when the bitmap pointer is queried the first time.
+	EGLBoolean preservePixels;
+	EGLint usageHint;
+	EGLBoolean mapped;
+
+	EGLint width;
+	EGLint height;
+
+	// Shared image of a window or pixmap, rows top down. A pbuffer has a bitmap in client memory, rows bottom up.
+	EGLShmImpl* image;
+	void* bitmap;
+
+	void* pixels;
+	EGLint pitch;
+	EGLenum origin;
+
+} EGLLockImpl;
+
+// Number of frames, whose timestamps are kept for EGL_ANDROID_get_frame_timestamps.
+#define _EGL_FRAME_HISTORY 16
+
+typedef struct _EGLFrameImpl
+{
+	EGLuint64KHR id;
+
+	// Swap buffer count of the native swap. Zero, if the frame was not presented by a native swap.
+	EGLuint64KHR sbc;
+
+	// Pending, until the swap did complete. Invalid, if its completion was not observed.
+	EGLnsecsANDROID submitTime;
+	EGLnsecsANDROID presentTime;
+	EGLnsecsANDROID presentMsc;
+
+} EGLFrameImpl;
+
+// Upper limit of EGL_MAX_FRAMES_IN_FLIGHT_DESKTOP.
+#define _EGL_FRAMES_IN_FLIGHT_MAX 16
+
+// EGL_MAX_SWAP_INTERVAL of the configs, if the native swap interval can be set. The native limit is only known per drawable.
+#define _EGL_SWAP_INTERVAL_MAX 8
+
+// Texture and framebuffer, the back buffer of a window is copied into before a preserved swap and back after it.
+typedef struct _EGLPreserveImpl
+{
+	// The objects belong to the native context of ctx.
+	struct _EGLContextImpl* ctx;
+
+	unsigned int texture;
+	unsigned int framebuffer;
+
+	EGLint width;
+	EGLint height;
+
+} EGLPreserveImpl;
+
+// Pixmaps, an asynchronously presented window is rendered into. While one is copied into the window, the next frame is
+// rendered into the other one.
+#define _EGL_PRESENT_BUFFERS 2
+
+typedef struct _EGLPresentBufferImpl
+{
+
+	NativeSurfaceContainer nativeSurfaceContainer;
+
+	EGLint width;
+	EGLint height;
+
+	// Fence after the rendered frame, inserted by the swap and waited for by the present thread.
+	void* fence;
+
+	// Set by the swap, until the present thread did copy the pixmap into the window.
+	EGLBoolean queued;
+
+	// Number of the frame, the pixmap contains. Zero, if the content is undefined.
+	EGLuint64KHR frame;
+
+} EGLPresentBufferImpl;
+
+// Present thread of a window. Only mutex protects the queue, the present thread does not lock the display.
+typedef struct _EGLPresentImpl
+{
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable condition;
+
+	// The native context of the present thread shares the fences with the native context of ctx. Zero, if not running.
+	struct _EGLContextImpl* ctx;
+	NativeContextContainer nativeContextContainer;
+
+	EGLBoolean quit;
+
+	EGLPresentBufferImpl buffers[_EGL_PRESENT_BUFFERS];
+
+	// Pixmap, the current context renders into. Negative, while it renders into the window.
+	EGLint current;
+
+	EGLint queue[_EGL_PRESENT_BUFFERS];
+	EGLint queueHead;
+	EGLint numberQueued;
+
+	EGLuint64KHR numberFrames;
+
+	// Set, while a swap waits without the display lock. If the surface is destroyed meanwhile, the swap deletes the present.
+	EGLBoolean waiting;
+	EGLBoolean orphaned;
+
+} EGLPresentImpl;
+
 typedef struct _EGLSurfaceImpl
 {
 
@@ -269,14 +705,178 @@ typedef struct _EGLSurfaceImpl
 	union {
 		EGLNativeWindowType win;
 		NativePbufferType pbuf;
+		EGLNativePixmapType pixmap;
 	};
 
 	NativeSurfaceContainer nativeSurfaceContainer;
 
+	// Cached state returned by eglQuerySurface. The size of a window is updated from its structure events, if sizeTracked is set.
+	EGLint width;
+	EGLint height;
+	EGLBoolean sizeTracked;
+	EGLBoolean largestPbuffer;
+	EGLenum colorspace;
+	EGLenum swapBehavior;
+	EGLenum multisampleResolve;
+	EGLint mipmapLevel;
+
+	// Stream, if this surface is a stream producer.
+	struct _EGLStreamImpl* stream;
+
+	// Ring of asynchronous readbacks. The buffers and fences belong to the native context of readbackCtx and this surface.
+	EGLReadbackImpl* readbacks;
+	EGLint numberReadbacks;
+	EGLint nextReadback;
+	struct _EGLContextImpl* readbackCtx;
+
+	// One of the EGL_READBACK_FORMAT_*_DESKTOP values. The conversion pass is created with the ring.
+	EGLenum readbackFormat;
+	EGLConvertImpl* convert;
+
+	// Client memory, if this pbuffer was created from an EGL_CLIENT_MEMORY_DESKTOP buffer.
+	struct _EGLClientMemoryImpl* clientMemory;
+
+	// Shared image of a pbuffer, which eglCopyBuffers reads into before it is put into the target pixmap. The row is
+	// scratch memory to flip the image, if the pixels can not be read top down.
+	EGLShmImpl* copyImage;
+	unsigned char* copyRow;
+
+	// Render to texture. A pbuffer with a texture format is a GLX pixmap, which is bound with texture from pixmap.
+	EGLenum textureFormat;
+	EGLenum textureTarget;
+	EGLBoolean textureBound;
+
+	// Lock of the color buffer, if the surface was locked once.
+	EGLLockImpl* lock;
+
+	// EGL_KHR_partial_update. The age has to be queried before the damage region is set, both are reset by a swap.
+	EGLBoolean ageQueried;
+	EGLBoolean damageSet;
+	EGLint* damageRects;
+	EGLint numberDamageRects;
+
+	// Damaged rectangles of the last partial present, clipped to the window. Kept for the next swap.
+	EGLint* presentRects;
+	EGLint sizePresentRects;
+
+	// Set, if the back buffer still holds the presented frame after the last swap. Either only damaged rectangles were copied,
+	// or the color buffer was preserved.
+	EGLBoolean backBufferKept;
+
+	// Copy of the color buffer for EGL_BUFFER_PRESERVED, if the swap of this surface has to be emulated.
+	EGLPreserveImpl* preserve;
+
+	// EGL_KHR_mutable_render_buffer. The render buffer set by eglSurfaceAttrib is applied by the next swap.
+	// While frontBuffer is set, a double buffered window is rendered into its front buffer.
+	EGLenum renderBuffer;
+	EGLBoolean frontBuffer;
+
+	// EGL_ANDROID_get_frame_timestamps. Ring of the last frames, the next swap records nextFrameId.
+	EGLBoolean timestamps;
+	EGLFrameImpl* frames;
+	EGLuint64KHR nextFrameId;
+
+	// EGL_DESKTOP_frame_throttle. Queue of the fences of the frames in flight, which belong to the context of flightCtx.
+	EGLint maxFramesInFlight;
+	EGLBoolean throttleBlocking;
+	void* flightFences[_EGL_FRAMES_IN_FLIGHT_MAX];
+	EGLint firstFlightFence;
+	EGLint numberFlightFences;
+	struct _EGLContextImpl* flightCtx;
+	EGLint framesInFlight;
+	EGLint peakFramesInFlight;
+
+	// Set by eglSwapInterval, clamped to the interval range of the config. Applied, when the surface is current.
+	EGLint swapInterval;
+	// Interval, which was last set for the drawable. The native interval belongs to the drawable, not to the context.
+	EGLint nativeSwapInterval;
+
+	// EGL_DESKTOP_async_present. Created by the first swap after the attribute was set, released by the first one after
+	// it was cleared.
+	EGLBoolean asyncPresent;
+	EGLPresentImpl* present;
+
+	// Locked by calls, which only use this surface and hold the display lock shared. Calls, which hold the display lock
+	// exclusively, do not lock it. The surface mutex of the display, if the display has no thread support.
+	std::mutex* mutex;
+
 	struct _EGLSurfaceImpl* next;
 
 } EGLSurfaceImpl;
 
+// Texture units, texture targets, buffer targets and indexed uniform buffer bindings, whose bindings a virtual context keeps.
+#define _EGL_VIRTUAL_TEXTURE_UNITS 16
+#define _EGL_VIRTUAL_TEXTURE_TARGETS 4
+#define _EGL_VIRTUAL_BUFFER_TARGETS 6
+#define _EGL_VIRTUAL_UNIFORM_BUFFERS 16
+
+// Binding of a native context, which is not known anymore. It differs from any name, so the binding is made again.
+#define _EGL_VIRTUAL_UNKNOWN_NAME ((GLuint)~0u)
+
+// GL state of a virtual context, which is saved and restored, when another virtual context uses the native context.
+typedef struct _EGLVirtualStateImpl
+{
+
+	// Set, after the viewport and the scissor box were set to the size of the first surface.
+	EGLBoolean sized;
+
+	GLuint program;
+	GLuint vertexArray;
+	GLuint drawFramebuffer;
+	GLuint readFramebuffer;
+	GLuint renderbuffer;
+	GLuint buffers[_EGL_VIRTUAL_BUFFER_TARGETS];
+
+	// Bound by glBindBufferBase, if the size is zero, otherwise by glBindBufferRange.
+	GLuint uniformBuffers[_EGL_VIRTUAL_UNIFORM_BUFFERS];
+	GLintptr uniformBufferOffsets[_EGL_VIRTUAL_UNIFORM_BUFFERS];
+	GLsizeiptr uniformBufferSizes[_EGL_VIRTUAL_UNIFORM_BUFFERS];
+
+	GLenum activeTexture;
+	GLuint textures[_EGL_VIRTUAL_TEXTURE_UNITS][_EGL_VIRTUAL_TEXTURE_TARGETS];
+
+	GLint viewport[4];
+	GLint scissor[4];
+
+	// One bit for each of the tracked capabilities, which is enabled.
+	GLuint capabilities;
+
+	GLfloat clearColor[4];
+	double clearDepth;
+	GLint clearStencil;
+
+	GLenum blendSrcRGB;
+	GLenum blendDstRGB;
+	GLenum blendSrcAlpha;
+	GLenum blendDstAlpha;
+	GLenum blendEquationRGB;
+	GLenum blendEquationAlpha;
+	GLfloat blendColor[4];
+
+	// Front and back face.
+	GLenum stencilFunc[2];
+	GLint stencilRef[2];
+	GLuint stencilValueMask[2];
+	GLenum stencilFail[2];
+	GLenum stencilDepthFail[2];
+	GLenum stencilDepthPass[2];
+	GLuint stencilWriteMask[2];
+
+	GLfloat polygonOffsetFactor;
+	GLfloat polygonOffsetUnits;
+
+	GLenum depthFunc;
+	GLboolean depthMask;
+	double depthRange[2];
+	GLboolean colorMask[4];
+	GLenum cullFace;
+	GLenum frontFace;
+
+	GLint packAlignment;
+	GLint unpackAlignment;
+
+} EGLVirtualStateImpl;
+
 typedef struct _EGLContextListImpl
 {
 
@@ -284,10 +884,45 @@ typedef struct _EGLContextListImpl
 
 	NativeContextContainer nativeContextContainer;
 
+	// Set, if the default framebuffer of the native context draws into the front buffer of the surface.
+	EGLBoolean frontBuffer;
+
+	// Only for the native contexts of a virtual context host. The state, which is applied in the native context, and the
+	// virtual context it belongs to. Zero, if the virtual context was switched away or destroyed.
+	EGLVirtualStateImpl* virtualState;
+	struct _EGLContextImpl* virtualTenant;
+
+	// Local storage of the thread, which made the native context current last. Zero, if it was released.
+	const void* currentThread;
+
 	struct _EGLContextListImpl* next;
 
 } EGLContextListImpl;
 
+// Owns the native contexts, which all virtual contexts of a config and the same attributes use.
+typedef struct _EGLVirtualHostImpl
+{
+
+	EGLint configId;
+
+	EGLint attribList[CONTEXT_ATTRIB_LIST_SIZE];
+
+	// Virtual contexts, which use the host. It is deleted with the last one.
+	EGLint tenants;
+
+	// One native context per surface. All are shared with the first one.
+	EGLContextListImpl* rootCtxList;
+
+	// Display of the tenants. Deleting an object locks it shared, so no tenant is made current meanwhile.
+	struct _EGLDisplayImpl* display;
+
+	// Serializes the threads, which clear a deleted object from the bindings of the tenants.
+	std::mutex mutex;
+
+	struct _EGLVirtualHostImpl* next;
+
+} EGLVirtualHostImpl;
+
 typedef struct _EGLContextImpl
 {
 
@@ -302,13 +937,198 @@ typedef struct _EGLContextImpl
 
 	EGLint attribList[CONTEXT_ATTRIB_LIST_SIZE];
 
+	// Time of eglCreateContext and of the first swap, while the context was current. Zero, until the first swap.
+	EGLTimeKHR createTime;
+	EGLTimeKHR firstFrameTime;
+
+	// Set, if the first native context was taken from the context pool.
+	EGLBoolean pooled;
+
+	// GL_MESA_pack_invert of the native contexts. -1, until it is queried.
+	EGLint packInvert;
+
+	// EGL_DESKTOP_virtual_context. rootCtxList is the list of the host then, which owns it. The saved state is only valid,
+	// while virtualCtxList is zero. Otherwise, the state is live in the native context of virtualCtxList.
+	EGLVirtualHostImpl* virtualHost;
+	EGLVirtualStateImpl* virtualState;
+	EGLContextListImpl* virtualCtxList;
+
 	struct _EGLContextImpl* next;
 
 } EGLContextImpl;
 
-typedef struct _EGLDisplayImpl
+// Native context, which is created in advance for a config, the attributes of a context and a share group.
+typedef struct _EGLPooledContextImpl
+{
+
+	const EGLConfigImpl* config;
+	EGLint surfaceType;
+
+	EGLint attribList[CONTEXT_ATTRIB_LIST_SIZE];
+
+	// Native context of the share group, the native context is created in. Zero, if not shared.
+	EGLContextListImpl* sharedCtxList;
+
+	NativeContextContainer nativeContextContainer;
+
+	struct _EGLPooledContextImpl* next;
+
+} EGLPooledContextImpl;
+
+// Creates the native contexts of the pool on a thread. Only mutex protects the pool, the thread does not lock the display.
+typedef struct _EGLContextPoolImpl
 {
+
+	std::thread thread;
 	std::mutex mutex;
+	std::condition_variable condition;
+
+	EGLBoolean quit;
+
+	// Requested native contexts, which are not created yet.
+	EGLPooledContextImpl* rootRequest;
+
+	// Request, which is created at the moment. Its share group can not be deleted meanwhile.
+	EGLPooledContextImpl* creating;
+
+	// Created native contexts, which eglMakeCurrent takes instead of creating one.
+	EGLPooledContextImpl* rootPooledCtx;
+
+} EGLContextPoolImpl;
+
+#define _EGL_STREAM_FRAME_FREE 0
+#define _EGL_STREAM_FRAME_PRODUCING 1
+#define _EGL_STREAM_FRAME_QUEUED 2
+#define _EGL_STREAM_FRAME_ACQUIRED 3
+
+typedef struct _EGLStreamFrameImpl
+{
+	// One of the _EGL_STREAM_FRAME_* values. Ownership of a frame is handed over between producer and consumer only by changing this value.
+	std::atomic<EGLint> state;
+
+	EGLuint64KHR frameNumber;
+
+	// Time in nanoseconds, when the producer inserted the frame.
+	EGLTimeKHR timestamp;
+
+	NativeSurfaceContainer nativeSurfaceContainer;
+
+} EGLStreamFrameImpl;
+
+// Cross process streams. The producer process creates the shared memory, which contains this header and the frames.
+
+#define _EGL_STREAM_SHARED_MAX_FRAMES 16
+#define _EGL_STREAM_SHARED_HEADER_SIZE 4096
+
+#define _EGL_STREAM_WAIT_DISCONNECTED -1
+#define _EGL_STREAM_WAIT_TIMEOUT 0
+#define _EGL_STREAM_WAIT_SIGNALED 1
+
+typedef struct _EGLStreamSharedImpl
+{
+	EGLint width;
+	EGLint height;
+
+	EGLint numberFrames;
+
+	std::atomic<EGLint> frameState[_EGL_STREAM_SHARED_MAX_FRAMES];
+	EGLuint64KHR frameNumber[_EGL_STREAM_SHARED_MAX_FRAMES];
+	EGLTimeKHR timestamp[_EGL_STREAM_SHARED_MAX_FRAMES];
+
+	EGLint queue[_EGL_STREAM_SHARED_MAX_FRAMES];
+	std::atomic<EGLint> queueHead;
+	std::atomic<EGLint> queueTail;
+
+	std::atomic<EGLint> mailbox;
+
+	std::atomic<EGLuint64KHR> producerFrameNumber;
+	std::atomic<EGLuint64KHR> consumerFrameNumber;
+
+	std::atomic<EGLTimeKHR> producerTime;
+	std::atomic<EGLTimeKHR> consumerTime;
+
+} EGLStreamSharedImpl;
+
+// Sent once over the control channel by the process, which created the stream.
+typedef struct _EGLStreamMessageImpl
+{
+	EGLint fifoLength;
+	EGLint consumerLatency;
+	EGLint consumerAcquireTimeout;
+
+} EGLStreamMessageImpl;
+
+typedef struct _EGLStreamImpl
+{
+
+	EGLBoolean initialized;
+	EGLBoolean destroy;
+
+	std::atomic<EGLenum> state;
+
+	EGLint fifoLength;
+	EGLint consumerLatency;
+	EGLint consumerAcquireTimeout;
+
+	EGLint width;
+	EGLint height;
+
+	EGLSurfaceImpl* producer;
+
+	struct _EGLContextImpl* consumerCtx;
+	unsigned int consumerTexture;
+
+	EGLint numberFrames;
+	EGLStreamFrameImpl* frames;
+
+	// Frame currently rendered by the producer, frame currently latched by the consumer.
+	EGLint producerFrame;
+	EGLint consumerFrame;
+
+	// Single producer, single consumer ring of queued frame indices. Used in FIFO mode. Head and tail wrap at twice the
+	// number of frames, so a full ring differs from an empty one.
+	EGLint* queue;
+	std::atomic<EGLint> queueHead;
+	std::atomic<EGLint> queueTail;
+
+	// Last inserted frame index or -1. Used in mailbox mode.
+	std::atomic<EGLint> mailbox;
+
+	std::atomic<EGLuint64KHR> producerFrameNumber;
+	std::atomic<EGLuint64KHR> consumerFrameNumber;
+
+	std::atomic<EGLTimeKHR> producerTime;
+	std::atomic<EGLTimeKHR> consumerTime;
+
+	// Waited on by the producer for a free frame and by the consumer for a queued frame, while no lock is held. The stream
+	// and its producer surface are not deleted, while there are waiters.
+	std::mutex waitMutex;
+	std::condition_variable waitCondition;
+	std::atomic<EGLint> waiters;
+
+	// Cross process stream. Either the producer or the consumer is in another process.
+	EGLBoolean crossProcess;
+	EGLBoolean fileDescriptorTaken;
+	NativeStreamContainer nativeStreamContainer;
+	EGLStreamSharedImpl* shared;
+
+	// Copied from the shared memory, when it was validated. Any index read from the shared memory is checked against it.
+	EGLint numberSharedFrames;
+
+	struct _EGLStreamImpl* next;
+
+} EGLStreamImpl;
+
+typedef struct _EGLDisplayImpl
+{
+	// Locked exclusively, if objects are created, destroyed or made current. Swaps and queries of one surface lock it shared.
+	std::shared_mutex mutex;
+
+	// Serializes the window size events, which update the size of any window of the display.
+	std::mutex eventMutex;
+
+	// Locked instead of the mutex of a surface, if the native calls of the display can not be made from several threads.
+	std::mutex surfaceMutex;
 
 	EGLBoolean initialized;
 	EGLBoolean destroy;
@@ -318,6 +1138,31 @@ typedef struct _EGLDisplayImpl
 	EGLSurfaceImpl* rootSurface;
 	EGLContextImpl* rootCtx;
 	EGLConfigImpl* rootConfig;
+	EGLStreamImpl* rootStream;
+	EGLShmImpl* rootShm;
+
+	EGLint nativeCaps;
+
+	NativeDisplayContainer nativeDisplayContainer;
+
+	// The configs of rootConfig are moved into this table by eglInitialize and do not change afterwards. It is published,
+	// while the display is initialized, so the config queries do not lock the display.
+	EGLConfigSlotImpl* configTable;
+	EGLint numberConfigs;
+	std::atomic<EGLBoolean> configsPublished;
+
+	// Indices into the config table of the configs, which support a window, pixmap or pbuffer surface. Built with the table,
+	// so eglChooseConfig only scans the configs of the rarest requested surface type. The first array owns the memory.
+	EGLint* surfaceTypeIndex[_EGL_SURFACE_TYPE_INDEX_COUNT];
+	EGLint surfaceTypeCount[_EGL_SURFACE_TYPE_INDEX_COUNT];
+
+	// Started by the first eglPrewarmContextsDESKTOP. Zero before.
+	EGLContextPoolImpl* contextPool;
+
+	// Hosts of the virtual contexts.
+	EGLVirtualHostImpl* rootVirtualHost;
+
+	char extensions[_EGL_EXTENSIONS_SIZE];
 
 	EGLSurfaceImpl* currentDraw;
 	EGLSurfaceImpl* currentRead;
@@ -334,6 +1179,9 @@ typedef struct _LocalStorage
 	EGLenum api;
 
 	EGLContextImpl* currentCtx;
+
+	// State of the current context, if it is a virtual one. Updated by the wrapped GL entry points.
+	EGLVirtualStateImpl* virtualState;
 } LocalStorage;
 
 //
@@ -341,6 +1189,8 @@ typedef struct _LocalStorage
 extern "C" {
 #endif
 void _eglInternalSetDefaultConfig(EGLConfigImpl* config);
+EGLBoolean _eglInternalEquivalentConfig(const EGLConfigImpl* config, const EGLConfigImpl* other);
+EGLBoolean _eglInternalHasExtension(const char* extensions, const char* extension);
 #if __cplusplus
 }
 #endif
@@ -359,6 +1209,8 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 
 EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLint* attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error);
 
+EGLBoolean __createPixmapSurface(EGLSurfaceImpl* newSurface, EGLNativePixmapType pixmap, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error);
+
 EGLBoolean __destroySurface(EGLNativeDisplayType dpy, const EGLSurfaceImpl* surface);
 
 __eglMustCastToProperFunctionPointerType __getProcAddress(const char *procname);
@@ -367,11 +1219,71 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 
 EGLBoolean __createContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList);
 
+EGLBoolean __createPooledContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint surfaceType, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList);
+
+EGLBoolean __pooledContextMatches(const NativeContextContainer* nativeContextContainer, const NativeSurfaceContainer* nativeSurfaceContainer);
+
 EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* nativeContextContainer);
 
+EGLBoolean __makeCurrentRead(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* drawSurfaceContainer, const NativeSurfaceContainer* readSurfaceContainer, const NativeContextContainer* nativeContextContainer);
+
 EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface);
 
-EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, EGLint interval);
+EGLBoolean __swapBuffersRegion(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects);
+
+EGLBoolean __swapBuffersCounted(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLuint64KHR* sbc);
+
+EGLBoolean __querySwapCompletion(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLnsecsANDROID* ust, EGLuint64KHR* msc, EGLuint64KHR* sbc);
+
+EGLBoolean __queryRefreshInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLnsecsANDROID* interval);
+
+EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint interval);
+
+EGLBoolean __querySurfaceSize(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint* width, EGLint* height);
+
+EGLBoolean __querySurfaceAge(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint* age);
+
+EGLBoolean __watchWindowSize(EGLDisplayImpl* walkerDpy, EGLNativeWindowType win);
+
+EGLBoolean __pollWindowSize(EGLDisplayImpl* walkerDpy, EGLNativeWindowType* win, EGLint* width, EGLint* height);
+
+EGLBoolean __closeWindowSizeEvents(EGLDisplayImpl* walkerDpy);
+
+EGLBoolean __createTexturePixmap(NativeSurfaceContainer* nativeSurfaceContainer, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLenum textureFormat, EGLint width, EGLint height, EGLint* error);
+
+EGLBoolean __destroyTexturePixmap(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer);
+
+EGLBoolean __bindTexImage(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer);
+
+EGLBoolean __releaseTexImage(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer);
+
+EGLBoolean __createStreamConnection(NativeStreamContainer* nativeStreamContainer, EGLNativeFileDescriptorKHR* fileDescriptor, EGLint* error);
+
+EGLBoolean __openStreamConnection(NativeStreamContainer* nativeStreamContainer, EGLNativeFileDescriptorKHR fileDescriptor, EGLint* error);
+
+EGLBoolean __destroyStreamConnection(NativeStreamContainer* nativeStreamContainer);
+
+EGLBoolean __createStreamMemory(NativeStreamContainer* nativeStreamContainer, size_t size, void** memory, EGLint* error);
+
+EGLBoolean __sendStreamMessage(const NativeStreamContainer* nativeStreamContainer, const EGLStreamMessageImpl* message, EGLBoolean attachMemory, EGLint* error);
+
+EGLint __receiveStreamMessage(NativeStreamContainer* nativeStreamContainer, EGLStreamMessageImpl* message, void** memory, size_t* size, EGLTimeKHR timeout);
+
+EGLBoolean __signalStream(const NativeStreamContainer* nativeStreamContainer, EGLBoolean frameReady);
+
+EGLint __waitStream(const NativeStreamContainer* nativeStreamContainer, EGLBoolean frameReady, EGLTimeKHR timeout);
+
+EGLBoolean __createShmPixmap(EGLShmImpl* newShm, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error);
+
+EGLBoolean __createShmImage(EGLShmImpl* newShm, const EGLDisplayImpl* walkerDpy, EGLint* error);
+
+EGLBoolean __destroyShm(const EGLDisplayImpl* walkerDpy, EGLShmImpl* shm);
+
+EGLBoolean __copyBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLNativePixmapType target, EGLint* error);
+
+EGLBoolean __readShmImage(const EGLDisplayImpl* walkerDpy, EGLShmImpl* shm, EGLint* error);
+
+EGLBoolean __writeShmImage(const EGLDisplayImpl* walkerDpy, const EGLShmImpl* shm, EGLint* error);
 
 EGLBoolean __getPlatformDependentHandles(void* out, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* nativeContextContainer);
 
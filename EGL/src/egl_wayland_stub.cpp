@@ -21,6 +21,16 @@ EGLBoolean __deleteContext(const EGLDisplayImpl* walkerDpy, const NativeContextC
     return EGL_FALSE;
 }
 
+EGLBoolean __createPooledContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint surfaceType, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __pooledContextMatches(const NativeContextContainer* nativeContextContainer, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+    return EGL_FALSE;
+}
+
 EGLBoolean __processAttribList(EGLenum api, EGLint* target_attrib_list, const EGLint* attrib_list, EGLint* error)
 {
     return EGL_FALSE;
@@ -36,6 +46,11 @@ EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLint* attr
     return EGL_FALSE;
 }
 
+EGLBoolean __createPixmapSurface(EGLSurfaceImpl* newSurface, EGLNativePixmapType pixmap, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
 EGLBoolean __destroySurface(EGLNativeDisplayType dpy, const EGLSurfaceImpl* surface)
 {
     return EGL_FALSE;
@@ -61,12 +76,152 @@ EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceCon
     return EGL_FALSE;
 }
 
+EGLBoolean __makeCurrentRead(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* drawSurfaceContainer, const NativeSurfaceContainer* readSurfaceContainer, const NativeContextContainer* nativeContextContainer)
+{
+    return EGL_FALSE;
+}
+
 EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
 {
     return EGL_FALSE;
 }
 
-EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, EGLint interval)
+EGLBoolean __swapBuffersRegion(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __swapBuffersCounted(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLuint64KHR* sbc)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __querySwapCompletion(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLnsecsANDROID* ust, EGLuint64KHR* msc, EGLuint64KHR* sbc)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __queryRefreshInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLnsecsANDROID* interval)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint interval)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __querySurfaceSize(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint* width, EGLint* height)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __querySurfaceAge(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint* age)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __watchWindowSize(EGLDisplayImpl* walkerDpy, EGLNativeWindowType win)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __pollWindowSize(EGLDisplayImpl* walkerDpy, EGLNativeWindowType* win, EGLint* width, EGLint* height)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __closeWindowSizeEvents(EGLDisplayImpl* walkerDpy)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __createTexturePixmap(NativeSurfaceContainer* nativeSurfaceContainer, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLenum textureFormat, EGLint width, EGLint height, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __destroyTexturePixmap(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __bindTexImage(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __releaseTexImage(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __createStreamConnection(NativeStreamContainer* nativeStreamContainer, EGLNativeFileDescriptorKHR* fileDescriptor, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __openStreamConnection(NativeStreamContainer* nativeStreamContainer, EGLNativeFileDescriptorKHR fileDescriptor, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __destroyStreamConnection(NativeStreamContainer* nativeStreamContainer)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __createStreamMemory(NativeStreamContainer* nativeStreamContainer, size_t size, void** memory, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __sendStreamMessage(const NativeStreamContainer* nativeStreamContainer, const EGLStreamMessageImpl* message, EGLBoolean attachMemory, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLint __receiveStreamMessage(NativeStreamContainer* nativeStreamContainer, EGLStreamMessageImpl* message, void** memory, size_t* size, EGLTimeKHR timeout)
+{
+    return _EGL_STREAM_WAIT_DISCONNECTED;
+}
+
+EGLBoolean __signalStream(const NativeStreamContainer* nativeStreamContainer, EGLBoolean frameReady)
+{
+    return EGL_FALSE;
+}
+
+EGLint __waitStream(const NativeStreamContainer* nativeStreamContainer, EGLBoolean frameReady, EGLTimeKHR timeout)
+{
+    return _EGL_STREAM_WAIT_DISCONNECTED;
+}
+
+EGLBoolean __createShmPixmap(EGLShmImpl* newShm, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __createShmImage(EGLShmImpl* newShm, const EGLDisplayImpl* walkerDpy, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __destroyShm(const EGLDisplayImpl* walkerDpy, EGLShmImpl* shm)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __copyBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLNativePixmapType target, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __readShmImage(const EGLDisplayImpl* walkerDpy, EGLShmImpl* shm, EGLint* error)
+{
+    return EGL_FALSE;
+}
+
+EGLBoolean __writeShmImage(const EGLDisplayImpl* walkerDpy, const EGLShmImpl* shm, EGLint* error)
 {
     return EGL_FALSE;
 }
@@ -55,6 +55,7 @@ PFNWGLCREATEPBUFFERARBPROC wglCreatePbufferARB = NULL;
 PFNWGLGETPBUFFERDCARBPROC wglGetPbufferDCARB = NULL;
 PFNWGLRELEASEPBUFFERDCARBPROC wglReleasePbufferDCARB = NULL;
 PFNWGLDESTROYPBUFFERARBPROC wglDestroyPbufferARB = NULL;
+PFNWGLQUERYPBUFFERARBPROC wglQueryPbufferARB = NULL;
 #endif
 
 
@@ -214,6 +215,7 @@ EGLBoolean __internalInit(NativeLocalStorageContainer* nativeLocalStorageContain
 	wglGetPbufferDCARB = (PFNWGLGETPBUFFERDCARBPROC)__getProcAddress("wglGetPbufferDCARB");
 	wglReleasePbufferDCARB = (PFNWGLRELEASEPBUFFERDCARBPROC)__getProcAddress("wglReleasePbufferDCARB");
 	wglDestroyPbufferARB = (PFNWGLDESTROYPBUFFERARBPROC)__getProcAddress("wglDestroyPbufferARB");
+	wglQueryPbufferARB = (PFNWGLQUERYPBUFFERARBPROC)__getProcAddress("wglQueryPbufferARB");
 
 	wglMakeCurrent_PTR(NULL, NULL);
 #endif
@@ -327,6 +329,17 @@ EGLBoolean __deleteContext(const EGLDisplayImpl* walkerDpy, const NativeContextC
 	return wglDeleteContext_PTR(nativeContextContainer->ctx);
 }
 
+// Pixel formats are chosen, when a surface is created, so contexts can not be created in advance.
+EGLBoolean __createPooledContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint surfaceType, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __pooledContextMatches(const NativeContextContainer* nativeContextContainer, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+	return EGL_FALSE;
+}
+
 EGLBoolean __processAttribList(EGLenum api, EGLint* target_attrib_list, const EGLint* attrib_list, EGLint* error)
 {
 	if (!target_attrib_list || !attrib_list || !error)
@@ -798,6 +811,11 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 	return EGL_TRUE;
 }
 
+EGLBoolean __createPixmapSurface(EGLSurfaceImpl* newSurface, EGLNativePixmapType pixmap, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
 EGLBoolean __destroySurface(EGLNativeDisplayType dpy, const EGLSurfaceImpl* surface)
 {
 	if (!surface)
@@ -848,10 +866,23 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 
 	const char* extensions_str = wglGetExtensionsStringARB(nativeLocalStorageContainer->hdc);
 
-	const int render_texture_supported = strstr(extensions_str, "WGL_ARB_render_texture") != NULL;
-	const int ES_supported = strstr(extensions_str, "WGL_EXT_create_context_es_profile") != NULL;
+	const int render_texture_supported = _eglInternalHasExtension(extensions_str, "WGL_ARB_render_texture");
+	const int ES_supported = _eglInternalHasExtension(extensions_str, "WGL_EXT_create_context_es_profile");
 	const EGLint ES_mask = ES_supported * (EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT);
 
+	// WGL can be called from several threads at once.
+	walkerDpy->nativeCaps |= _EGL_NATIVE_THREADS;
+
+	if (_eglInternalHasExtension(extensions_str, "WGL_EXT_swap_control") && wglSwapIntervalEXT)
+	{
+		walkerDpy->nativeCaps |= _EGL_NATIVE_SWAP_CONTROL;
+
+		if (_eglInternalHasExtension(extensions_str, "WGL_EXT_swap_control_tear"))
+		{
+			walkerDpy->nativeCaps |= _EGL_NATIVE_SWAP_CONTROL_TEAR;
+		}
+	}
+
 	EGLConfigImpl* lastConfig = 0;
 	for (EGLint currentPixelFormat = 1; currentPixelFormat <= numberPixelFormats; currentPixelFormat++)
 	{
@@ -952,82 +983,47 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 		{
 			newConfig->surfaceType |= EGL_PBUFFER_BIT;
 		}
-		newConfig->colorBufferType = EGL_RGB_BUFFER;
-		newConfig->configId = currentPixelFormat;
-
-		attribute = WGL_COLOR_BITS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->bufferSize))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
-		attribute = WGL_RED_BITS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->redSize))
+		// A double buffered window can be switched to render into its front buffer.
+		if (newConfig->drawToWindow && newConfig->doubleBuffer)
 		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
-		attribute = WGL_GREEN_BITS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->greenSize))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			newConfig->surfaceType |= EGL_MUTABLE_RENDER_BUFFER_BIT_KHR;
 		}
+		newConfig->colorBufferType = EGL_RGB_BUFFER;
+		newConfig->configId = currentPixelFormat;
 
-		attribute = WGL_BLUE_BITS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->blueSize))
+		// The attributes, which correspond to a pixel format attribute.
+		for (const EGLConfigAttribSchemaImpl& schema : g_configSchema)
 		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
+			if (!(schema.flags & _EGL_ATTRIB_NATIVE_READ) || !schema.nativeAttribute)
+			{
+				continue;
+			}
 
-		attribute = WGL_ALPHA_BITS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->alphaSize))
-		{
-			*error = EGL_NOT_INITIALIZED;
+			attribute = schema.nativeAttribute;
+			if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &_EGL_CONFIG_VALUE(newConfig, schema)))
+			{
+				*error = EGL_NOT_INITIALIZED;
 
-			return EGL_FALSE;
+				return EGL_FALSE;
+			}
 		}
 
-		attribute = WGL_DEPTH_BITS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->depthSize))
+		// Preserved swaps are emulated by copying the back buffer, which can not be blitted back into a multisample buffer.
+		if (!newConfig->sampleBuffers)
 		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			newConfig->surfaceType |= EGL_SWAP_BEHAVIOR_PRESERVED_BIT;
 		}
 
-		attribute = WGL_STENCIL_BITS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->stencilSize))
+		// Without swap control, every swap waits for the vertical blank. Negative intervals tear late frames.
+		if (walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL)
 		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			newConfig->maxSwapInterval = _EGL_SWAP_INTERVAL_MAX;
+			newConfig->minSwapInterval = (walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL_TEAR) ? -_EGL_SWAP_INTERVAL_MAX : 0;
 		}
-
-
-		//
-
-		attribute = WGL_SAMPLE_BUFFERS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->sampleBuffers))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
-		attribute = WGL_SAMPLES_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->samples))
+		else
 		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			newConfig->maxSwapInterval = 1;
+			newConfig->minSwapInterval = 1;
 		}
 
 		//
@@ -1054,64 +1050,10 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 
 		//
 
-		attribute = WGL_MAX_PBUFFER_PIXELS_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->maxPBufferPixels))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
-		attribute = WGL_MAX_PBUFFER_WIDTH_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->maxPBufferWidth))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
-		attribute = WGL_MAX_PBUFFER_HEIGHT_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->maxPBufferHeight))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
-		//
-
-		attribute = WGL_TRANSPARENT_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->transparentType))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
 		newConfig->transparentType = newConfig->transparentType ? EGL_TRANSPARENT_RGB : EGL_NONE;
 
-		attribute = WGL_TRANSPARENT_RED_VALUE_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->transparentRedValue))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
-		attribute = WGL_TRANSPARENT_GREEN_VALUE_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->transparentGreenValue))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
-
-		attribute = WGL_TRANSPARENT_BLUE_VALUE_ARB;
-		if (!wglGetPixelFormatAttribivARB(nativeLocalStorageContainer->hdc, currentPixelFormat, 0, 1, &attribute, &newConfig->transparentBlueValue))
-		{
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
+		// WGL has no caveat, but a pixel format without acceleration is rendered in software.
+		newConfig->configCaveat = newConfig->configCaveat == WGL_NO_ACCELERATION_ARB ? EGL_SLOW_CONFIG : EGL_NONE;
 
 		newConfig->matchNativePixmap = EGL_NONE;
 		newConfig->nativeRenderable = EGL_DONT_CARE; // ???
@@ -1149,6 +1091,11 @@ EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceCon
 	return res;
 }
 
+EGLBoolean __makeCurrentRead(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* drawSurfaceContainer, const NativeSurfaceContainer* readSurfaceContainer, const NativeContextContainer* nativeContextContainer)
+{
+	return EGL_FALSE;
+}
+
 EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
 {
 	if (!walkerDpy || !walkerSurface)
@@ -1159,16 +1106,198 @@ EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl*
 	return (EGLBoolean)SwapBuffers(walkerSurface->nativeSurfaceContainer.hdc);
 }
 
-EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, EGLint interval)
+EGLBoolean __swapBuffersRegion(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects)
 {
-	if (!walkerDpy)
+	return EGL_FALSE;
+}
+
+EGLBoolean __swapBuffersCounted(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLuint64KHR* sbc)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __querySwapCompletion(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLnsecsANDROID* ust, EGLuint64KHR* msc, EGLuint64KHR* sbc)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __queryRefreshInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLnsecsANDROID* interval)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint interval)
+{
+	if (!walkerDpy || !walkerSurface || !(walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL))
 	{
 		return EGL_FALSE;
 	}
 
+	// A negative interval swaps a late frame immediately, which requires WGL_EXT_swap_control_tear.
+	if (interval < 0 && !(walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL_TEAR))
+	{
+		interval = -interval;
+	}
+
 	return (EGLBoolean)wglSwapIntervalEXT(interval);
 }
 
+EGLBoolean __querySurfaceSize(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint* width, EGLint* height)
+{
+	if (!walkerDpy || !walkerSurface || !width || !height)
+	{
+		return EGL_FALSE;
+	}
+
+	if (walkerSurface->drawToPBuffer)
+	{
+		int value;
+
+		if (!wglQueryPbufferARB(walkerSurface->pbuf, WGL_PBUFFER_WIDTH_ARB, &value))
+		{
+			return EGL_FALSE;
+		}
+		*width = (EGLint)value;
+
+		if (!wglQueryPbufferARB(walkerSurface->pbuf, WGL_PBUFFER_HEIGHT_ARB, &value))
+		{
+			return EGL_FALSE;
+		}
+		*height = (EGLint)value;
+
+		return EGL_TRUE;
+	}
+
+	RECT rect;
+
+	if (!GetClientRect(walkerSurface->win, &rect))
+	{
+		return EGL_FALSE;
+	}
+
+	*width = (EGLint)(rect.right - rect.left);
+	*height = (EGLint)(rect.bottom - rect.top);
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __querySurfaceAge(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint* age)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __watchWindowSize(EGLDisplayImpl* walkerDpy, EGLNativeWindowType win)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __pollWindowSize(EGLDisplayImpl* walkerDpy, EGLNativeWindowType* win, EGLint* width, EGLint* height)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __closeWindowSizeEvents(EGLDisplayImpl* walkerDpy)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __createTexturePixmap(NativeSurfaceContainer* nativeSurfaceContainer, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLenum textureFormat, EGLint width, EGLint height, EGLint* error)
+{
+	// WGL has no texture from pixmap.
+
+	if (error)
+	{
+		*error = EGL_BAD_MATCH;
+	}
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __destroyTexturePixmap(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __bindTexImage(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __releaseTexImage(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __createStreamConnection(NativeStreamContainer* nativeStreamContainer, EGLNativeFileDescriptorKHR* fileDescriptor, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __openStreamConnection(NativeStreamContainer* nativeStreamContainer, EGLNativeFileDescriptorKHR fileDescriptor, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __destroyStreamConnection(NativeStreamContainer* nativeStreamContainer)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __createStreamMemory(NativeStreamContainer* nativeStreamContainer, size_t size, void** memory, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __sendStreamMessage(const NativeStreamContainer* nativeStreamContainer, const EGLStreamMessageImpl* message, EGLBoolean attachMemory, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
+EGLint __receiveStreamMessage(NativeStreamContainer* nativeStreamContainer, EGLStreamMessageImpl* message, void** memory, size_t* size, EGLTimeKHR timeout)
+{
+	return _EGL_STREAM_WAIT_DISCONNECTED;
+}
+
+EGLBoolean __signalStream(const NativeStreamContainer* nativeStreamContainer, EGLBoolean frameReady)
+{
+	return EGL_FALSE;
+}
+
+EGLint __waitStream(const NativeStreamContainer* nativeStreamContainer, EGLBoolean frameReady, EGLTimeKHR timeout)
+{
+	return _EGL_STREAM_WAIT_DISCONNECTED;
+}
+
+EGLBoolean __createShmPixmap(EGLShmImpl* newShm, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __createShmImage(EGLShmImpl* newShm, const EGLDisplayImpl* walkerDpy, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __destroyShm(const EGLDisplayImpl* walkerDpy, EGLShmImpl* shm)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __copyBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLNativePixmapType target, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __readShmImage(const EGLDisplayImpl* walkerDpy, EGLShmImpl* shm, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
+EGLBoolean __writeShmImage(const EGLDisplayImpl* walkerDpy, const EGLShmImpl* shm, EGLint* error)
+{
+	return EGL_FALSE;
+}
+
 EGLBoolean __getPlatformDependentHandles(void* _out, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* nativeContextContainer)
 {
 	if (!nativeSurfaceContainer || !nativeContextContainer)
@@ -29,6 +29,19 @@
 #include <iostream>
 #include <thread>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/ipc.h>
+#include <sys/mman.h>
+#include <sys/shm.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#if !defined(GLX_BACK_BUFFER_AGE_EXT)
+#define GLX_BACK_BUFFER_AGE_EXT 0x20F4
+#endif
 
 #if defined(EGL_NO_GLEW)
 typedef GLXContext (*__PFN_glXCreateContextAttribsARB)(Display*, GLXFBConfig,
@@ -48,13 +61,34 @@ __PFN_glFinish glFinish_PTR = NULL;
 
 void* libx11 = NULL;
 void* libgl = NULL;
+void* libxext = NULL;
 //X
+decltype(XInitThreads)* XInitThreads_PTR = NULL;
 decltype(XOpenDisplay)* XOpenDisplay_PTR = NULL;
 decltype(XCloseDisplay)* XCloseDisplay_PTR = NULL;
 decltype(XDestroyWindow)* XDestroyWindow_PTR = NULL;
 decltype(XFree)* XFree_PTR = NULL;
 decltype(XGetErrorText)* XGetErrorText_PTR = NULL;
 decltype(XSetErrorHandler)* XSetErrorHandler_PTR = NULL;
+decltype(XCreatePixmap)* XCreatePixmap_PTR = NULL;
+decltype(XFreePixmap)* XFreePixmap_PTR = NULL;
+decltype(XCreateGC)* XCreateGC_PTR = NULL;
+decltype(XFreeGC)* XFreeGC_PTR = NULL;
+decltype(XCopyArea)* XCopyArea_PTR = NULL;
+decltype(XSync)* XSync_PTR = NULL;
+decltype(XGetGeometry)* XGetGeometry_PTR = NULL;
+decltype(XSelectInput)* XSelectInput_PTR = NULL;
+decltype(XPending)* XPending_PTR = NULL;
+decltype(XNextEvent)* XNextEvent_PTR = NULL;
+//Xext
+decltype(XShmQueryExtension)* XShmQueryExtension_PTR = NULL;
+decltype(XShmPixmapFormat)* XShmPixmapFormat_PTR = NULL;
+decltype(XShmAttach)* XShmAttach_PTR = NULL;
+decltype(XShmDetach)* XShmDetach_PTR = NULL;
+decltype(XShmCreatePixmap)* XShmCreatePixmap_PTR = NULL;
+decltype(XShmCreateImage)* XShmCreateImage_PTR = NULL;
+decltype(XShmPutImage)* XShmPutImage_PTR = NULL;
+decltype(XShmGetImage)* XShmGetImage_PTR = NULL;
 //glX
 decltype(glXGetProcAddress)* glXGetProcAddress_PTR = NULL;
 Bool(*glXQueryVersion_PTR)(Display*,int*,int*) = NULL;
@@ -71,6 +105,16 @@ void(*glXDestroyPbuffer_PTR)(Display*,GLXPbuffer) = NULL;
 const char*(*glXQueryExtensionsString_PTR)(Display*,int) = NULL;
 GLXFBConfig*(*glXGetFBConfigs_PTR)(Display*,int,int*) = NULL;
 Bool(*glXMakeContextCurrent_PTR)(Display*,GLXDrawable,GLXDrawable,GLXContext) = NULL;
+GLXPixmap(*glXCreatePixmap_PTR)(Display*,GLXFBConfig,Pixmap,const int*) = NULL;
+void(*glXDestroyPixmap_PTR)(Display*,GLXPixmap) = NULL;
+void(*glXBindTexImageEXT_PTR)(Display*,GLXDrawable,int,const int*) = NULL;
+void(*glXReleaseTexImageEXT_PTR)(Display*,GLXDrawable,int) = NULL;
+void(*glXQueryDrawable_PTR)(Display*,GLXDrawable,int,unsigned int*) = NULL;
+void(*glXCopySubBufferMESA_PTR)(Display*,GLXDrawable,int,int,int,int) = NULL;
+int64_t(*glXSwapBuffersMscOML_PTR)(Display*,GLXDrawable,int64_t,int64_t,int64_t) = NULL;
+Bool(*glXGetSyncValuesOML_PTR)(Display*,GLXDrawable,int64_t*,int64_t*,int64_t*) = NULL;
+Bool(*glXWaitForSbcOML_PTR)(Display*,GLXDrawable,int64_t,int64_t*,int64_t*,int64_t*) = NULL;
+Bool(*glXGetMscRateOML_PTR)(Display*,GLXDrawable,int32_t*,int32_t*) = NULL;
 
 __eglMustCastToProperFunctionPointerType __getProcAddress(const char *procname)
 {
@@ -115,12 +159,34 @@ EGLBoolean __internalInit(NativeLocalStorageContainer* nativeLocalStorageContain
 	libx11 = dlopen("libX11.so", RTLD_LAZY);
 	libgl = dlopen("libGL.so", RTLD_LAZY);
 #define LOAD_X11_FUNC_PTR(fname) fname##_PTR = (decltype(fname##_PTR)) dlsym(libx11, #fname)
+	LOAD_X11_FUNC_PTR(XInitThreads);
 	LOAD_X11_FUNC_PTR(XOpenDisplay);
 	LOAD_X11_FUNC_PTR(XCloseDisplay);
 	LOAD_X11_FUNC_PTR(XDestroyWindow);
 	LOAD_X11_FUNC_PTR(XFree);
 	LOAD_X11_FUNC_PTR(XGetErrorText);
 	LOAD_X11_FUNC_PTR(XSetErrorHandler);
+	LOAD_X11_FUNC_PTR(XCreatePixmap);
+	LOAD_X11_FUNC_PTR(XFreePixmap);
+	LOAD_X11_FUNC_PTR(XCreateGC);
+	LOAD_X11_FUNC_PTR(XFreeGC);
+	LOAD_X11_FUNC_PTR(XCopyArea);
+	LOAD_X11_FUNC_PTR(XSync);
+	LOAD_X11_FUNC_PTR(XGetGeometry);
+	LOAD_X11_FUNC_PTR(XSelectInput);
+	LOAD_X11_FUNC_PTR(XPending);
+	LOAD_X11_FUNC_PTR(XNextEvent);
+	// MIT-SHM is optional.
+	libxext = dlopen("libXext.so", RTLD_LAZY);
+#define LOAD_XEXT_FUNC_PTR(fname) fname##_PTR = libxext ? (decltype(fname##_PTR)) dlsym(libxext, #fname) : NULL
+	LOAD_XEXT_FUNC_PTR(XShmQueryExtension);
+	LOAD_XEXT_FUNC_PTR(XShmPixmapFormat);
+	LOAD_XEXT_FUNC_PTR(XShmAttach);
+	LOAD_XEXT_FUNC_PTR(XShmDetach);
+	LOAD_XEXT_FUNC_PTR(XShmCreatePixmap);
+	LOAD_XEXT_FUNC_PTR(XShmCreateImage);
+	LOAD_XEXT_FUNC_PTR(XShmPutImage);
+	LOAD_XEXT_FUNC_PTR(XShmGetImage);
 	//LOAD_GLX_FUNC_PTR(glXGetProcAddress);
 	glXGetProcAddress_PTR = (decltype(glXGetProcAddress_PTR)) dlsym(libgl, "glXGetProcAddress");
 	if (!glXGetProcAddress_PTR)
@@ -140,6 +206,22 @@ EGLBoolean __internalInit(NativeLocalStorageContainer* nativeLocalStorageContain
 	LOAD_GLX_FUNC_PTR(glXQueryExtensionsString);
 	LOAD_GLX_FUNC_PTR(glXGetFBConfigs);
 	LOAD_GLX_FUNC_PTR(glXMakeContextCurrent);
+	LOAD_GLX_FUNC_PTR(glXCreatePixmap);
+	LOAD_GLX_FUNC_PTR(glXDestroyPixmap);
+	LOAD_GLX_FUNC_PTR(glXBindTexImageEXT);
+	LOAD_GLX_FUNC_PTR(glXReleaseTexImageEXT);
+	LOAD_GLX_FUNC_PTR(glXQueryDrawable);
+	LOAD_GLX_FUNC_PTR(glXCopySubBufferMESA);
+	LOAD_GLX_FUNC_PTR(glXSwapBuffersMscOML);
+	LOAD_GLX_FUNC_PTR(glXGetSyncValuesOML);
+	LOAD_GLX_FUNC_PTR(glXWaitForSbcOML);
+	LOAD_GLX_FUNC_PTR(glXGetMscRateOML);
+
+	// The own display is used by several threads. Displays of the application are checked in __initialize.
+	if (XInitThreads_PTR)
+	{
+		XInitThreads_PTR();
+	}
 
 	nativeLocalStorageContainer->display = XOpenDisplay_PTR(NULL);
 
@@ -362,6 +444,10 @@ EGLBoolean __internalTerminate(NativeLocalStorageContainer* nativeLocalStorageCo
 
 	dlclose(libx11);
 	dlclose(libgl);
+	if (libxext)
+	{
+		dlclose(libxext);
+	}
 
 	return EGL_TRUE;
 }
@@ -544,6 +630,33 @@ EGLBoolean __processAttribList(EGLenum api, EGLint* target_attrib_list, const EG
 	return EGL_TRUE;
 }
 
+// The config attributes of the schema and the surface specific attributes, terminated by None.
+#define GLX_CHOOSE_ATTRIB_LIST_SIZE (_EGL_CONFIG_SCHEMA_SIZE * 2 + 32)
+
+static void __chooseAttribs(int* glxchooseAttribs, const EGLConfigImpl* walkerConfig, const int* surfaceAttribs)
+{
+	EGLint index = 0;
+
+	for (const EGLConfigAttribSchemaImpl& schema : g_configSchema)
+	{
+		if (!(schema.flags & _EGL_ATTRIB_NATIVE_CHOOSE) || !schema.nativeAttribute)
+		{
+			continue;
+		}
+
+		glxchooseAttribs[index++] = schema.nativeAttribute;
+		glxchooseAttribs[index++] = _EGL_CONFIG_VALUE(walkerConfig, schema);
+	}
+
+	while (*surfaceAttribs != None)
+	{
+		glxchooseAttribs[index++] = *surfaceAttribs++;
+		glxchooseAttribs[index++] = *surfaceAttribs++;
+	}
+
+	glxchooseAttribs[index] = None;
+}
+
 EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLint* attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
 {
 	if (!newSurface || !walkerDpy || !walkerConfig || !error)
@@ -592,16 +705,8 @@ EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLint* attr
 	}
 
 	GLXFBConfig config = 0;
-	int glxchooseAttribs[] = {
-		GLX_BUFFER_SIZE, walkerConfig->bufferSize,
-		GLX_LEVEL, walkerConfig->level,
+	const int surfaceAttribs[] = {
 		GLX_DOUBLEBUFFER, walkerConfig->doubleBuffer,
-		GLX_RED_SIZE, walkerConfig->redSize,
-		GLX_GREEN_SIZE, walkerConfig->greenSize,
-		GLX_BLUE_SIZE, walkerConfig->blueSize,
-		GLX_ALPHA_SIZE, walkerConfig->alphaSize,
-		GLX_DEPTH_SIZE, walkerConfig->depthSize,
-		GLX_STENCIL_SIZE, walkerConfig->stencilSize,
 		GLX_RENDER_TYPE, GLX_RGBA_BIT,
 		//GLX_DRAWABLE_TYPE, (walkerConfig->drawToWindow ?  GLX_WINDOW_BIT : 0) | (walkerConfig->drawToPBuffer ? GLX_PBUFFER_BIT : 0) | (walkerConfig->drawToPixmap ?  GLX_PIXMAP_BIT : 0),
 		GLX_DRAWABLE_TYPE, GLX_PBUFFER_BIT,
@@ -609,13 +714,23 @@ EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLint* attr
 		GLX_X_RENDERABLE, True,
 		None
 	};
+	int glxchooseAttribs[GLX_CHOOSE_ATTRIB_LIST_SIZE];
+	__chooseAttribs(glxchooseAttribs, walkerConfig, surfaceAttribs);
 
-	EGLint numConfigs = 0;
-	GLXFBConfig* chooseRetval = glXChooseFBConfig_PTR(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), glxchooseAttribs, &numConfigs);
-	if (chooseRetval==NULL || numConfigs==0)
-		return EGL_FALSE;
-	config = chooseRetval[0];
-	XFree_PTR(chooseRetval);
+	// The FBConfig mapped at initialization is used, unless sRGB is requested.
+	if (!colorspace_srgb && walkerConfig->nativeConfigContainer.pbuffer)
+	{
+		config = walkerConfig->nativeConfigContainer.pbuffer;
+	}
+	else
+	{
+		EGLint numConfigs = 0;
+		GLXFBConfig* chooseRetval = glXChooseFBConfig_PTR(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), glxchooseAttribs, &numConfigs);
+		if (chooseRetval==NULL || numConfigs==0)
+			return EGL_FALSE;
+		config = chooseRetval[0];
+		XFree_PTR(chooseRetval);
+	}
 
 	newSurface->drawToWindow = EGL_FALSE;
 	newSurface->drawToPixmap = EGL_FALSE;
@@ -629,6 +744,7 @@ EGLBoolean __createPbufferSurface(EGLSurfaceImpl* newSurface, const EGLint* attr
 	newSurface->pbuf = glXCreatePbuffer_PTR(display, config, glxattribs);
 	newSurface->nativeSurfaceContainer.config = config;
 	newSurface->nativeSurfaceContainer.drawable = newSurface->pbuf;
+	newSurface->nativeSurfaceContainer.pixmap = 0;
 
 	return EGL_TRUE;
 }
@@ -731,16 +847,8 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 	//
 
 	GLXFBConfig config = 0;
-	int glxchooseAttribs[] = {
-		GLX_BUFFER_SIZE, walkerConfig->bufferSize,
-		GLX_LEVEL, walkerConfig->level,
+	const int surfaceAttribs[] = {
 		GLX_DOUBLEBUFFER, doublebuffer,
-		GLX_RED_SIZE, walkerConfig->redSize,
-		GLX_GREEN_SIZE, walkerConfig->greenSize,
-		GLX_BLUE_SIZE, walkerConfig->blueSize,
-		GLX_ALPHA_SIZE, walkerConfig->alphaSize,
-		GLX_DEPTH_SIZE, walkerConfig->depthSize,
-		GLX_STENCIL_SIZE, walkerConfig->stencilSize,
 		GLX_RENDER_TYPE, GLX_RGBA_BIT,
 		//GLX_DRAWABLE_TYPE, (walkerConfig->drawToWindow ?  GLX_WINDOW_BIT : 0) | (walkerConfig->drawToPBuffer ? GLX_PBUFFER_BIT : 0) | (walkerConfig->drawToPixmap ?  GLX_PIXMAP_BIT : 0),
 		GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
@@ -748,13 +856,23 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 		GLX_X_RENDERABLE, True,
 		None
 	};
+	int glxchooseAttribs[GLX_CHOOSE_ATTRIB_LIST_SIZE];
+	__chooseAttribs(glxchooseAttribs, walkerConfig, surfaceAttribs);
 
-	EGLint numConfigs = 0;
-	GLXFBConfig* chooseRetval = glXChooseFBConfig_PTR(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), glxchooseAttribs, &numConfigs);
-	if (chooseRetval==NULL || numConfigs==0)
-		return EGL_FALSE;
-	config = chooseRetval[0];
-	XFree_PTR(chooseRetval);
+	// The FBConfig mapped at initialization has the visual of the config, which the window was created with.
+	if (!colorspace_srgb && walkerConfig->nativeConfigContainer.window)
+	{
+		config = walkerConfig->nativeConfigContainer.window;
+	}
+	else
+	{
+		EGLint numConfigs = 0;
+		GLXFBConfig* chooseRetval = glXChooseFBConfig_PTR(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), glxchooseAttribs, &numConfigs);
+		if (chooseRetval==NULL || numConfigs==0)
+			return EGL_FALSE;
+		config = chooseRetval[0];
+		XFree_PTR(chooseRetval);
+	}
 
 	newSurface->drawToWindow = EGL_TRUE;
 	newSurface->drawToPixmap = EGL_FALSE;
@@ -767,6 +885,143 @@ EGLBoolean __createWindowSurface(EGLSurfaceImpl* newSurface, EGLNativeWindowType
 	newSurface->win = win;
 	newSurface->nativeSurfaceContainer.config = config;
 	newSurface->nativeSurfaceContainer.drawable = win;
+	newSurface->nativeSurfaceContainer.pixmap = 0;
+
+	return EGL_TRUE;
+}
+
+static GLXFBConfig __choosePixmapConfig(const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLBoolean colorspace_srgb)
+{
+	// Pixmaps are single buffered, so the FBConfig mapped at initialization is only used for single buffered configs.
+	if (!colorspace_srgb && !walkerConfig->doubleBuffer && walkerConfig->nativeConfigContainer.pixmap)
+	{
+		return walkerConfig->nativeConfigContainer.pixmap;
+	}
+
+	const int surfaceAttribs[] = {
+		GLX_DOUBLEBUFFER, False,
+		GLX_RENDER_TYPE, GLX_RGBA_BIT,
+		GLX_DRAWABLE_TYPE, GLX_PIXMAP_BIT,
+		GLX_FRAMEBUFFER_SRGB_CAPABLE_ARB, (int)colorspace_srgb,
+		GLX_X_RENDERABLE, True,
+		None
+	};
+	int glxchooseAttribs[GLX_CHOOSE_ATTRIB_LIST_SIZE];
+	__chooseAttribs(glxchooseAttribs, walkerConfig, surfaceAttribs);
+
+	EGLint numConfigs = 0;
+	logglxcall("glXChooseFBConfig");
+	GLXFBConfig* chooseRetval = glXChooseFBConfig_PTR(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id), glxchooseAttribs, &numConfigs);
+	if (chooseRetval==NULL || numConfigs==0)
+	{
+		return 0;
+	}
+	GLXFBConfig config = chooseRetval[0];
+	XFree_PTR(chooseRetval);
+
+	return config;
+}
+
+EGLBoolean __createPixmapSurface(EGLSurfaceImpl* newSurface, EGLNativePixmapType pixmap, const EGLint *attrib_list, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
+{
+	if (!newSurface || !walkerDpy || !walkerConfig || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	if (!walkerConfig->drawToPixmap)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	if (!pixmap)
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_FALSE;
+	}
+
+	EGLBoolean colorspace_srgb = 0;
+	if (attrib_list)
+	{
+		EGLint indexAttribList = 0;
+
+		while (attrib_list[indexAttribList] != EGL_NONE)
+		{
+			EGLint value = attrib_list[indexAttribList + 1];
+
+			switch (attrib_list[indexAttribList])
+			{
+				case EGL_GL_COLORSPACE:
+				{
+					if (value == EGL_GL_COLORSPACE_LINEAR)
+					{
+						colorspace_srgb = 0;
+					}
+					else if (value == EGL_GL_COLORSPACE_SRGB)
+					{
+						colorspace_srgb = 1;
+					}
+					else
+					{
+						*error = EGL_BAD_ATTRIBUTE;
+
+						return EGL_FALSE;
+					}
+				}
+				break;
+				case EGL_VG_ALPHA_FORMAT:
+				case EGL_VG_COLORSPACE:
+				{
+					*error = EGL_BAD_MATCH;
+
+					return EGL_FALSE;
+				}
+				break;
+				default:
+				{
+					*error = EGL_BAD_ATTRIBUTE;
+
+					return EGL_FALSE;
+				}
+				break;
+			}
+
+			indexAttribList += 2;
+		}
+	}
+
+	GLXFBConfig config = __choosePixmapConfig(walkerDpy, walkerConfig, colorspace_srgb);
+	if (!config)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	logglxcall("glXCreatePixmap");
+	GLXPixmap drawable = glXCreatePixmap_PTR(walkerDpy->display_id, config, pixmap, NULL);
+	if (!drawable)
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_FALSE;
+	}
+
+	newSurface->drawToWindow = EGL_FALSE;
+	newSurface->drawToPixmap = EGL_TRUE;
+	newSurface->drawToPBuffer = EGL_FALSE;
+	newSurface->doubleBuffer = EGL_FALSE;
+	newSurface->configId = walkerConfig->configId;
+
+	newSurface->initialized = EGL_TRUE;
+	newSurface->destroy = EGL_FALSE;
+	newSurface->pixmap = pixmap;
+	newSurface->nativeSurfaceContainer.config = config;
+	newSurface->nativeSurfaceContainer.drawable = drawable;
+	newSurface->nativeSurfaceContainer.pixmap = 0;
 
 	return EGL_TRUE;
 }
@@ -783,11 +1038,94 @@ EGLBoolean __destroySurface(EGLNativeDisplayType dpy, const EGLSurfaceImpl* surf
 		logglxcall("glXDestroyPbuffer");
 		glXDestroyPbuffer_PTR(dpy, surface->pbuf);
 	}
+	else if (surface->drawToPixmap)
+	{
+		// The X pixmap belongs to the application.
+		logglxcall("glXDestroyPixmap");
+		glXDestroyPixmap_PTR(dpy, surface->nativeSurfaceContainer.drawable);
+	}
 	// else Nothing to release.
 
 	return EGL_TRUE;
 }
 
+// Ranks an FBConfig against the others, which are equivalent in EGL. Slow configs, other visual classes than TrueColor and
+// accumulation buffers, which EGL does not expose, are worse.
+static EGLBoolean __rankFBConfig(const EGLDisplayImpl* walkerDpy, GLXFBConfig fbConfig, EGLint* rank)
+{
+	static const int rankAttributes[] = { GLX_ACCUM_RED_SIZE, GLX_ACCUM_GREEN_SIZE, GLX_ACCUM_BLUE_SIZE, GLX_ACCUM_ALPHA_SIZE, GLX_AUX_BUFFERS };
+
+	EGLint value;
+
+	*rank = 0;
+
+	logglxcall("glXGetFBConfigAttrib");
+	if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfig, GLX_CONFIG_CAVEAT, &value))
+	{
+		return EGL_FALSE;
+	}
+	if (value == GLX_SLOW_CONFIG)
+	{
+		*rank += 0x10000;
+	}
+
+	logglxcall("glXGetFBConfigAttrib");
+	if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfig, GLX_X_VISUAL_TYPE, &value))
+	{
+		return EGL_FALSE;
+	}
+	if (value != GLX_TRUE_COLOR)
+	{
+		*rank += 0x1000;
+	}
+
+	for (int attribute : rankAttributes)
+	{
+		logglxcall("glXGetFBConfigAttrib");
+		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfig, attribute, &value))
+		{
+			return EGL_FALSE;
+		}
+		*rank += value;
+	}
+
+	return EGL_TRUE;
+}
+
+// Keeps the better of two FBConfigs for a surface type.
+static void __mapFBConfig(GLXFBConfig* fbConfigSlot, EGLint* rankSlot, GLXFBConfig fbConfig, EGLint rank)
+{
+	if (fbConfig && (!*fbConfigSlot || rank < *rankSlot))
+	{
+		*fbConfigSlot = fbConfig;
+		*rankSlot = rank;
+	}
+}
+
+// Merges an equivalent candidate into a config. The surface types are united, each keeps the best FBConfig.
+static void __mergeConfig(EGLConfigImpl* walkerConfig, const EGLConfigImpl* candidateConfig)
+{
+	NativeConfigContainer* nativeConfigContainer = &walkerConfig->nativeConfigContainer;
+	const NativeConfigContainer* candidateContainer = &candidateConfig->nativeConfigContainer;
+
+	const GLXFBConfig window = nativeConfigContainer->window;
+
+	__mapFBConfig(&nativeConfigContainer->window, &nativeConfigContainer->windowRank, candidateContainer->window, candidateContainer->windowRank);
+	__mapFBConfig(&nativeConfigContainer->pixmap, &nativeConfigContainer->pixmapRank, candidateContainer->pixmap, candidateContainer->pixmapRank);
+	__mapFBConfig(&nativeConfigContainer->pbuffer, &nativeConfigContainer->pbufferRank, candidateContainer->pbuffer, candidateContainer->pbufferRank);
+
+	walkerConfig->drawToWindow |= candidateConfig->drawToWindow;
+	walkerConfig->drawToPixmap |= candidateConfig->drawToPixmap;
+	walkerConfig->drawToPBuffer |= candidateConfig->drawToPBuffer;
+	walkerConfig->surfaceType |= candidateConfig->surfaceType;
+
+	// Windows have to be created with the visual of the FBConfig, which renders into them.
+	if (nativeConfigContainer->window != window)
+	{
+		walkerConfig->nativeVisualId = candidateConfig->nativeVisualId;
+	}
+}
+
 EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageContainer* nativeLocalStorageContainer, EGLint* error)
 {
 	if (!walkerDpy || !nativeLocalStorageContainer || !error)
@@ -797,9 +1135,51 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 
 	logglxcall("glXQueryExtensionsString");
 	const char* extensions_str = glXQueryExtensionsString_PTR(walkerDpy->display_id, DefaultScreen(walkerDpy->display_id));
-	int ES_supported = strstr(extensions_str, "GLX_EXT_create_context_es_profile") != NULL;
+	int ES_supported = _eglInternalHasExtension(extensions_str, "GLX_EXT_create_context_es_profile");
 	const EGLint ES_mask = ES_supported * (EGL_OPENGL_ES_BIT | EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT);
 
+	// Shared memory and event file descriptors are always available.
+	walkerDpy->nativeCaps = _EGL_NATIVE_STREAM_CROSS_PROCESS;
+
+	// XInitThreads only affects displays opened afterwards, so a display of the application can lack thread support.
+	// Since libX11 1.8, which added XFreeThreads, every display has it. Otherwise, only the own display is trusted.
+	if (walkerDpy->display_id == nativeLocalStorageContainer->display || dlsym(libx11, "XFreeThreads"))
+	{
+		walkerDpy->nativeCaps |= _EGL_NATIVE_THREADS | _EGL_NATIVE_CONTEXT_POOL;
+	}
+	if (_eglInternalHasExtension(extensions_str, "GLX_EXT_texture_from_pixmap") && glXBindTexImageEXT_PTR && glXReleaseTexImageEXT_PTR)
+	{
+		walkerDpy->nativeCaps |= _EGL_NATIVE_TEXTURE_FROM_PIXMAP;
+	}
+	if (_eglInternalHasExtension(extensions_str, "GLX_EXT_buffer_age"))
+	{
+		walkerDpy->nativeCaps |= _EGL_NATIVE_BUFFER_AGE;
+	}
+	if (_eglInternalHasExtension(extensions_str, "GLX_MESA_copy_sub_buffer") && glXCopySubBufferMESA_PTR)
+	{
+		walkerDpy->nativeCaps |= _EGL_NATIVE_COPY_SUB_BUFFER;
+	}
+	if (_eglInternalHasExtension(extensions_str, "GLX_OML_sync_control") && glXSwapBuffersMscOML_PTR && glXGetSyncValuesOML_PTR && glXWaitForSbcOML_PTR && glXGetMscRateOML_PTR)
+	{
+		walkerDpy->nativeCaps |= _EGL_NATIVE_SYNC_CONTROL;
+	}
+	if (_eglInternalHasExtension(extensions_str, "GLX_EXT_swap_control") && glXSwapIntervalEXT_PTR)
+	{
+		walkerDpy->nativeCaps |= _EGL_NATIVE_SWAP_CONTROL;
+
+		if (_eglInternalHasExtension(extensions_str, "GLX_EXT_swap_control_tear"))
+		{
+			walkerDpy->nativeCaps |= _EGL_NATIVE_SWAP_CONTROL_TEAR;
+		}
+	}
+	if (XShmQueryExtension_PTR && XShmPixmapFormat_PTR && XShmAttach_PTR && XShmDetach_PTR && XShmCreatePixmap_PTR && XShmCreateImage_PTR && XShmPutImage_PTR && XShmGetImage_PTR && XShmQueryExtension_PTR(walkerDpy->display_id))
+	{
+		walkerDpy->nativeCaps |= _EGL_NATIVE_SHM;
+
+		// Locked windows and pixmaps are mapped through a shared memory image.
+		walkerDpy->nativeCaps |= _EGL_NATIVE_LOCK_SURFACE;
+	}
+
 	// Create configuration list.
 
 	EGLint numberPixelFormats;
@@ -877,29 +1257,11 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 
 		//
 
-		EGLConfigImpl* newConfig = (EGLConfigImpl*)malloc(sizeof(EGLConfigImpl));
-		if (!newConfig)
-		{
-			XFree_PTR(fbConfigs);
-
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
-		}
+		// Read into a candidate, as an equivalent config may already exist.
+		EGLConfigImpl candidateConfig;
+		EGLConfigImpl* newConfig = &candidateConfig;
 		_eglInternalSetDefaultConfig(newConfig);
 
-		// Store in the same order as received.
-		newConfig->next = 0;
-		if (lastConfig != 0)
-		{
-			lastConfig->next = newConfig;
-		}
-		else
-		{
-			walkerDpy->rootConfig = newConfig;
-		}
-		lastConfig = newConfig;
-
 		//
 
 		attribute = GLX_DRAWABLE_TYPE;
@@ -945,92 +1307,98 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 		{
 			newConfig->surfaceType |= EGL_PBUFFER_BIT;
 		}
+		// A double buffered window can be switched to render into its front buffer.
+		if (newConfig->drawToWindow && newConfig->doubleBuffer)
+		{
+			newConfig->surfaceType |= EGL_MUTABLE_RENDER_BUFFER_BIT_KHR;
+		}
 		newConfig->colorBufferType = EGL_RGB_BUFFER;
 		newConfig->configId = currentPixelFormat;
 
-		attribute = GLX_BUFFER_SIZE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bufferSize))
+		// The attributes, which correspond to an FBConfig attribute.
+		for (const EGLConfigAttribSchemaImpl& schema : g_configSchema)
 		{
-			XFree_PTR(fbConfigs);
+			if (!(schema.flags & _EGL_ATTRIB_NATIVE_READ) || !schema.nativeAttribute)
+			{
+				continue;
+			}
 
-			*error = EGL_NOT_INITIALIZED;
+			logglxcall("glXGetFBConfigAttrib");
+			if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], schema.nativeAttribute, &_EGL_CONFIG_VALUE(newConfig, schema)))
+			{
+				XFree_PTR(fbConfigs);
 
-			return EGL_FALSE;
+				*error = EGL_NOT_INITIALIZED;
+
+				return EGL_FALSE;
+			}
 		}
 
-		attribute = GLX_RED_SIZE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->redSize))
+		// Preserved swaps are emulated by copying the back buffer, which can not be blitted back into a multisample buffer.
+		if (!newConfig->sampleBuffers)
 		{
-			XFree_PTR(fbConfigs);
-
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			newConfig->surfaceType |= EGL_SWAP_BEHAVIOR_PRESERVED_BIT;
 		}
 
-		attribute = GLX_GREEN_SIZE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->greenSize))
+		// Some drivers report pbuffer support for FBConfigs, which can not allocate any pbuffer.
+		if (newConfig->drawToPBuffer && (newConfig->maxPBufferPixels <= 0 || newConfig->maxPBufferWidth <= 0 || newConfig->maxPBufferHeight <= 0))
 		{
-			XFree_PTR(fbConfigs);
-
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			newConfig->drawToPBuffer = EGL_FALSE;
+			newConfig->surfaceType &= ~EGL_PBUFFER_BIT;
 		}
 
-		attribute = GLX_BLUE_SIZE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->blueSize))
+		// Without swap control, every swap waits for the vertical blank. Negative intervals tear late frames.
+		if (walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL)
 		{
-			XFree_PTR(fbConfigs);
+			newConfig->maxSwapInterval = _EGL_SWAP_INTERVAL_MAX;
+			newConfig->minSwapInterval = (walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL_TEAR) ? -_EGL_SWAP_INTERVAL_MAX : 0;
+		}
+		else
+		{
+			newConfig->maxSwapInterval = 1;
+			newConfig->minSwapInterval = 1;
+		}
 
-			*error = EGL_NOT_INITIALIZED;
+		//
 
-			return EGL_FALSE;
-		}
+		newConfig->bindToTextureRGB = newConfig->bindToTextureRGB ? EGL_TRUE : EGL_FALSE;
+		newConfig->bindToTextureRGBA = newConfig->bindToTextureRGBA ? EGL_TRUE : EGL_FALSE;
 
-		attribute = GLX_ALPHA_SIZE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->alphaSize))
+		// Stream frames are GLX pixmaps, which are latched by the consumer using texture from pixmap.
+		if ((walkerDpy->nativeCaps & _EGL_NATIVE_TEXTURE_FROM_PIXMAP) && newConfig->drawToPixmap && (newConfig->alphaSize ? newConfig->bindToTextureRGBA : newConfig->bindToTextureRGB))
 		{
-			XFree_PTR(fbConfigs);
-
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			newConfig->surfaceType |= EGL_STREAM_BIT_KHR;
 		}
 
-		attribute = GLX_DEPTH_SIZE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->depthSize))
+		// Locked surfaces are mapped with 32 bit pixels in the byte order of GL_BGRA, so only 8 bit channels can be locked.
+		if ((walkerDpy->nativeCaps & _EGL_NATIVE_LOCK_SURFACE) && newConfig->redSize == 8 && newConfig->greenSize == 8 && newConfig->blueSize == 8 && (newConfig->alphaSize == 0 || newConfig->alphaSize == 8))
 		{
-			XFree_PTR(fbConfigs);
-
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			newConfig->surfaceType |= EGL_LOCK_SURFACE_BIT_KHR;
 		}
 
-		attribute = GLX_STENCIL_SIZE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->stencilSize))
-		{
-			XFree_PTR(fbConfigs);
+		//
 
-			*error = EGL_NOT_INITIALIZED;
+		newConfig->transparentType = newConfig->transparentType == GLX_TRANSPARENT_RGB ? EGL_TRANSPARENT_RGB : EGL_NONE;
 
-			return EGL_FALSE;
+		// Slow FBConfigs stay configs of their own, as the caveat is part of the equivalence.
+		if (newConfig->configCaveat == GLX_SLOW_CONFIG)
+		{
+			newConfig->configCaveat = EGL_SLOW_CONFIG;
+		}
+		else if (newConfig->configCaveat == GLX_NON_CONFORMANT_CONFIG)
+		{
+			newConfig->configCaveat = EGL_NON_CONFORMANT_CONFIG;
+		}
+		else
+		{
+			newConfig->configCaveat = EGL_NONE;
 		}
-
 
 		//
+		logglxcall("glXGetVisualFromFBConfig");
+		visualInfo = glXGetVisualFromFBConfig_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat]);
 
-		attribute = GLX_SAMPLE_BUFFERS;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->sampleBuffers))
+		if (!visualInfo)
 		{
 			XFree_PTR(fbConfigs);
 
@@ -1039,22 +1407,19 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 			return EGL_FALSE;
 		}
 
-		attribute = GLX_SAMPLES;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->samples))
-		{
-			XFree_PTR(fbConfigs);
+		newConfig->nativeVisualId = visualInfo->visualid;
 
-			*error = EGL_NOT_INITIALIZED;
+		XFree_PTR(visualInfo);
 
-			return EGL_FALSE;
-		}
+		newConfig->matchNativePixmap = EGL_NONE;
+		newConfig->nativeRenderable = EGL_DONT_CARE; // ???
+
+		// FIXME: Query and save more values.
 
 		//
 
-		attribute = GLX_BIND_TO_TEXTURE_RGB_EXT;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bindToTextureRGB))
+		EGLint rank;
+		if (!__rankFBConfig(walkerDpy, fbConfigs[currentPixelFormat], &rank))
 		{
 			XFree_PTR(fbConfigs);
 
@@ -1062,36 +1427,37 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 
 			return EGL_FALSE;
 		}
-		newConfig->bindToTextureRGB = newConfig->bindToTextureRGB ? EGL_TRUE : EGL_FALSE;
 
-		attribute = GLX_BIND_TO_TEXTURE_RGBA_EXT;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->bindToTextureRGBA))
+		NativeConfigContainer* nativeConfigContainer = &newConfig->nativeConfigContainer;
+		if (newConfig->drawToWindow)
 		{
-			XFree_PTR(fbConfigs);
-
-			*error = EGL_NOT_INITIALIZED;
-
-			return EGL_FALSE;
+			__mapFBConfig(&nativeConfigContainer->window, &nativeConfigContainer->windowRank, fbConfigs[currentPixelFormat], rank);
+		}
+		if (newConfig->drawToPixmap)
+		{
+			__mapFBConfig(&nativeConfigContainer->pixmap, &nativeConfigContainer->pixmapRank, fbConfigs[currentPixelFormat], rank);
+		}
+		if (newConfig->drawToPBuffer)
+		{
+			__mapFBConfig(&nativeConfigContainer->pbuffer, &nativeConfigContainer->pbufferRank, fbConfigs[currentPixelFormat], rank);
 		}
-		newConfig->bindToTextureRGBA = newConfig->bindToTextureRGBA ? EGL_TRUE : EGL_FALSE;
-
-		//
 
-		attribute = GLX_MAX_PBUFFER_PIXELS;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferPixels))
+		// FBConfigs, which only differ in attributes not visible in EGL, are merged into the first config.
+		EGLConfigImpl* walkerConfig = walkerDpy->rootConfig;
+		while (walkerConfig && !_eglInternalEquivalentConfig(walkerConfig, newConfig))
 		{
-			XFree_PTR(fbConfigs);
+			walkerConfig = walkerConfig->next;
+		}
 
-			*error = EGL_NOT_INITIALIZED;
+		if (walkerConfig)
+		{
+			__mergeConfig(walkerConfig, newConfig);
 
-			return EGL_FALSE;
+			continue;
 		}
 
-		attribute = GLX_MAX_PBUFFER_WIDTH;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferWidth))
+		EGLConfigImpl* storedConfig = (EGLConfigImpl*)malloc(sizeof(EGLConfigImpl));
+		if (!storedConfig)
 		{
 			XFree_PTR(fbConfigs);
 
@@ -1099,155 +1465,1160 @@ EGLBoolean __initialize(EGLDisplayImpl* walkerDpy, const NativeLocalStorageConta
 
 			return EGL_FALSE;
 		}
+		*storedConfig = candidateConfig;
 
-		attribute = GLX_MAX_PBUFFER_HEIGHT;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->maxPBufferHeight))
+		// Store in the same order as received.
+		storedConfig->next = 0;
+		if (lastConfig != 0)
 		{
-			XFree_PTR(fbConfigs);
+			lastConfig->next = storedConfig;
+		}
+		else
+		{
+			walkerDpy->rootConfig = storedConfig;
+		}
+		lastConfig = storedConfig;
+	}
 
-			*error = EGL_NOT_INITIALIZED;
+	XFree_PTR(fbConfigs);
 
-			return EGL_FALSE;
-		}
+	return EGL_TRUE;
+}
 
-		//
+EGLBoolean __createTexturePixmap(NativeSurfaceContainer* nativeSurfaceContainer, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLenum textureFormat, EGLint width, EGLint height, EGLint* error)
+{
+	if (!nativeSurfaceContainer || !walkerDpy || !walkerConfig || !error)
+	{
+		return EGL_FALSE;
+	}
 
-		attribute = GLX_TRANSPARENT_TYPE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentType))
-		{
-			XFree_PTR(fbConfigs);
+	if (!(walkerDpy->nativeCaps & _EGL_NATIVE_TEXTURE_FROM_PIXMAP) || (textureFormat != EGL_TEXTURE_RGB && textureFormat != EGL_TEXTURE_RGBA) || width <= 0 || height <= 0)
+	{
+		*error = EGL_BAD_MATCH;
 
-			*error = EGL_NOT_INITIALIZED;
+		return EGL_FALSE;
+	}
 
-			return EGL_FALSE;
-		}
-		newConfig->transparentType = newConfig->transparentType == GLX_TRANSPARENT_RGB ? EGL_TRANSPARENT_RGB : EGL_NONE;
+	EGLNativeDisplayType display = walkerDpy->display_id;
 
-		attribute = GLX_TRANSPARENT_RED_VALUE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentRedValue))
-		{
-			XFree_PTR(fbConfigs);
+	const EGLBoolean rgba = textureFormat == EGL_TEXTURE_RGBA;
 
-			*error = EGL_NOT_INITIALIZED;
+	GLXFBConfig config = 0;
+	const int surfaceAttribs[] = {
+		GLX_DOUBLEBUFFER, False,
+		GLX_RENDER_TYPE, GLX_RGBA_BIT,
+		GLX_DRAWABLE_TYPE, GLX_PIXMAP_BIT,
+		rgba ? GLX_BIND_TO_TEXTURE_RGBA_EXT : GLX_BIND_TO_TEXTURE_RGB_EXT, True,
+		GLX_BIND_TO_TEXTURE_TARGETS_EXT, GLX_TEXTURE_2D_BIT_EXT,
+		GLX_X_RENDERABLE, True,
+		None
+	};
+	int glxchooseAttribs[GLX_CHOOSE_ATTRIB_LIST_SIZE];
+	__chooseAttribs(glxchooseAttribs, walkerConfig, surfaceAttribs);
 
-			return EGL_FALSE;
-		}
+	EGLint numConfigs = 0;
+	logglxcall("glXChooseFBConfig");
+	GLXFBConfig* chooseRetval = glXChooseFBConfig_PTR(display, DefaultScreen(display), glxchooseAttribs, &numConfigs);
+	if (chooseRetval==NULL || numConfigs==0)
+	{
+		*error = EGL_BAD_MATCH;
 
-		attribute = GLX_TRANSPARENT_GREEN_VALUE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentGreenValue))
-		{
-			XFree_PTR(fbConfigs);
+		return EGL_FALSE;
+	}
+	config = chooseRetval[0];
+	XFree_PTR(chooseRetval);
 
-			*error = EGL_NOT_INITIALIZED;
+	logglxcall("glXGetVisualFromFBConfig");
+	XVisualInfo* visualInfo = glXGetVisualFromFBConfig_PTR(display, config);
+	if (!visualInfo)
+	{
+		*error = EGL_BAD_MATCH;
 
-			return EGL_FALSE;
-		}
+		return EGL_FALSE;
+	}
 
-		attribute = GLX_TRANSPARENT_BLUE_VALUE;
-		logglxcall("glXGetFBConfigAttrib");
-		if (glXGetFBConfigAttrib_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat], attribute, &newConfig->transparentBlueValue))
-		{
-			XFree_PTR(fbConfigs);
+	Pixmap pixmap = XCreatePixmap_PTR(display, DefaultRootWindow(display), (unsigned int)width, (unsigned int)height, (unsigned int)visualInfo->depth);
 
-			*error = EGL_NOT_INITIALIZED;
+	XFree_PTR(visualInfo);
 
-			return EGL_FALSE;
-		}
+	if (!pixmap)
+	{
+		*error = EGL_BAD_ALLOC;
 
-		//
-		logglxcall("glXGetVisualFromFBConfig");
-		visualInfo = glXGetVisualFromFBConfig_PTR(walkerDpy->display_id, fbConfigs[currentPixelFormat]);
+		return EGL_FALSE;
+	}
 
-		if (!visualInfo)
-		{
-			XFree_PTR(fbConfigs);
+	int glxattribs[] = {
+		GLX_TEXTURE_TARGET_EXT, GLX_TEXTURE_2D_EXT,
+		GLX_TEXTURE_FORMAT_EXT, rgba ? GLX_TEXTURE_FORMAT_RGBA_EXT : GLX_TEXTURE_FORMAT_RGB_EXT,
+		None
+	};
 
-			*error = EGL_NOT_INITIALIZED;
+	logglxcall("glXCreatePixmap");
+	GLXPixmap drawable = glXCreatePixmap_PTR(display, config, pixmap, glxattribs);
+	if (!drawable)
+	{
+		XFreePixmap_PTR(display, pixmap);
 
-			return EGL_FALSE;
-		}
+		*error = EGL_BAD_ALLOC;
 
-		newConfig->nativeVisualId = visualInfo->visualid;
+		return EGL_FALSE;
+	}
 
-		XFree_PTR(visualInfo);
+	nativeSurfaceContainer->drawable = drawable;
+	nativeSurfaceContainer->config = config;
+	nativeSurfaceContainer->pixmap = pixmap;
 
-		newConfig->matchNativePixmap = EGL_NONE;
-		newConfig->nativeRenderable = EGL_DONT_CARE; // ???
+	return EGL_TRUE;
+}
 
-		// FIXME: Query and save more values.
+EGLBoolean __destroyTexturePixmap(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+	if (!walkerDpy || !nativeSurfaceContainer)
+	{
+		return EGL_FALSE;
 	}
 
-	XFree_PTR(fbConfigs);
+	if (nativeSurfaceContainer->drawable)
+	{
+		logglxcall("glXDestroyPixmap");
+		glXDestroyPixmap_PTR(walkerDpy->display_id, nativeSurfaceContainer->drawable);
+	}
+
+	if (nativeSurfaceContainer->pixmap)
+	{
+		XFreePixmap_PTR(walkerDpy->display_id, nativeSurfaceContainer->pixmap);
+	}
 
 	return EGL_TRUE;
 }
 
-static int xerrorhandler(Display *dsp, XErrorEvent *error)
+EGLBoolean __bindTexImage(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
 {
-  char errorstring[1024];
-  XGetErrorText_PTR(dsp, error->error_code, errorstring, 1024);
-  int minor = error->minor_code;
-  int err = error->error_code;
-    
-  std::cerr << "X error--" << errorstring << " minor = " << minor << " major = " << err << std::endl;
-  exit(-1);
+	if (!walkerDpy || !nativeSurfaceContainer || !(walkerDpy->nativeCaps & _EGL_NATIVE_TEXTURE_FROM_PIXMAP))
+	{
+		return EGL_FALSE;
+	}
+
+	// Binds to the texture object currently bound to GL_TEXTURE_2D.
+	logglxcall("glXBindTexImageEXT");
+	glXBindTexImageEXT_PTR(walkerDpy->display_id, nativeSurfaceContainer->drawable, GLX_FRONT_LEFT_EXT, NULL);
+
+	return EGL_TRUE;
 }
-EGLBoolean __createContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList)
+
+EGLBoolean __releaseTexImage(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer)
 {
-	if (!nativeContextContainer || !walkerDpy || !nativeSurfaceContainer)
+	if (!walkerDpy || !nativeSurfaceContainer || !(walkerDpy->nativeCaps & _EGL_NATIVE_TEXTURE_FROM_PIXMAP))
 	{
 		return EGL_FALSE;
 	}
-	//XSetErrorHandler(xerrorhandler);
-	logglxcall("glXCreateContextAttribsARB");
-	nativeContextContainer->ctx = glXCreateContextAttribsARB_PTR(walkerDpy->display_id, nativeSurfaceContainer->config, sharedNativeContextContainer ? sharedNativeContextContainer->ctx : 0, True, attribList);
 
-	return nativeContextContainer->ctx != 0;
+	logglxcall("glXReleaseTexImageEXT");
+	glXReleaseTexImageEXT_PTR(walkerDpy->display_id, nativeSurfaceContainer->drawable, GLX_FRONT_LEFT_EXT);
+
+	return EGL_TRUE;
 }
 
-EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* nativeContextContainer)
+// Creates and attaches a segment. It is removed by the system, as soon as the X server and this process did detach.
+static EGLBoolean __attachShmSegment(Display* display, NativeShmContainer* nativeShmContainer, size_t size)
 {
-	if (!walkerDpy || (!nativeSurfaceContainer && nativeContextContainer) || (nativeSurfaceContainer && !nativeContextContainer))
+	nativeShmContainer->shminfo.shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+	if (nativeShmContainer->shminfo.shmid < 0)
 	{
 		return EGL_FALSE;
 	}
 
-	if (!nativeContextContainer)
+	nativeShmContainer->shminfo.shmaddr = (char*)shmat(nativeShmContainer->shminfo.shmid, NULL, 0);
+	if (nativeShmContainer->shminfo.shmaddr == (char*)-1)
 	{
-		logglxcall("glXMakeCurrent");
-		return (EGLBoolean)glXMakeCurrent_PTR(walkerDpy->display_id, None, NULL);
+		nativeShmContainer->shminfo.shmaddr = NULL;
+
+		shmctl(nativeShmContainer->shminfo.shmid, IPC_RMID, NULL);
+
+		return EGL_FALSE;
 	}
 
-	logglxcall("glXMakeCurrent");
-	return (EGLBoolean)glXMakeCurrent_PTR(walkerDpy->display_id, nativeSurfaceContainer->drawable, nativeContextContainer->ctx);
-}
+	nativeShmContainer->shminfo.readOnly = False;
 
-EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
-{
-	if (!walkerDpy || !walkerSurface)
+	if (!XShmAttach_PTR(display, &nativeShmContainer->shminfo))
 	{
+		shmdt(nativeShmContainer->shminfo.shmaddr);
+		nativeShmContainer->shminfo.shmaddr = NULL;
+
+		shmctl(nativeShmContainer->shminfo.shmid, IPC_RMID, NULL);
+
 		return EGL_FALSE;
 	}
 
-	logglxcall("glXSwapBuffers");
-	glXSwapBuffers_PTR(walkerDpy->display_id, walkerSurface->win);
+	// The server has to attach, before the segment can be removed.
+	XSync_PTR(display, False);
+
+	shmctl(nativeShmContainer->shminfo.shmid, IPC_RMID, NULL);
 
 	return EGL_TRUE;
 }
 
-EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, EGLint interval)
+EGLBoolean __createShmPixmap(EGLShmImpl* newShm, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint* error)
 {
-	if (!walkerDpy)
+	if (!newShm || !walkerDpy || !walkerConfig || !error)
 	{
 		return EGL_FALSE;
 	}
 
-	logglxcall("glXSwapIntervalEXT");
-	glXSwapIntervalEXT_PTR(walkerDpy->display_id, walkerDpy->currentDraw->win, interval);
+	EGLNativeDisplayType display = walkerDpy->display_id;
+
+	if (!(walkerDpy->nativeCaps & _EGL_NATIVE_SHM) || XShmPixmapFormat_PTR(display) != ZPixmap || !walkerConfig->drawToPixmap)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	GLXFBConfig config = __choosePixmapConfig(walkerDpy, walkerConfig, False);
+	if (!config)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	logglxcall("glXGetVisualFromFBConfig");
+	XVisualInfo* visualInfo = glXGetVisualFromFBConfig_PTR(display, config);
+	if (!visualInfo)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	unsigned int depth = (unsigned int)visualInfo->depth;
+
+	XFree_PTR(visualInfo);
+
+	// Both depths are stored with 32 bits per pixel.
+	if (depth != 24 && depth != 32)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	NativeShmContainer* nativeShmContainer = &newShm->nativeShmContainer;
+
+	newShm->stride = newShm->width * 4;
+
+	if (!__attachShmSegment(display, nativeShmContainer, (size_t)newShm->stride * (size_t)newShm->height))
+	{
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	nativeShmContainer->pixmap = XShmCreatePixmap_PTR(display, DefaultRootWindow(display), nativeShmContainer->shminfo.shmaddr, &nativeShmContainer->shminfo, (unsigned int)newShm->width, (unsigned int)newShm->height, depth);
+	if (!nativeShmContainer->pixmap)
+	{
+		__destroyShm(walkerDpy, newShm);
+
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	newShm->pixmap = nativeShmContainer->pixmap;
+	newShm->pixels = nativeShmContainer->shminfo.shmaddr;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __createShmImage(EGLShmImpl* newShm, const EGLDisplayImpl* walkerDpy, EGLint* error)
+{
+	if (!newShm || !walkerDpy || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	EGLNativeDisplayType display = walkerDpy->display_id;
+
+	if (!(walkerDpy->nativeCaps & _EGL_NATIVE_SHM))
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	// The image has the depth of the target pixmap, so it can be put into it.
+	Window root;
+	int x, y;
+	unsigned int width, height, border, depth;
+
+	if (!XGetGeometry_PTR(display, newShm->pixmap, &root, &x, &y, &width, &height, &border, &depth))
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_FALSE;
+	}
+
+	if (depth != 24 && depth != 32)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	NativeShmContainer* nativeShmContainer = &newShm->nativeShmContainer;
+
+	nativeShmContainer->image = XShmCreateImage_PTR(display, DefaultVisual(display, DefaultScreen(display)), depth, ZPixmap, NULL, &nativeShmContainer->shminfo, (unsigned int)newShm->width, (unsigned int)newShm->height);
+	if (!nativeShmContainer->image)
+	{
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	if (!__attachShmSegment(display, nativeShmContainer, (size_t)nativeShmContainer->image->bytes_per_line * (size_t)newShm->height))
+	{
+		XDestroyImage(nativeShmContainer->image);
+		nativeShmContainer->image = NULL;
+
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	nativeShmContainer->image->data = nativeShmContainer->shminfo.shmaddr;
+
+	newShm->pixels = nativeShmContainer->shminfo.shmaddr;
+	newShm->stride = nativeShmContainer->image->bytes_per_line;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __destroyShm(const EGLDisplayImpl* walkerDpy, EGLShmImpl* shm)
+{
+	if (!walkerDpy || !shm)
+	{
+		return EGL_FALSE;
+	}
+
+	EGLNativeDisplayType display = walkerDpy->display_id;
+
+	NativeShmContainer* nativeShmContainer = &shm->nativeShmContainer;
+
+	if (nativeShmContainer->pixmap)
+	{
+		XFreePixmap_PTR(display, nativeShmContainer->pixmap);
+		nativeShmContainer->pixmap = 0;
+	}
+
+	if (nativeShmContainer->image)
+	{
+		// The data is the segment, which is detached below.
+		nativeShmContainer->image->data = NULL;
+		XDestroyImage(nativeShmContainer->image);
+		nativeShmContainer->image = NULL;
+	}
+
+	if (nativeShmContainer->shminfo.shmaddr)
+	{
+		XShmDetach_PTR(display, &nativeShmContainer->shminfo);
+		XSync_PTR(display, False);
+
+		shmdt(nativeShmContainer->shminfo.shmaddr);
+		nativeShmContainer->shminfo.shmaddr = NULL;
+	}
+
+	shm->pixels = 0;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __copyBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLNativePixmapType target, EGLint* error)
+{
+	if (!walkerDpy || !walkerSurface || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	EGLNativeDisplayType display = walkerDpy->display_id;
+
+	// A pbuffer is no X drawable, so it is copied with its shared image.
+	if (walkerSurface->drawToPBuffer && !walkerSurface->copyImage)
+	{
+		*error = EGL_BAD_MATCH;
+
+		return EGL_FALSE;
+	}
+
+	GC gc = XCreateGC_PTR(display, target, 0, NULL);
+	if (!gc)
+	{
+		*error = EGL_BAD_NATIVE_PIXMAP;
+
+		return EGL_FALSE;
+	}
+
+	if (walkerSurface->copyImage)
+	{
+		const EGLShmImpl* copyImage = walkerSurface->copyImage;
+
+		XShmPutImage_PTR(display, target, gc, copyImage->nativeShmContainer.image, 0, 0, 0, 0, (unsigned int)copyImage->width, (unsigned int)copyImage->height, False);
+	}
+	else
+	{
+		EGLint width = 0;
+		EGLint height = 0;
+
+		__querySurfaceSize(walkerDpy, walkerSurface, &width, &height);
+
+		// Copied by the X server. If the target is a MIT-SHM pixmap, the application can read the pixels without a transfer.
+		XCopyArea_PTR(display, walkerSurface->drawToPixmap ? walkerSurface->pixmap : walkerSurface->win, target, gc, 0, 0, (unsigned int)width, (unsigned int)height, 0, 0);
+	}
+
+	XFreeGC_PTR(display, gc);
+
+	// The copy has to be finished, before eglCopyBuffers returns.
+	XSync_PTR(display, False);
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __readShmImage(const EGLDisplayImpl* walkerDpy, EGLShmImpl* shm, EGLint* error)
+{
+	if (!walkerDpy || !shm || !error || !shm->nativeShmContainer.image)
+	{
+		return EGL_FALSE;
+	}
+
+	// The X server writes the drawable into the segment. The request is synchronous.
+	if (!XShmGetImage_PTR(walkerDpy->display_id, shm->pixmap, shm->nativeShmContainer.image, 0, 0, AllPlanes))
+	{
+		*error = EGL_BAD_ACCESS;
+
+		return EGL_FALSE;
+	}
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __writeShmImage(const EGLDisplayImpl* walkerDpy, const EGLShmImpl* shm, EGLint* error)
+{
+	if (!walkerDpy || !shm || !error || !shm->nativeShmContainer.image)
+	{
+		return EGL_FALSE;
+	}
+
+	EGLNativeDisplayType display = walkerDpy->display_id;
+
+	GC gc = XCreateGC_PTR(display, shm->pixmap, 0, NULL);
+	if (!gc)
+	{
+		*error = EGL_BAD_ACCESS;
+
+		return EGL_FALSE;
+	}
+
+	XShmPutImage_PTR(display, shm->pixmap, gc, shm->nativeShmContainer.image, 0, 0, 0, 0, (unsigned int)shm->width, (unsigned int)shm->height, False);
+
+	XFreeGC_PTR(display, gc);
+
+	// The segment may be written again after the unlock, so the X server has to be finished with it.
+	XSync_PTR(display, False);
+
+	return EGL_TRUE;
+}
+
+static void __closeStreamMemory(NativeStreamContainer* nativeStreamContainer)
+{
+	if (nativeStreamContainer->mapped)
+	{
+		munmap(nativeStreamContainer->mapped, nativeStreamContainer->memorySize);
+	}
+
+	if (nativeStreamContainer->memory >= 0)
+	{
+		close(nativeStreamContainer->memory);
+	}
+
+	if (nativeStreamContainer->frameReady >= 0)
+	{
+		close(nativeStreamContainer->frameReady);
+	}
+
+	if (nativeStreamContainer->frameFree >= 0)
+	{
+		close(nativeStreamContainer->frameFree);
+	}
+
+	nativeStreamContainer->memory = -1;
+	nativeStreamContainer->memorySize = 0;
+	nativeStreamContainer->mapped = 0;
+	nativeStreamContainer->frameReady = -1;
+	nativeStreamContainer->frameFree = -1;
+}
+
+static void __initStreamContainer(NativeStreamContainer* nativeStreamContainer, int socket)
+{
+	nativeStreamContainer->socket = socket;
+	nativeStreamContainer->memory = -1;
+	nativeStreamContainer->memorySize = 0;
+	nativeStreamContainer->mapped = 0;
+	nativeStreamContainer->frameReady = -1;
+	nativeStreamContainer->frameFree = -1;
+}
+
+static int __pollTimeout(EGLTimeKHR timeout)
+{
+	if (timeout == EGL_FOREVER_KHR)
+	{
+		return -1;
+	}
+
+	// Round up, so a short timeout does not become a busy loop.
+	EGLTimeKHR milliseconds = (timeout + 999999) / 1000000;
+
+	return milliseconds > 0x7FFFFFFF ? 0x7FFFFFFF : (int)milliseconds;
+}
+
+EGLBoolean __createStreamConnection(NativeStreamContainer* nativeStreamContainer, EGLNativeFileDescriptorKHR* fileDescriptor, EGLint* error)
+{
+	if (!nativeStreamContainer || !fileDescriptor || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	int sockets[2];
+
+	// Message boundaries are kept, so every message arrives together with its file descriptors.
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0)
+	{
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	__initStreamContainer(nativeStreamContainer, sockets[0]);
+
+	*fileDescriptor = sockets[1];
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __openStreamConnection(NativeStreamContainer* nativeStreamContainer, EGLNativeFileDescriptorKHR fileDescriptor, EGLint* error)
+{
+	if (!nativeStreamContainer || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	// The application keeps ownership of the passed file descriptor.
+	int socket = fcntl(fileDescriptor, F_DUPFD_CLOEXEC, 0);
+
+	if (socket < 0)
+	{
+		*error = EGL_BAD_PARAMETER;
+
+		return EGL_FALSE;
+	}
+
+	__initStreamContainer(nativeStreamContainer, socket);
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __destroyStreamConnection(NativeStreamContainer* nativeStreamContainer)
+{
+	if (!nativeStreamContainer)
+	{
+		return EGL_FALSE;
+	}
+
+	__closeStreamMemory(nativeStreamContainer);
+
+	if (nativeStreamContainer->socket >= 0)
+	{
+		// The other process sees a hang up and disconnects the stream.
+		close(nativeStreamContainer->socket);
+
+		nativeStreamContainer->socket = -1;
+	}
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __createStreamMemory(NativeStreamContainer* nativeStreamContainer, size_t size, void** memory, EGLint* error)
+{
+	if (!nativeStreamContainer || !memory || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	nativeStreamContainer->memory = memfd_create("egl_stream", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	nativeStreamContainer->frameReady = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	nativeStreamContainer->frameFree = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	// Sealed, before it is sent, so the size can not change under the mapping of the other process.
+	if (nativeStreamContainer->memory < 0 || nativeStreamContainer->frameReady < 0 || nativeStreamContainer->frameFree < 0 || ftruncate(nativeStreamContainer->memory, (off_t)size) != 0 || fcntl(nativeStreamContainer->memory, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+	{
+		__closeStreamMemory(nativeStreamContainer);
+
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, nativeStreamContainer->memory, 0);
+
+	if (mapped == MAP_FAILED)
+	{
+		__closeStreamMemory(nativeStreamContainer);
+
+		*error = EGL_BAD_ALLOC;
+
+		return EGL_FALSE;
+	}
+
+	nativeStreamContainer->memorySize = size;
+	nativeStreamContainer->mapped = mapped;
+
+	*memory = mapped;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __sendStreamMessage(const NativeStreamContainer* nativeStreamContainer, const EGLStreamMessageImpl* message, EGLBoolean attachMemory, EGLint* error)
+{
+	if (!nativeStreamContainer || !message || !error)
+	{
+		return EGL_FALSE;
+	}
+
+	struct iovec iov;
+	iov.iov_base = (void*)message;
+	iov.iov_len = sizeof(EGLStreamMessageImpl);
+
+	union {
+		char buffer[CMSG_SPACE(3 * sizeof(int))];
+		struct cmsghdr align;
+	} control;
+	memset(&control, 0, sizeof(control));
+
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+
+	if (attachMemory)
+	{
+		int fds[3] = { nativeStreamContainer->memory, nativeStreamContainer->frameReady, nativeStreamContainer->frameFree };
+
+		msg.msg_control = control.buffer;
+		msg.msg_controllen = sizeof(control.buffer);
+
+		struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+		memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+	}
+
+	if (sendmsg(nativeStreamContainer->socket, &msg, MSG_NOSIGNAL) != (ssize_t)sizeof(EGLStreamMessageImpl))
+	{
+		*error = EGL_BAD_STREAM_KHR;
+
+		return EGL_FALSE;
+	}
+
+	return EGL_TRUE;
+}
+
+EGLint __receiveStreamMessage(NativeStreamContainer* nativeStreamContainer, EGLStreamMessageImpl* message, void** memory, size_t* size, EGLTimeKHR timeout)
+{
+	if (!nativeStreamContainer || !message || !memory || !size)
+	{
+		return _EGL_STREAM_WAIT_DISCONNECTED;
+	}
+
+	*memory = 0;
+	*size = 0;
+
+	struct pollfd pfd;
+	pfd.fd = nativeStreamContainer->socket;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	int result = poll(&pfd, 1, __pollTimeout(timeout));
+
+	if (result == 0)
+	{
+		return _EGL_STREAM_WAIT_TIMEOUT;
+	}
+
+	if (result < 0 || !(pfd.revents & POLLIN))
+	{
+		return _EGL_STREAM_WAIT_DISCONNECTED;
+	}
+
+	struct iovec iov;
+	iov.iov_base = message;
+	iov.iov_len = sizeof(EGLStreamMessageImpl);
+
+	union {
+		char buffer[CMSG_SPACE(3 * sizeof(int))];
+		struct cmsghdr align;
+	} control;
+
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control.buffer;
+	msg.msg_controllen = sizeof(control.buffer);
+
+	if (recvmsg(nativeStreamContainer->socket, &msg, MSG_CMSG_CLOEXEC) != (ssize_t)sizeof(EGLStreamMessageImpl) || (msg.msg_flags & MSG_CTRUNC))
+	{
+		return _EGL_STREAM_WAIT_DISCONNECTED;
+	}
+
+	struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+
+	if (!cmsg)
+	{
+		return _EGL_STREAM_WAIT_SIGNALED;
+	}
+
+	if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(3 * sizeof(int)))
+	{
+		return _EGL_STREAM_WAIT_DISCONNECTED;
+	}
+
+	int fds[3];
+	memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+
+	__closeStreamMemory(nativeStreamContainer);
+
+	nativeStreamContainer->memory = fds[0];
+	nativeStreamContainer->frameReady = fds[1];
+	nativeStreamContainer->frameFree = fds[2];
+
+	// The size is only trusted, if the other process can not truncate the memory afterwards.
+	const int seals = fcntl(nativeStreamContainer->memory, F_GET_SEALS);
+
+	struct stat st;
+
+	if (seals < 0 || (seals & (F_SEAL_SHRINK | F_SEAL_GROW)) != (F_SEAL_SHRINK | F_SEAL_GROW) || fstat(nativeStreamContainer->memory, &st) != 0 || st.st_size < _EGL_STREAM_SHARED_HEADER_SIZE)
+	{
+		__closeStreamMemory(nativeStreamContainer);
+
+		return _EGL_STREAM_WAIT_DISCONNECTED;
+	}
+
+	void* mapped = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, nativeStreamContainer->memory, 0);
+
+	if (mapped == MAP_FAILED)
+	{
+		__closeStreamMemory(nativeStreamContainer);
+
+		return _EGL_STREAM_WAIT_DISCONNECTED;
+	}
+
+	nativeStreamContainer->memorySize = (size_t)st.st_size;
+	nativeStreamContainer->mapped = mapped;
+
+	*memory = mapped;
+	*size = (size_t)st.st_size;
+
+	return _EGL_STREAM_WAIT_SIGNALED;
+}
+
+EGLBoolean __signalStream(const NativeStreamContainer* nativeStreamContainer, EGLBoolean frameReady)
+{
+	if (!nativeStreamContainer)
+	{
+		return EGL_FALSE;
+	}
+
+	uint64_t value = 1;
+
+	return write(frameReady ? nativeStreamContainer->frameReady : nativeStreamContainer->frameFree, &value, sizeof(value)) == (ssize_t)sizeof(value);
+}
+
+EGLint __waitStream(const NativeStreamContainer* nativeStreamContainer, EGLBoolean frameReady, EGLTimeKHR timeout)
+{
+	if (!nativeStreamContainer)
+	{
+		return _EGL_STREAM_WAIT_DISCONNECTED;
+	}
+
+	struct pollfd pfds[2];
+	pfds[0].fd = frameReady ? nativeStreamContainer->frameReady : nativeStreamContainer->frameFree;
+	pfds[0].events = POLLIN;
+	pfds[0].revents = 0;
+	// Only interested in a hang up of the other process.
+	pfds[1].fd = nativeStreamContainer->socket;
+	pfds[1].events = 0;
+	pfds[1].revents = 0;
+
+	int result = poll(pfds, 2, __pollTimeout(timeout));
+
+	if (result == 0)
+	{
+		return _EGL_STREAM_WAIT_TIMEOUT;
+	}
+
+	if (result < 0 || (pfds[1].revents & (POLLHUP | POLLERR)))
+	{
+		return _EGL_STREAM_WAIT_DISCONNECTED;
+	}
+
+	// Consume the signal. The waiter checks the shared state afterwards anyway.
+	uint64_t value;
+	if (read(pfds[0].fd, &value, sizeof(value)) < 0)
+	{
+		// Already consumed, nothing to do.
+	}
+
+	return _EGL_STREAM_WAIT_SIGNALED;
+}
+
+static int xerrorhandler(Display *dsp, XErrorEvent *error)
+{
+  char errorstring[1024];
+  XGetErrorText_PTR(dsp, error->error_code, errorstring, 1024);
+  int minor = error->minor_code;
+  int err = error->error_code;
+    
+  std::cerr << "X error--" << errorstring << " minor = " << minor << " major = " << err << std::endl;
+  exit(-1);
+}
+EGLBoolean __createContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList)
+{
+	if (!nativeContextContainer || !walkerDpy || !nativeSurfaceContainer)
+	{
+		return EGL_FALSE;
+	}
+	//XSetErrorHandler(xerrorhandler);
+	logglxcall("glXCreateContextAttribsARB");
+	nativeContextContainer->ctx = glXCreateContextAttribsARB_PTR(walkerDpy->display_id, nativeSurfaceContainer->config, sharedNativeContextContainer ? sharedNativeContextContainer->ctx : 0, True, attribList);
+	nativeContextContainer->config = nativeSurfaceContainer->config;
+
+	return nativeContextContainer->ctx != 0;
+}
+
+EGLBoolean __createPooledContext(NativeContextContainer* nativeContextContainer, const EGLDisplayImpl* walkerDpy, const EGLConfigImpl* walkerConfig, EGLint surfaceType, const NativeContextContainer* sharedNativeContextContainer, const EGLint* attribList)
+{
+	if (!nativeContextContainer || !walkerDpy || !walkerConfig)
+	{
+		return EGL_FALSE;
+	}
+
+	// The surfaces of the config are created with the same FBConfig, unless they request sRGB.
+	NativeSurfaceContainer nativeSurfaceContainer;
+	memset(&nativeSurfaceContainer, 0, sizeof(NativeSurfaceContainer));
+
+	switch (surfaceType)
+	{
+		case EGL_WINDOW_BIT:
+			nativeSurfaceContainer.config = walkerConfig->nativeConfigContainer.window;
+			break;
+		case EGL_PIXMAP_BIT:
+			nativeSurfaceContainer.config = walkerConfig->nativeConfigContainer.pixmap;
+			break;
+		case EGL_PBUFFER_BIT:
+			nativeSurfaceContainer.config = walkerConfig->nativeConfigContainer.pbuffer;
+			break;
+	}
+
+	if (!nativeSurfaceContainer.config)
+	{
+		return EGL_FALSE;
+	}
+
+	return __createContext(nativeContextContainer, walkerDpy, &nativeSurfaceContainer, sharedNativeContextContainer, attribList);
+}
+
+EGLBoolean __pooledContextMatches(const NativeContextContainer* nativeContextContainer, const NativeSurfaceContainer* nativeSurfaceContainer)
+{
+	if (!nativeContextContainer || !nativeSurfaceContainer)
+	{
+		return EGL_FALSE;
+	}
+
+	return nativeContextContainer->config == nativeSurfaceContainer->config;
+}
+
+EGLBoolean __makeCurrent(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* nativeSurfaceContainer, const NativeContextContainer* nativeContextContainer)
+{
+	if (!walkerDpy || (!nativeSurfaceContainer && nativeContextContainer) || (nativeSurfaceContainer && !nativeContextContainer))
+	{
+		return EGL_FALSE;
+	}
+
+	if (!nativeContextContainer)
+	{
+		logglxcall("glXMakeCurrent");
+		return (EGLBoolean)glXMakeCurrent_PTR(walkerDpy->display_id, None, NULL);
+	}
+
+	logglxcall("glXMakeCurrent");
+	return (EGLBoolean)glXMakeCurrent_PTR(walkerDpy->display_id, nativeSurfaceContainer->drawable, nativeContextContainer->ctx);
+}
+
+EGLBoolean __makeCurrentRead(const EGLDisplayImpl* walkerDpy, const NativeSurfaceContainer* drawSurfaceContainer, const NativeSurfaceContainer* readSurfaceContainer, const NativeContextContainer* nativeContextContainer)
+{
+	if (!walkerDpy || !drawSurfaceContainer || !readSurfaceContainer || !nativeContextContainer)
+	{
+		return EGL_FALSE;
+	}
+
+	logglxcall("glXMakeContextCurrent");
+	return (EGLBoolean)glXMakeContextCurrent_PTR(walkerDpy->display_id, drawSurfaceContainer->drawable, readSurfaceContainer->drawable, nativeContextContainer->ctx);
+}
+
+EGLBoolean __swapBuffers(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface)
+{
+	if (!walkerDpy || !walkerSurface)
+	{
+		return EGL_FALSE;
+	}
+
+	logglxcall("glXSwapBuffers");
+	glXSwapBuffers_PTR(walkerDpy->display_id, walkerSurface->win);
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __swapBuffersRegion(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, const EGLint* rects, EGLint n_rects)
+{
+	if (!walkerDpy || !walkerSurface || !rects || !(walkerDpy->nativeCaps & _EGL_NATIVE_COPY_SUB_BUFFER))
+	{
+		return EGL_FALSE;
+	}
+
+	// The rectangles are copied from the back into the front buffer. The back buffer keeps its content.
+	for (EGLint i = 0; i < n_rects; i++)
+	{
+		const EGLint* rect = &rects[i * 4];
+
+		logglxcall("glXCopySubBufferMESA");
+		glXCopySubBufferMESA_PTR(walkerDpy->display_id, walkerSurface->win, rect[0], rect[1], rect[2], rect[3]);
+	}
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __swapBuffersCounted(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLuint64KHR* sbc)
+{
+	if (!walkerDpy || !walkerSurface || !sbc || !(walkerDpy->nativeCaps & _EGL_NATIVE_SYNC_CONTROL))
+	{
+		return EGL_FALSE;
+	}
+
+	// Without a target, the swap is done at the next opportunity regarding the swap interval, as with glXSwapBuffers.
+	logglxcall("glXSwapBuffersMscOML");
+	int64_t count = glXSwapBuffersMscOML_PTR(walkerDpy->display_id, walkerSurface->win, 0, 0, 0);
+
+	if (count <= 0)
+	{
+		return EGL_FALSE;
+	}
+
+	*sbc = (EGLuint64KHR)count;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __querySwapCompletion(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLnsecsANDROID* ust, EGLuint64KHR* msc, EGLuint64KHR* sbc)
+{
+	if (!walkerDpy || !walkerSurface || !ust || !msc || !sbc || !(walkerDpy->nativeCaps & _EGL_NATIVE_SYNC_CONTROL))
+	{
+		return EGL_FALSE;
+	}
+
+	int64_t currentUst = 0;
+	int64_t currentMsc = 0;
+	int64_t currentSbc = 0;
+
+	logglxcall("glXGetSyncValuesOML");
+	if (!glXGetSyncValuesOML_PTR(walkerDpy->display_id, walkerSurface->win, &currentUst, &currentMsc, &currentSbc))
+	{
+		return EGL_FALSE;
+	}
+
+	*ust = 0;
+	*msc = 0;
+	*sbc = 0;
+
+	if (currentSbc <= 0)
+	{
+		return EGL_TRUE;
+	}
+
+	// Returns at once, as the swap did already complete. The values are the ones of its completion.
+	logglxcall("glXWaitForSbcOML");
+	if (!glXWaitForSbcOML_PTR(walkerDpy->display_id, walkerSurface->win, currentSbc, &currentUst, &currentMsc, &currentSbc))
+	{
+		return EGL_FALSE;
+	}
+
+	// The UST is in microseconds of the monotonic clock.
+	*ust = (EGLnsecsANDROID)currentUst * 1000;
+	*msc = (EGLuint64KHR)currentMsc;
+	*sbc = (EGLuint64KHR)currentSbc;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __queryRefreshInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLnsecsANDROID* interval)
+{
+	if (!walkerDpy || !walkerSurface || !interval || !(walkerDpy->nativeCaps & _EGL_NATIVE_SYNC_CONTROL))
+	{
+		return EGL_FALSE;
+	}
+
+	int32_t numerator = 0;
+	int32_t denominator = 0;
+
+	logglxcall("glXGetMscRateOML");
+	if (!glXGetMscRateOML_PTR(walkerDpy->display_id, walkerSurface->win, &numerator, &denominator) || numerator <= 0 || denominator <= 0)
+	{
+		return EGL_FALSE;
+	}
+
+	// The rate is numerator / denominator in Hertz.
+	*interval = (EGLnsecsANDROID)1000000000 * denominator / numerator;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __swapInterval(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint interval)
+{
+	if (!walkerDpy || !walkerSurface || !(walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL))
+	{
+		return EGL_FALSE;
+	}
+
+	// A negative interval swaps a late frame immediately, which requires GLX_EXT_swap_control_tear.
+	if (interval < 0 && !(walkerDpy->nativeCaps & _EGL_NATIVE_SWAP_CONTROL_TEAR))
+	{
+		interval = -interval;
+	}
+
+	logglxcall("glXSwapIntervalEXT");
+	glXSwapIntervalEXT_PTR(walkerDpy->display_id, walkerSurface->win, interval);
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __querySurfaceSize(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint* width, EGLint* height)
+{
+	if (!walkerDpy || !walkerSurface || !width || !height)
+	{
+		return EGL_FALSE;
+	}
+
+	unsigned int value;
+
+	logglxcall("glXQueryDrawable");
+	glXQueryDrawable_PTR(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable, GLX_WIDTH, &value);
+	*width = (EGLint)value;
+
+	logglxcall("glXQueryDrawable");
+	glXQueryDrawable_PTR(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable, GLX_HEIGHT, &value);
+	*height = (EGLint)value;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __querySurfaceAge(const EGLDisplayImpl* walkerDpy, const EGLSurfaceImpl* walkerSurface, EGLint* age)
+{
+	if (!walkerDpy || !walkerSurface || !age || !(walkerDpy->nativeCaps & _EGL_NATIVE_BUFFER_AGE))
+	{
+		return EGL_FALSE;
+	}
+
+	unsigned int value = 0;
+
+	// Only defined for the drawable, which is current to the calling thread.
+	logglxcall("glXQueryDrawable");
+	glXQueryDrawable_PTR(walkerDpy->display_id, walkerSurface->nativeSurfaceContainer.drawable, GLX_BACK_BUFFER_AGE_EXT, &value);
+	*age = (EGLint)value;
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __watchWindowSize(EGLDisplayImpl* walkerDpy, EGLNativeWindowType win)
+{
+	if (!walkerDpy || !win)
+	{
+		return EGL_FALSE;
+	}
+
+	NativeDisplayContainer* nativeDisplayContainer = &walkerDpy->nativeDisplayContainer;
+
+	// Events selected on a private connection do not change the event mask of the application.
+	if (!nativeDisplayContainer->events)
+	{
+		nativeDisplayContainer->events = XOpenDisplay_PTR(DisplayString(walkerDpy->display_id));
+
+		if (!nativeDisplayContainer->events)
+		{
+			return EGL_FALSE;
+		}
+	}
+
+	// The window has to exist in the X server, before the private connection refers to it.
+	XSync_PTR(walkerDpy->display_id, False);
+
+	XSelectInput_PTR(nativeDisplayContainer->events, win, StructureNotifyMask);
+
+	// The selection has to be active, before the size is queried. Otherwise a resize in between would be lost.
+	XSync_PTR(nativeDisplayContainer->events, False);
+
+	return EGL_TRUE;
+}
+
+EGLBoolean __pollWindowSize(EGLDisplayImpl* walkerDpy, EGLNativeWindowType* win, EGLint* width, EGLint* height)
+{
+	if (!walkerDpy || !win || !width || !height || !walkerDpy->nativeDisplayContainer.events)
+	{
+		return EGL_FALSE;
+	}
+
+	Display* events = walkerDpy->nativeDisplayContainer.events;
+
+	// Only the events, which did already arrive, are read. There is no round trip to the X server.
+	while (XPending_PTR(events))
+	{
+		XEvent event;
+
+		XNextEvent_PTR(events, &event);
+
+		if (event.type == ConfigureNotify)
+		{
+			*win = event.xconfigure.window;
+			*width = (EGLint)event.xconfigure.width;
+			*height = (EGLint)event.xconfigure.height;
+
+			return EGL_TRUE;
+		}
+	}
+
+	return EGL_FALSE;
+}
+
+EGLBoolean __closeWindowSizeEvents(EGLDisplayImpl* walkerDpy)
+{
+	if (!walkerDpy)
+	{
+		return EGL_FALSE;
+	}
+
+	if (walkerDpy->nativeDisplayContainer.events)
+	{
+		XCloseDisplay_PTR(walkerDpy->nativeDisplayContainer.events);
+		walkerDpy->nativeDisplayContainer.events = 0;
+	}
 
 	return EGL_TRUE;
 }